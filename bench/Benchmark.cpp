@@ -0,0 +1,422 @@
+/**
+ * Benchmark: 无窗口运行 bench/Workloads.cpp 里生成的负载, 测量每条渲染路径的
+ *      CPU 提交时间 / 整帧时间 / GPU 时间 (GL_TIME_ELAPSED) / draw call 数 / 状态切换数,
+ *      结果打印成表格, 也可以写成 JSON / CSV, 方便在 CI 里逐个提交对比。
+ * 用法: Benchmark [--filter 子串] [--counts 1000,10000] [--frames N] [--warmup N] [--size WxH]
+ *                 [--label 文本] [--json 文件] [--csv 文件] [--list]
+ *      --label 原样写进结果 (比如提交号), --counts 覆盖所有负载的默认规模。
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Render.h"
+#include "GLState.h"
+#include "Framebuffer.h"
+#include "HeadlessContext.h"
+
+#include "Workloads.h"
+
+struct BenchOptions
+{
+    std::string Filter;
+    std::vector<unsigned int> Counts; // 为空时用各个负载的默认规模
+    int Frames = 200;
+    int Warmup = 20;
+    int Width = 960, Height = 540;
+    std::string Label;
+    std::string JsonOutput;
+    std::string CsvOutput;
+    bool List = false;
+};
+
+struct BenchResult
+{
+    std::string Name;
+    std::string CountLabel;
+    unsigned int Count = 0;
+    int Frames = 0;
+    double CpuMsMean = 0.0, CpuMsMedian = 0.0, CpuMsP95 = 0.0; // 提交绘制花的 CPU 时间
+    double FrameMs = 0.0;                                        // 包含等待 GPU 的整帧时间 (总时间 / 帧数)
+    double GpuMsMean = 0.0, GpuMsMedian = 0.0;                   // 没有计时器查询时为负数
+    double DrawCalls = 0.0;
+    double StateChanges = 0.0; // GLState 真正发给GL的状态切换
+    double StateSkipped = 0.0; // GLState 缓存命中跳过的
+};
+
+/**
+ * 每帧一个 GL_TIME_ELAPSED 查询 (这里不嵌套), 查询对象循环使用,
+ * 结果晚 QueryCount - 1 帧再读, 读的时候GPU早就画完了, 不会卡住CPU。
+ */
+class GpuTimer
+{
+public:
+    static const unsigned int QueryCount = 4;
+
+private:
+    unsigned int m_Queries[QueryCount];
+    bool m_Pending[QueryCount];
+    unsigned int m_Next;
+    std::vector<double> m_Results; // 毫秒
+
+public:
+    GpuTimer() : m_Pending{}, m_Next(0)
+    {
+        GLCall(glGenQueries(QueryCount, m_Queries));
+    }
+
+    ~GpuTimer()
+    {
+        GLCall(glDeleteQueries(QueryCount, m_Queries));
+    }
+
+    void Begin()
+    {
+        if (m_Pending[m_Next])
+            Resolve(m_Next);
+        GLCall(glBeginQuery(GL_TIME_ELAPSED, m_Queries[m_Next]));
+    }
+
+    void End()
+    {
+        GLCall(glEndQuery(GL_TIME_ELAPSED));
+        m_Pending[m_Next] = true;
+        m_Next = (m_Next + 1) % QueryCount;
+    }
+
+    // 读回所有还没读的结果, 清空并返回全部结果
+    std::vector<double> Collect()
+    {
+        for (unsigned int i = 0; i < QueryCount; i++)
+        {
+            unsigned int index = (m_Next + i) % QueryCount;
+            if (m_Pending[index])
+                Resolve(index);
+        }
+        std::vector<double> results;
+        results.swap(m_Results);
+        return results;
+    }
+
+private:
+    void Resolve(unsigned int index)
+    {
+        GLuint64 elapsed = 0;
+        GLCall(glGetQueryObjectui64v(m_Queries[index], GL_QUERY_RESULT, &elapsed));
+        m_Results.push_back(elapsed / 1.0e6);
+        m_Pending[index] = false;
+    }
+};
+
+static double Mean(const std::vector<double>& values)
+{
+    if (values.empty())
+        return 0.0;
+    double sum = 0.0;
+    for (double value : values)
+        sum += value;
+    return sum / values.size();
+}
+
+// 第 p 百分位 (0-1), 会排序 values
+static double Percentile(std::vector<double>& values, double p)
+{
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t index = std::min(values.size() - 1, (size_t)(p * (values.size() - 1) + 0.5));
+    return values[index];
+}
+
+static void PrintUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+        << "  --filter TEXT       only run workloads whose scene/path contains TEXT\n"
+        << "  --counts A,B,...    override the workload sizes\n"
+        << "  --frames N          measured frames per run (default 200)\n"
+        << "  --warmup N          unmeasured frames before each run (default 20)\n"
+        << "  --size WxH          framebuffer size (default 960x540)\n"
+        << "  --label TEXT        free-form label stored in the results (e.g. commit hash)\n"
+        << "  --json FILE         write results as JSON\n"
+        << "  --csv FILE          write results as CSV\n"
+        << "  --list              list workloads and exit\n";
+}
+
+static bool ParseCommandLine(int argc, char** argv, BenchOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--list")
+            options.List = true;
+        else if (arg == "--filter" && hasValue)
+            options.Filter = argv[++i];
+        else if (arg == "--frames" && hasValue)
+            options.Frames = std::max(std::atoi(argv[++i]), 1);
+        else if (arg == "--warmup" && hasValue)
+            options.Warmup = std::max(std::atoi(argv[++i]), 0);
+        else if (arg == "--label" && hasValue)
+            options.Label = argv[++i];
+        else if (arg == "--json" && hasValue)
+            options.JsonOutput = argv[++i];
+        else if (arg == "--csv" && hasValue)
+            options.CsvOutput = argv[++i];
+        else if (arg == "--counts" && hasValue)
+        {
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ','))
+            {
+                int count = std::atoi(item.c_str());
+                if (count > 0)
+                    options.Counts.push_back((unsigned int)count);
+            }
+        }
+        else if (arg == "--size" && hasValue)
+        {
+            if (std::sscanf(argv[++i], "%dx%d", &options.Width, &options.Height) != 2 || options.Width <= 0 || options.Height <= 0)
+            {
+                std::cerr << "Invalid --size '" << argv[i] << "', expected WxH" << std::endl;
+                return false;
+            }
+        }
+        else
+        {
+            std::cerr << "Unknown or incomplete option '" << arg << "'" << std::endl;
+            PrintUsage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+static BenchResult RunWorkload(const bench::WorkloadDesc& desc, unsigned int count, const BenchOptions& options,
+    Framebuffer& framebuffer, GpuTimer* gpuTimer)
+{
+    bench::WorkloadParams params;
+    params.Count = count;
+    params.Width = options.Width;
+    params.Height = options.Height;
+    std::unique_ptr<bench::Workload> workload = desc.Create(params);
+
+    BenchResult result;
+    result.Name = desc.GetName();
+    result.CountLabel = desc.CountLabel;
+    result.Count = count;
+    result.Frames = options.Frames;
+
+    std::vector<double> cpuTimes;
+    double drawCalls = 0.0, stateChanges = 0.0, stateSkipped = 0.0;
+    std::chrono::steady_clock::time_point measureStart;
+    for (int frame = 0; frame < options.Warmup + options.Frames; frame++)
+    {
+        bool measured = frame >= options.Warmup;
+        if (frame == options.Warmup)
+        {
+            // 预热的结果不要
+            GLCall(glFinish());
+            if (gpuTimer)
+                gpuTimer->Collect();
+            measureStart = std::chrono::steady_clock::now();
+        }
+
+        framebuffer.Bind();
+        GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+        GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+        GLState::ResetStats();
+        if (gpuTimer)
+            gpuTimer->Begin();
+        auto start = std::chrono::steady_clock::now();
+        unsigned int draws = workload->Render();
+        auto end = std::chrono::steady_clock::now();
+        if (gpuTimer)
+            gpuTimer->End();
+        // 没有交换缓冲来推动提交, 手动 flush 一下
+        GLCall(glFlush());
+
+        if (!measured)
+            continue;
+        cpuTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        drawCalls += draws;
+        stateChanges += GLState::GetStats().Issued;
+        stateSkipped += GLState::GetStats().Skipped;
+    }
+    GLCall(glFinish());
+    double total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - measureStart).count();
+
+    result.CpuMsMean = Mean(cpuTimes);
+    result.CpuMsMedian = Percentile(cpuTimes, 0.5);
+    result.CpuMsP95 = Percentile(cpuTimes, 0.95);
+    result.FrameMs = total / options.Frames;
+    result.DrawCalls = drawCalls / options.Frames;
+    result.StateChanges = stateChanges / options.Frames;
+    result.StateSkipped = stateSkipped / options.Frames;
+    result.GpuMsMean = result.GpuMsMedian = -1.0;
+    if (gpuTimer)
+    {
+        std::vector<double> gpuTimes = gpuTimer->Collect();
+        result.GpuMsMean = Mean(gpuTimes);
+        result.GpuMsMedian = Percentile(gpuTimes, 0.5);
+    }
+
+    // 负载之间不要互相影响
+    workload.reset();
+    GLCall(glFinish());
+    GLState::SetBlend(false);
+    return result;
+}
+
+static std::string EscapeJson(const std::string& text)
+{
+    std::string escaped;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+static bool WriteJson(const std::string& path, const std::vector<BenchResult>& results, const BenchOptions& options,
+    const std::string& renderer, const std::string& version, const std::string& timestamp)
+{
+    std::ofstream out(path);
+    if (!out)
+        return false;
+    out << "{\n";
+    out << "  \"label\": \"" << EscapeJson(options.Label) << "\",\n";
+    out << "  \"timestamp\": \"" << timestamp << "\",\n";
+    out << "  \"renderer\": \"" << EscapeJson(renderer) << "\",\n";
+    out << "  \"version\": \"" << EscapeJson(version) << "\",\n";
+    out << "  \"width\": " << options.Width << ",\n";
+    out << "  \"height\": " << options.Height << ",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchResult& r = results[i];
+        char line[512];
+        std::snprintf(line, sizeof(line),
+            "%s\n    {\"name\": \"%s\", \"count_label\": \"%s\", \"count\": %u, \"frames\": %d, "
+            "\"cpu_ms_mean\": %.4f, \"cpu_ms_median\": %.4f, \"cpu_ms_p95\": %.4f, \"frame_ms\": %.4f, "
+            "\"gpu_ms_mean\": %.4f, \"gpu_ms_median\": %.4f, \"draw_calls\": %.1f, \"state_changes\": %.1f, \"state_skipped\": %.1f}",
+            i == 0 ? "" : ",", r.Name.c_str(), r.CountLabel.c_str(), r.Count, r.Frames,
+            r.CpuMsMean, r.CpuMsMedian, r.CpuMsP95, r.FrameMs, r.GpuMsMean, r.GpuMsMedian, r.DrawCalls, r.StateChanges, r.StateSkipped);
+        out << line;
+    }
+    out << "\n  ]\n}\n";
+    return true;
+}
+
+static bool WriteCsv(const std::string& path, const std::vector<BenchResult>& results, const BenchOptions& options)
+{
+    std::ofstream out(path);
+    if (!out)
+        return false;
+    // 标签里可能有逗号, 整个加引号, 里面的引号写两遍
+    std::string label = "\"";
+    for (char c : options.Label)
+        label += c == '"' ? std::string("\"\"") : std::string(1, c);
+    label += "\"";
+
+    out << "label,name,count_label,count,frames,cpu_ms_mean,cpu_ms_median,cpu_ms_p95,frame_ms,gpu_ms_mean,gpu_ms_median,draw_calls,state_changes,state_skipped\n";
+    for (const BenchResult& r : results)
+    {
+        char line[512];
+        std::snprintf(line, sizeof(line), "%s,%s,%u,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.1f,%.1f,%.1f\n",
+            r.Name.c_str(), r.CountLabel.c_str(), r.Count, r.Frames, r.CpuMsMean, r.CpuMsMedian, r.CpuMsP95,
+            r.FrameMs, r.GpuMsMean, r.GpuMsMedian, r.DrawCalls, r.StateChanges, r.StateSkipped);
+        out << label << "," << line;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!ParseCommandLine(argc, argv, options))
+        return -1;
+
+    const std::vector<bench::WorkloadDesc>& workloads = bench::GetWorkloads();
+    if (options.List)
+    {
+        for (const bench::WorkloadDesc& desc : workloads)
+        {
+            std::cout << desc.GetName() << " (" << desc.CountLabel << ":";
+            for (unsigned int count : desc.DefaultCounts)
+                std::cout << " " << count;
+            std::cout << ")" << std::endl;
+        }
+        return 0;
+    }
+
+    HeadlessContext context(3, 3);
+    if (!context.IsCreated())
+        return -1;
+    // 无窗口时 GLEW 初始化 GLX 扩展会失败, GL 函数指针已经加载好了, 可以忽略 (见 main.cpp 的 InitGLEW)
+    GLenum error = glewInit();
+#if defined(GLEW_ERROR_NO_GLX_DISPLAY)
+    if (error == GLEW_ERROR_NO_GLX_DISPLAY)
+        error = GLEW_OK;
+#endif
+    if (error != GLEW_OK)
+    {
+        std::cerr << "Error: Failed to initialize GLEW! (" << glewGetErrorString(error) << ")" << std::endl;
+        return -1;
+    }
+
+    std::string renderer = (const char*)glGetString(GL_RENDERER);
+    std::string version = (const char*)glGetString(GL_VERSION);
+    char timestamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    std::cout << "Renderer: " << renderer << " (" << version << ")" << std::endl;
+
+    std::unique_ptr<Framebuffer> framebuffer = std::make_unique<Framebuffer>(options.Width, options.Height);
+    std::unique_ptr<GpuTimer> gpuTimer;
+    if (GLEW_VERSION_3_3 || GLEW_ARB_timer_query)
+        gpuTimer = std::make_unique<GpuTimer>();
+
+    std::vector<BenchResult> results;
+    std::printf("%-24s %8s %10s %10s %10s %10s %10s %10s\n", "workload", "count", "cpu ms", "cpu p95", "frame ms", "gpu ms", "draws", "states");
+    for (const bench::WorkloadDesc& desc : workloads)
+    {
+        if (!options.Filter.empty() && desc.GetName().find(options.Filter) == std::string::npos)
+            continue;
+        const std::vector<unsigned int>& counts = options.Counts.empty() ? desc.DefaultCounts : options.Counts;
+        for (unsigned int count : counts)
+        {
+            BenchResult result = RunWorkload(desc, count, options, *framebuffer, gpuTimer.get());
+            std::printf("%-24s %8u %10.3f %10.3f %10.3f %10.3f %10.1f %10.1f\n", result.Name.c_str(), result.Count,
+                result.CpuMsMean, result.CpuMsP95, result.FrameMs, result.GpuMsMean, result.DrawCalls, result.StateChanges);
+            std::fflush(stdout);
+            results.push_back(result);
+        }
+    }
+
+    int status = 0;
+    if (!options.JsonOutput.empty() && !WriteJson(options.JsonOutput, results, options, renderer, version, timestamp))
+    {
+        std::cerr << "Failed to write " << options.JsonOutput << std::endl;
+        status = -1;
+    }
+    if (!options.CsvOutput.empty() && !WriteCsv(options.CsvOutput, results, options))
+    {
+        std::cerr << "Failed to write " << options.CsvOutput << std::endl;
+        status = -1;
+    }
+
+    gpuTimer.reset();
+    framebuffer.reset();
+    return status;
+}
@@ -0,0 +1,565 @@
+#include "Workloads.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "Render.h"
+#include "GLState.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "DynamicVertexBuffer.h"
+#include "Texture.h"
+#include "UniformBuffer.h"
+#include "BatchRenderer2D.h"
+#include "RenderQueue.h"
+#include "SpatialGrid.h"
+#include "SpriteBatch.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace fs = std::filesystem;
+
+namespace bench
+{
+    // ---------------- 场景生成 ----------------
+
+    struct Sprite
+    {
+        glm::vec2 Position;
+        glm::vec2 Size;
+        glm::vec4 Color;
+        unsigned int TextureIndex;
+        unsigned int ShaderIndex;
+        bool Translucent;
+        float Depth;
+    };
+
+    static std::vector<Sprite> GenerateSprites(const WorkloadParams& params, unsigned int count,
+        unsigned int textureCount, unsigned int shaderCount, float translucentRatio)
+    {
+        std::mt19937 random(params.Seed);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<Sprite> sprites(count);
+        for (Sprite& sprite : sprites)
+        {
+            sprite.Size = glm::vec2(8.0f + unit(random) * 24.0f, 8.0f + unit(random) * 24.0f);
+            sprite.Position = glm::vec2(unit(random) * (params.Width - sprite.Size.x), unit(random) * (params.Height - sprite.Size.y));
+            sprite.Color = glm::vec4(unit(random), unit(random), unit(random), 1.0f);
+            sprite.TextureIndex = textureCount ? random() % textureCount : 0;
+            sprite.ShaderIndex = shaderCount ? random() % shaderCount : 0;
+            sprite.Translucent = unit(random) < translucentRatio;
+            if (sprite.Translucent)
+                sprite.Color.w = 0.5f;
+            sprite.Depth = unit(random);
+        }
+        return sprites;
+    }
+
+    // 每张纹理是不同颜色的 32x32 棋盘格, 保证驱动不会把它们当成同一张
+    static std::vector<std::unique_ptr<Texture>> GenerateTextures(unsigned int count)
+    {
+        const int size = 32;
+        std::vector<std::unique_ptr<Texture>> textures;
+        std::vector<unsigned char> pixels(size * size * 4);
+        for (unsigned int i = 0; i < count; i++)
+        {
+            unsigned char r = (unsigned char)(i * 67), g = (unsigned char)(i * 131), b = (unsigned char)(255 - i * 29);
+            for (int y = 0; y < size; y++)
+            {
+                for (int x = 0; x < size; x++)
+                {
+                    unsigned char* pixel = &pixels[(y * size + x) * 4];
+                    bool dark = ((x / 8) + (y / 8)) % 2 == 0;
+                    pixel[0] = dark ? r / 2 : r;
+                    pixel[1] = dark ? g / 2 : g;
+                    pixel[2] = dark ? b / 2 : b;
+                    pixel[3] = 255;
+                }
+            }
+            textures.push_back(std::make_unique<Texture>(size, size));
+            textures.back()->SetData(pixels.data(), (unsigned int)pixels.size());
+        }
+        return textures;
+    }
+
+    // 和 res/Basic.shader 接口相同、片段颜色不同的着色器, 写到临时目录再加载 (Shader 只能从文件创建)
+    static std::vector<std::unique_ptr<Shader>> GenerateShaders(unsigned int count)
+    {
+        fs::path directory = fs::temp_directory_path() / "opengl-bench";
+        fs::create_directories(directory);
+
+        std::vector<std::unique_ptr<Shader>> shaders;
+        for (unsigned int i = 0; i < count; i++)
+        {
+            fs::path path = directory / ("Variant" + std::to_string(i) + ".shader");
+            {
+                char tint[64];
+                std::snprintf(tint, sizeof(tint), "vec4(%.3f, %.3f, %.3f, 1.0)",
+                    0.5f + 0.5f * (i % 3) / 2.0f, 0.5f + 0.5f * (i % 5) / 4.0f, 0.5f + 0.5f * (i % 7) / 6.0f);
+                std::ofstream file(path);
+                file << "#shader vertex\n"
+                    "#version 330 core\n"
+                    "layout(location = 0) in vec4 position;\n"
+                    "layout(location = 1) in vec2 texCoord;\n"
+                    "out vec2 v_TexCoord;\n"
+                    "layout(std140) uniform Camera\n{\n    mat4 u_ViewProjection;\n};\n"
+                    "uniform mat4 u_Model;\n"
+                    "void main()\n{\n"
+                    "    gl_Position = u_ViewProjection * u_Model * position;\n"
+                    "    v_TexCoord = texCoord;\n"
+                    "}\n"
+                    "#shader fragment\n"
+                    "#version 330 core\n"
+                    "layout(location = 0) out vec4 color;\n"
+                    "in vec2 v_TexCoord;\n"
+                    "uniform sampler2D u_Texture;\n"
+                    "void main()\n{\n"
+                    "    color = texture(u_Texture, v_TexCoord) * " << tint << ";\n"
+                    "}\n";
+            }
+            shaders.push_back(std::make_unique<Shader>(path.string()));
+            Shader& shader = *shaders.back();
+            shader.Bind();
+            shader.SetUniform1i("u_Texture", 0);
+            shader.BindUniformBlock("Camera", UniformBuffer::CameraBinding);
+        }
+        return shaders;
+    }
+
+    static glm::mat4 MakeProjection(const WorkloadParams& params)
+    {
+        return glm::ortho(0.0f, (float)params.Width, 0.0f, (float)params.Height, -1.0f, 1.0f);
+    }
+
+    static glm::mat4 MakeModel(const Sprite& sprite)
+    {
+        // 正交投影的近/远平面是 z = 1 / -1, 深度 0 对应最近
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(sprite.Position, 0.99f - 1.98f * sprite.Depth));
+        return glm::scale(model, glm::vec3(sprite.Size, 1.0f));
+    }
+
+    // 单位 quad (0,0)-(1,1), 顶点格式和 res/Basic.shader 对应
+    class QuadMesh
+    {
+    private:
+        std::unique_ptr<VertexArray> m_VAO;
+        std::unique_ptr<VertexBuffer> m_VertexBuffer;
+        std::unique_ptr<IndexBuffer> m_IndexBuffer;
+
+    public:
+        QuadMesh()
+        {
+            float vertices[] = {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                1.0f, 0.0f, 1.0f, 0.0f,
+                1.0f, 1.0f, 1.0f, 1.0f,
+                0.0f, 1.0f, 0.0f, 1.0f
+            };
+            unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+            m_VAO = std::make_unique<VertexArray>();
+            m_VertexBuffer = std::make_unique<VertexBuffer>(vertices, (unsigned int)sizeof(vertices));
+            VertexBufferLayout layout;
+            layout.Push<float>(2);
+            layout.Push<float>(2);
+            m_VAO->AddBuffer(*m_VertexBuffer, layout);
+            m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+        }
+
+        inline const VertexArray& GetVertexArray() const { return *m_VAO; }
+        inline const IndexBuffer& GetIndexBuffer() const { return *m_IndexBuffer; }
+    };
+
+    // ---------------- 渲染路径 ----------------
+
+    // 每个 sprite 一次 Renderer::Draw, 按生成顺序, 不做任何排序和合批
+    class NaiveWorkload : public Workload
+    {
+    private:
+        QuadMesh m_Quad;
+        std::vector<std::unique_ptr<Texture>> m_Textures;
+        std::vector<std::unique_ptr<Shader>> m_Shaders;
+        std::vector<UniformHandle> m_ModelUniforms;
+        std::unique_ptr<UniformBuffer> m_CameraBuffer;
+        std::vector<Sprite> m_Sprites;
+        glm::mat4 m_Proj;
+
+    public:
+        NaiveWorkload(const WorkloadParams& params, unsigned int spriteCount, unsigned int textureCount, unsigned int shaderCount, float translucentRatio)
+            : m_Proj(MakeProjection(params))
+        {
+            m_Textures = GenerateTextures(textureCount);
+            m_Shaders = GenerateShaders(shaderCount);
+            for (const auto& shader : m_Shaders)
+                m_ModelUniforms.push_back(shader->GetUniformHandle("u_Model"));
+            m_CameraBuffer = std::make_unique<UniformBuffer>((unsigned int)sizeof(CameraUniforms), UniformBuffer::CameraBinding);
+            m_Sprites = GenerateSprites(params, spriteCount, textureCount, shaderCount, translucentRatio);
+        }
+
+        unsigned int Render() override
+        {
+            CameraUniforms camera = { m_Proj };
+            m_CameraBuffer->SetData(&camera, sizeof(CameraUniforms));
+            m_CameraBuffer->Bind();
+            GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+            Renderer renderer;
+            for (const Sprite& sprite : m_Sprites)
+            {
+                Shader& shader = *m_Shaders[sprite.ShaderIndex];
+                shader.Bind();
+                shader.SetUniformMat4f(m_ModelUniforms[sprite.ShaderIndex], MakeModel(sprite));
+                m_Textures[sprite.TextureIndex]->Bind(0);
+                GLState::SetBlend(sprite.Translucent);
+                renderer.Draw(m_Quad.GetVertexArray(), m_Quad.GetIndexBuffer(), shader);
+            }
+            return (unsigned int)m_Sprites.size();
+        }
+    };
+
+    // 同样的 sprite 交给 RenderQueue, 可以选择排不排序
+    class QueueWorkload : public Workload
+    {
+    private:
+        QuadMesh m_Quad;
+        std::vector<std::unique_ptr<Texture>> m_Textures;
+        std::vector<std::unique_ptr<Shader>> m_Shaders;
+        std::unique_ptr<UniformBuffer> m_CameraBuffer;
+        std::vector<RenderItem> m_Items;
+        RenderQueue m_Queue;
+        glm::mat4 m_Proj;
+
+    public:
+        QueueWorkload(const WorkloadParams& params, unsigned int spriteCount, unsigned int textureCount, unsigned int shaderCount,
+            float translucentRatio, bool sort)
+            : m_Proj(MakeProjection(params))
+        {
+            m_Textures = GenerateTextures(textureCount);
+            m_Shaders = GenerateShaders(shaderCount);
+            m_CameraBuffer = std::make_unique<UniformBuffer>((unsigned int)sizeof(CameraUniforms), UniformBuffer::CameraBinding);
+            m_Queue.SetSortEnabled(sort);
+
+            for (const Sprite& sprite : GenerateSprites(params, spriteCount, textureCount, shaderCount, translucentRatio))
+            {
+                RenderItem item;
+                item.VAO = &m_Quad.GetVertexArray();
+                item.IB = &m_Quad.GetIndexBuffer();
+                item.ShaderProgram = m_Shaders[sprite.ShaderIndex].get();
+                item.Tex = m_Textures[sprite.TextureIndex].get();
+                item.Model = MakeModel(sprite);
+                item.Translucent = sprite.Translucent;
+                item.Depth = sprite.Depth;
+                m_Items.push_back(item);
+            }
+        }
+
+        unsigned int Render() override
+        {
+            CameraUniforms camera = { m_Proj };
+            m_CameraBuffer->SetData(&camera, sizeof(CameraUniforms));
+            m_CameraBuffer->Bind();
+
+            for (const RenderItem& item : m_Items)
+                m_Queue.Submit(item);
+            Renderer renderer;
+            m_Queue.Flush(renderer);
+            return m_Queue.GetStats().Submitted;
+        }
+    };
+
+    // 每帧把所有 sprite 重新写进 BatchRenderer2D
+    class BatchWorkload : public Workload
+    {
+    private:
+        std::unique_ptr<BatchRenderer2D> m_Renderer;
+        std::vector<std::unique_ptr<Texture>> m_Textures;
+        std::vector<Sprite> m_Sprites;
+        glm::mat4 m_Proj;
+
+    public:
+        BatchWorkload(const WorkloadParams& params, unsigned int spriteCount, unsigned int textureCount)
+            : m_Proj(MakeProjection(params))
+        {
+            m_Renderer = std::make_unique<BatchRenderer2D>();
+            m_Textures = GenerateTextures(textureCount);
+            m_Sprites = GenerateSprites(params, spriteCount, textureCount, 1, 0.0f);
+        }
+
+        unsigned int Render() override
+        {
+            GLState::SetBlend(true);
+            GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+            m_Renderer->ResetStats();
+            m_Renderer->BeginScene(m_Proj);
+            for (const Sprite& sprite : m_Sprites)
+            {
+                if (m_Textures.empty())
+                    m_Renderer->DrawQuad(sprite.Position, sprite.Size, sprite.Color);
+                else
+                    m_Renderer->DrawQuad(sprite.Position, sprite.Size, *m_Textures[sprite.TextureIndex], sprite.Color);
+            }
+            m_Renderer->EndScene();
+            return m_Renderer->GetStats().DrawCalls;
+        }
+    };
+
+    // 世界是视口的 8x8 倍, 只有大约 1/64 的 sprite 在屏幕上; cull 为 false 时全部交给批渲染, 否则先用 SpatialGrid 剔除
+    class WorldWorkload : public Workload
+    {
+    private:
+        std::unique_ptr<BatchRenderer2D> m_Renderer;
+        std::vector<Sprite> m_Sprites;
+        SpatialGrid m_Grid;
+        std::vector<unsigned int> m_Visible;
+        glm::mat4 m_Proj;
+        bool m_Cull;
+
+    public:
+        WorldWorkload(const WorkloadParams& params, unsigned int spriteCount, bool cull)
+            : m_Grid(256.0f), m_Proj(MakeProjection(params)), m_Cull(cull)
+        {
+            m_Renderer = std::make_unique<BatchRenderer2D>();
+            WorkloadParams world = params;
+            world.Width *= 8;
+            world.Height *= 8;
+            m_Sprites = GenerateSprites(world, spriteCount, 0, 1, 0.0f);
+            // 相机在世界中间
+            m_Proj = glm::translate(m_Proj, glm::vec3(-params.Width * 3.5f, -params.Height * 3.5f, 0.0f));
+            for (unsigned int i = 0; i < (unsigned int)m_Sprites.size(); i++)
+                m_Grid.Insert(AABB::FromQuad(m_Sprites[i].Position, m_Sprites[i].Size), i);
+        }
+
+        unsigned int Render() override
+        {
+            GLState::SetBlend(true);
+            GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+            m_Renderer->ResetStats();
+            m_Renderer->BeginScene(m_Proj);
+            if (m_Cull)
+            {
+                m_Visible.clear();
+                m_Grid.Query(Frustum(m_Proj), m_Visible);
+                for (unsigned int index : m_Visible)
+                    m_Renderer->DrawQuad(m_Sprites[index].Position, m_Sprites[index].Size, m_Sprites[index].Color);
+            }
+            else
+            {
+                for (const Sprite& sprite : m_Sprites)
+                    m_Renderer->DrawQuad(sprite.Position, sprite.Size, sprite.Color);
+            }
+            m_Renderer->EndScene();
+            return m_Renderer->GetStats().DrawCalls;
+        }
+    };
+
+    // 绕中心旋转的 sprite: useKernels 为 false 时逐个 DrawQuad(矩阵), 否则 SoA + 指定的 SpriteKernels 内核
+    class RotatedWorkload : public Workload
+    {
+    private:
+        std::unique_ptr<BatchRenderer2D> m_Renderer;
+        SpriteBatch m_Sprites;
+        glm::mat4 m_Proj;
+        bool m_UseKernels;
+
+    public:
+        RotatedWorkload(const WorkloadParams& params, unsigned int spriteCount, bool useKernels, SpriteKernels::Kernel kernel)
+            : m_Proj(MakeProjection(params)), m_UseKernels(useKernels)
+        {
+            m_Renderer = std::make_unique<BatchRenderer2D>();
+            if (useKernels && !SpriteKernels::IsSupported(kernel))
+                std::cout << "Note: " << SpriteKernels::GetName(kernel) << " kernel not supported on this CPU, falling back" << std::endl;
+            SpriteKernels::SetKernel(kernel);
+
+            std::mt19937 random(params.Seed);
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+            for (const Sprite& sprite : GenerateSprites(params, spriteCount, 0, 1, 0.0f))
+            {
+                SpriteDesc desc;
+                desc.Position = glm::vec3(sprite.Position + sprite.Size * 0.5f, 0.0f);
+                desc.Size = sprite.Size;
+                desc.Rotation = unit(random) * 6.2831853f;
+                desc.Color = sprite.Color;
+                m_Sprites.Add(desc);
+            }
+        }
+
+        ~RotatedWorkload()
+        {
+            SpriteKernels::SetKernel(SpriteKernels::GetBestKernel());
+        }
+
+        unsigned int Render() override
+        {
+            GLState::SetBlend(true);
+            GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+            m_Renderer->ResetStats();
+            m_Renderer->BeginScene(m_Proj);
+            if (m_UseKernels)
+            {
+                m_Renderer->DrawSprites(m_Sprites);
+            }
+            else
+            {
+                for (size_t i = 0; i < m_Sprites.Size(); i++)
+                {
+                    glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(m_Sprites.X[i], m_Sprites.Y[i], 0.0f));
+                    transform = glm::rotate(transform, m_Sprites.Rotation[i], glm::vec3(0.0f, 0.0f, 1.0f));
+                    transform = glm::scale(transform, glm::vec3(m_Sprites.Width[i], m_Sprites.Height[i], 1.0f));
+                    transform = glm::translate(transform, glm::vec3(-0.5f, -0.5f, 0.0f));
+                    m_Renderer->DrawQuad(transform, glm::vec4(m_Sprites.R[i], m_Sprites.G[i], m_Sprites.B[i], m_Sprites.A[i]));
+                }
+            }
+            m_Renderer->EndScene();
+            return m_Renderer->GetStats().DrawCalls;
+        }
+    };
+
+    // 一张纹理, 所有 sprite 一次 DrawInstanced, 逐实例的矩阵和颜色每帧重新上传
+    class InstancedWorkload : public Workload
+    {
+    private:
+        struct InstanceData
+        {
+            glm::mat4 Model;
+            Unorm8x4 Color;
+
+            static constexpr auto GetLayout()
+            {
+                return std::array{ VERTEX_ATTRIBUTE(InstanceData, Model), VERTEX_ATTRIBUTE(InstanceData, Color) };
+            }
+        };
+
+        std::unique_ptr<VertexArray> m_VAO;
+        std::unique_ptr<VertexBuffer> m_VertexBuffer;
+        std::unique_ptr<DynamicVertexBuffer> m_InstanceBuffer;
+        std::unique_ptr<IndexBuffer> m_IndexBuffer;
+        std::unique_ptr<Shader> m_Shader;
+        std::unique_ptr<UniformBuffer> m_CameraBuffer;
+        std::vector<std::unique_ptr<Texture>> m_Textures;
+        std::vector<Sprite> m_Sprites;
+        std::vector<InstanceData> m_Instances;
+        glm::mat4 m_Proj;
+
+    public:
+        InstancedWorkload(const WorkloadParams& params, unsigned int spriteCount)
+            : m_Proj(MakeProjection(params))
+        {
+            float vertices[] = {
+                0.0f, 0.0f, 0.0f, 0.0f,
+                1.0f, 0.0f, 1.0f, 0.0f,
+                1.0f, 1.0f, 1.0f, 1.0f,
+                0.0f, 1.0f, 0.0f, 1.0f
+            };
+            unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+            m_VAO = std::make_unique<VertexArray>();
+            m_VertexBuffer = std::make_unique<VertexBuffer>(vertices, (unsigned int)sizeof(vertices));
+            VertexBufferLayout layout;
+            layout.Push<float>(2); // a_Position
+            layout.Push<float>(2); // a_TexCoord
+            m_VAO->AddBuffer(*m_VertexBuffer, layout);
+
+            unsigned int capacity = std::max(spriteCount, 1u) * (unsigned int)sizeof(InstanceData);
+            StreamBuffer::Mode mode = Renderer::IsBaseInstanceSupported() ? StreamBuffer::Mode::Persistent : StreamBuffer::Mode::Orphan;
+            m_InstanceBuffer = std::make_unique<DynamicVertexBuffer>(capacity, mode);
+            m_VAO->AddBuffer<InstanceData>(*m_InstanceBuffer, 1);
+            m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+
+            m_Shader = std::make_unique<Shader>("res/shaders/Instanced.shader");
+            m_Shader->Bind();
+            m_Shader->SetUniform1i("u_Texture", 0);
+            m_Shader->BindUniformBlock("Camera", UniformBuffer::CameraBinding);
+            m_CameraBuffer = std::make_unique<UniformBuffer>((unsigned int)sizeof(CameraUniforms), UniformBuffer::CameraBinding);
+
+            m_Textures = GenerateTextures(1);
+            m_Sprites = GenerateSprites(params, spriteCount, 1, 1, 0.0f);
+            m_Instances.resize(m_Sprites.size());
+        }
+
+        unsigned int Render() override
+        {
+            if (m_Sprites.empty())
+                return 0;
+
+            GLState::SetBlend(true);
+            GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            for (size_t i = 0; i < m_Sprites.size(); i++)
+            {
+                m_Instances[i].Model = MakeModel(m_Sprites[i]);
+                m_Instances[i].Color = Unorm8x4::Pack(m_Sprites[i].Color);
+            }
+
+            CameraUniforms camera = { m_Proj };
+            m_CameraBuffer->SetData(&camera, sizeof(CameraUniforms));
+            m_CameraBuffer->Bind();
+
+            unsigned int offset = m_InstanceBuffer->SetData(m_Instances.data(), (unsigned int)(m_Instances.size() * sizeof(InstanceData)));
+            unsigned int baseInstance = offset / (unsigned int)sizeof(InstanceData);
+
+            m_Textures[0]->Bind(0);
+            Renderer renderer;
+            renderer.DrawInstanced(*m_VAO, *m_IndexBuffer, *m_Shader, (unsigned int)m_Instances.size(), baseInstance);
+            return 1;
+        }
+    };
+
+    // ---------------- 注册 ----------------
+
+    const std::vector<WorkloadDesc>& GetWorkloads()
+    {
+        // mixed 场景: 8 个着色器 x 32 张纹理, 20% 半透明, 模拟真实场景里状态混杂的情况
+        static const std::vector<WorkloadDesc> workloads = {
+            { "sprites", "naive", "sprites", { 1000, 10000 },
+                [](const WorkloadParams& p) { return std::make_unique<NaiveWorkload>(p, p.Count, 1, 1, 0.0f); } },
+            { "sprites", "queue", "sprites", { 1000, 10000 },
+                [](const WorkloadParams& p) { return std::make_unique<QueueWorkload>(p, p.Count, 1, 1, 0.0f, true); } },
+            { "sprites", "batch", "sprites", { 1000, 10000, 50000 },
+                [](const WorkloadParams& p) { return std::make_unique<BatchWorkload>(p, p.Count, 1); } },
+            { "sprites", "instanced", "sprites", { 1000, 10000, 50000 },
+                [](const WorkloadParams& p) { return std::make_unique<InstancedWorkload>(p, p.Count); } },
+
+            // 10000 个 sprite 分散在 Count 张纹理上
+            { "textures", "batch", "textures", { 1, 16, 64, 256 },
+                [](const WorkloadParams& p) { return std::make_unique<BatchWorkload>(p, 10000, p.Count); } },
+            { "textures", "queue", "textures", { 1, 16, 64, 256 },
+                [](const WorkloadParams& p) { return std::make_unique<QueueWorkload>(p, 2000, p.Count, 1, 0.0f, true); } },
+
+            // 2000 个 sprite 分散在 Count 个着色器上
+            { "shaders", "naive", "shaders", { 1, 4, 16, 64 },
+                [](const WorkloadParams& p) { return std::make_unique<NaiveWorkload>(p, 2000, 1, p.Count, 0.0f); } },
+            { "shaders", "queue", "shaders", { 1, 4, 16, 64 },
+                [](const WorkloadParams& p) { return std::make_unique<QueueWorkload>(p, 2000, 1, p.Count, 0.0f, true); } },
+
+            { "mixed", "naive", "sprites", { 2000, 10000 },
+                [](const WorkloadParams& p) { return std::make_unique<NaiveWorkload>(p, p.Count, 32, 8, 0.2f); } },
+            { "mixed", "queue-unsorted", "sprites", { 2000, 10000 },
+                [](const WorkloadParams& p) { return std::make_unique<QueueWorkload>(p, p.Count, 32, 8, 0.2f, false); } },
+            { "mixed", "queue", "sprites", { 2000, 10000 },
+                [](const WorkloadParams& p) { return std::make_unique<QueueWorkload>(p, p.Count, 32, 8, 0.2f, true); } },
+
+            // Count 个 sprite 撒在比视口大得多的世界里
+            { "world", "batch", "sprites", { 10000, 100000, 500000 },
+                [](const WorkloadParams& p) { return std::make_unique<WorldWorkload>(p, p.Count, false); } },
+            { "world", "culled", "sprites", { 10000, 100000, 500000 },
+                [](const WorkloadParams& p) { return std::make_unique<WorldWorkload>(p, p.Count, true); } },
+
+            // 顶点生成: 逐个矩阵变换 vs SoA 的各个 SIMD 内核
+            { "rotated", "transform", "sprites", { 10000, 100000 },
+                [](const WorkloadParams& p) { return std::make_unique<RotatedWorkload>(p, p.Count, false, SpriteKernels::Kernel::Scalar); } },
+            { "rotated", "scalar", "sprites", { 10000, 100000 },
+                [](const WorkloadParams& p) { return std::make_unique<RotatedWorkload>(p, p.Count, true, SpriteKernels::Kernel::Scalar); } },
+            { "rotated", "sse2", "sprites", { 10000, 100000 },
+                [](const WorkloadParams& p) { return std::make_unique<RotatedWorkload>(p, p.Count, true, SpriteKernels::Kernel::SSE2); } },
+            { "rotated", "avx2", "sprites", { 10000, 100000 },
+                [](const WorkloadParams& p) { return std::make_unique<RotatedWorkload>(p, p.Count, true, SpriteKernels::Kernel::AVX2); } },
+        };
+        return workloads;
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+	// 生成负载用的参数
+	struct WorkloadParams
+	{
+		unsigned int Count = 0; // 负载的规模, 含义见各个 WorkloadDesc::CountLabel
+		int Width = 960, Height = 540;
+		unsigned int Seed = 1234; // 固定种子, 同一个提交每次跑的场景完全一样
+	};
+
+	/**
+	 * 一个基准负载: 构造时生成场景和所有GL资源, 之后每帧调用一次 Render。
+	 * 调用 Render 前帧缓冲已经绑定并清空, Render 只负责提交绘制。
+	 */
+	class Workload
+	{
+	public:
+		virtual ~Workload() {}
+		// 画一帧, 返回这一帧发出的 draw call 数
+		virtual unsigned int Render() = 0;
+	};
+
+	struct WorkloadDesc
+	{
+		std::string Scene;      // 场景: sprites / textures / shaders / mixed
+		std::string Path;       // 渲染路径: naive / queue / batch / instanced ...
+		std::string CountLabel; // Count 的含义, 比如 "sprites"
+		std::vector<unsigned int> DefaultCounts;
+		std::function<std::unique_ptr<Workload>(const WorkloadParams&)> Create;
+
+		inline std::string GetName() const { return Scene + "/" + Path; }
+	};
+
+	// 所有注册的负载, 按场景分组排列
+	const std::vector<WorkloadDesc>& GetWorkloads();
+}
@@ -1,21 +1,287 @@
 #include <iostream>
+#include <algorithm>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <memory>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 
 #include "vendor/imgui/imgui.h"
 #include "vendor/imgui/imgui_impl_glfw.h"
 #include "vendor/imgui/imgui_impl_opengl3.h"
 
+#include "src/Render.h"
+#include "src/GLState.h"
+#include "src/TextureLoader.h"
+#include "src/ShaderHotReload.h"
+#include "src/ResourceManager.h"
+#include "src/FrameLoop.h"
+#include "src/Profiler.h"
+#include "src/Framebuffer.h"
+#include "src/FramebufferReadback.h"
+#include "src/HeadlessContext.h"
+#include "src/AssetPack.h"
 #include "src/tests/Test.h"
 #include "src/tests/TestClearColor.h"
 #include "src/tests/TestTexture2D.h"
+#include "src/tests/TestBatchRender.h"
+#include "src/tests/TestAsyncTexture.h"
+#include "src/tests/TestTextureAtlas.h"
+#include "src/tests/TestInstancing.h"
+#include "src/tests/TestMultiDrawIndirect.h"
+#include "src/tests/TestRenderQueue.h"
+#include "src/tests/TestParallelRecord.h"
+#include "src/tests/TestFramebuffer.h"
+#include "src/tests/TestCulling.h"
+#include "src/tests/TestSpriteKernels.h"
+#include "src/tests/TestResourceManager.h"
 
+// 命令行参数
+struct CommandLineOptions
+{
+    bool Headless = false;    // 不开窗口, 用 EGL 上下文画到 Framebuffer 里
+    std::string TestName;     // 直接打开这个 Test (名字和菜单上的一样)
+    int Frames = 0;           // 跑这么多帧后退出, 0 表示一直跑 (无窗口模式默认 100)
+    int Width = 960, Height = 540;
+    std::string ProfileOutput; // 退出前把性能分析结果导出成 Chrome trace
+    bool ListTests = false;
+    // 无窗口模式下的截图和参考图对比
+    std::string CaptureOutput; // 最后一帧存成 PPM
+    std::string GoldenImage;   // 最后一帧和这张 PPM 比较, 不一致时返回非0
+    int Tolerance = 2;         // 每个通道允许的差值
+    double MaxDiff = 0.001;    // 允许超出 Tolerance 的像素比例
+};
 
-int main() {
+static void PrintUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+        << "  --headless          render offscreen through EGL, no window (requires --test)\n"
+        << "  --test NAME         open the test named NAME directly\n"
+        << "  --frames N          exit after N frames (headless default: 100)\n"
+        << "  --size WxH          framebuffer size (default 960x540)\n"
+        << "  --profile FILE      write a Chrome trace of the run to FILE\n"
+        << "  --list-tests        print the registered test names and exit\n"
+        << "  --capture FILE      headless: save the last frame as a PPM image\n"
+        << "  --golden FILE       headless: compare the last frame against a PPM image, exit non-zero on mismatch\n"
+        << "  --tolerance N       per-channel difference ignored by --golden (default 2)\n"
+        << "  --max-diff F        fraction of pixels allowed to differ for --golden (default 0.001)\n";
+}
+
+static bool ParseCommandLine(int argc, char** argv, CommandLineOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--headless")
+            options.Headless = true;
+        else if (arg == "--list-tests")
+            options.ListTests = true;
+        else if (arg == "--test" && hasValue)
+            options.TestName = argv[++i];
+        else if (arg == "--frames" && hasValue)
+            options.Frames = std::max(std::atoi(argv[++i]), 0);
+        else if (arg == "--profile" && hasValue)
+            options.ProfileOutput = argv[++i];
+        else if (arg == "--capture" && hasValue)
+            options.CaptureOutput = argv[++i];
+        else if (arg == "--golden" && hasValue)
+            options.GoldenImage = argv[++i];
+        else if (arg == "--tolerance" && hasValue)
+            options.Tolerance = std::max(std::atoi(argv[++i]), 0);
+        else if (arg == "--max-diff" && hasValue)
+            options.MaxDiff = std::max(std::atof(argv[++i]), 0.0);
+        else if (arg == "--size" && hasValue)
+        {
+            if (std::sscanf(argv[++i], "%dx%d", &options.Width, &options.Height) != 2 || options.Width <= 0 || options.Height <= 0)
+            {
+                std::cerr << "Invalid --size '" << argv[i] << "', expected WxH" << std::endl;
+                return false;
+            }
+        }
+        else
+        {
+            std::cerr << "Unknown or incomplete option '" << arg << "'" << std::endl;
+            PrintUsage(argv[0]);
+            return false;
+        }
+    }
+    if (options.Headless && options.TestName.empty() && !options.ListTests)
+    {
+        std::cerr << "--headless needs --test NAME" << std::endl;
+        PrintUsage(argv[0]);
+        return false;
+    }
+    if (options.Headless && options.Frames == 0)
+        options.Frames = 100;
+    return true;
+}
+
+static void RegisterTests(test::TestMenu& testMenu)
+{
+    testMenu.RegisterTest<test::TestClearColor>("Clear Color");
+    testMenu.RegisterTest<test::TestTexture2D>("2D Texture");
+    testMenu.RegisterTest<test::TestBatchRender>("Batch Render");
+    testMenu.RegisterTest<test::TestAsyncTexture>("Async Texture");
+    testMenu.RegisterTest<test::TestTextureAtlas>("Texture Atlas");
+    testMenu.RegisterTest<test::TestInstancing>("Instancing");
+    testMenu.RegisterTest<test::TestMultiDrawIndirect>("Multi-Draw Indirect");
+    testMenu.RegisterTest<test::TestRenderQueue>("Render Queue");
+    testMenu.RegisterTest<test::TestParallelRecord>("Parallel Recording");
+    testMenu.RegisterTest<test::TestFramebuffer>("Framebuffer");
+    testMenu.RegisterTest<test::TestCulling>("Frustum Culling");
+    testMenu.RegisterTest<test::TestSpriteKernels>("SIMD Sprite Kernels");
+    testMenu.RegisterTest<test::TestResourceManager>("Resource Manager");
+}
+
+static test::Test* CreateTestByName(const test::TestMenu& testMenu, const std::string& name)
+{
+    test::Test* test = testMenu.CreateTest(name);
+    if (!test)
+    {
+        std::cerr << "Unknown test '" << name << "', available tests:" << std::endl;
+        for (const std::string& testName : testMenu.GetTestNames())
+            std::cerr << "  " << testName << std::endl;
+    }
+    return test;
+}
+
+// 无窗口模式下 GLEW 会在初始化 GLX 扩展时报 "没有 GLX 显示", 这时GL函数指针已经加载好了, 可以忽略
+static bool InitGLEW(bool headless)
+{
+    GLenum error = glewInit();
+    if (error == GLEW_OK)
+        return true;
+#if defined(GLEW_ERROR_NO_GLX_DISPLAY)
+    if (headless && error == GLEW_ERROR_NO_GLX_DISPLAY)
+        return true;
+#endif
+    std::cerr << "Error: Failed to initialize GLEW! (" << glewGetErrorString(error) << ")" << std::endl;
+    return false;
+}
+
+static void ExportProfile(const CommandLineOptions& options)
+{
+    if (options.ProfileOutput.empty())
+        return;
+    // 再开始一帧, 把最后一帧的 CPU 计时存进历史
+    Profiler::BeginFrame();
+    Profiler::ExportChromeTrace(options.ProfileOutput);
+}
+
+// 无窗口模式跑完之后: 按 --capture 存图, 按 --golden 和参考图比较, 返回进程的退出码
+static int CheckLastFrame(const CommandLineOptions& options, const Framebuffer& framebuffer)
+{
+    if (options.CaptureOutput.empty() && options.GoldenImage.empty())
+        return 0;
+
+    FramebufferReadback readback;
+    CapturedImage image;
+    if (!readback.Request(framebuffer) || !readback.Wait(image))
+    {
+        std::cerr << "Failed to read back the last frame" << std::endl;
+        return -1;
+    }
+    if (!options.CaptureOutput.empty() && !FramebufferReadback::WritePPM(options.CaptureOutput, image))
+        return -1;
+    if (options.GoldenImage.empty())
+        return 0;
+
+    CapturedImage golden;
+    if (!FramebufferReadback::ReadPPM(options.GoldenImage, golden))
+        return -1;
+    double diff = FramebufferReadback::CompareImages(image, golden, options.Tolerance);
+    if (diff < 0.0)
+    {
+        std::cerr << "Golden image mismatch: frame is " << image.Width << "x" << image.Height
+            << ", '" << options.GoldenImage << "' is " << golden.Width << "x" << golden.Height << std::endl;
+        return 1;
+    }
+    bool pass = diff <= options.MaxDiff;
+    std::cout << "Golden image " << (pass ? "match" : "MISMATCH") << ": " << diff * 100.0 << "% of pixels differ by more than "
+        << options.Tolerance << " (allowed " << options.MaxDiff * 100.0 << "%)" << std::endl;
+    return pass ? 0 : 1;
+}
+
+/**
+ * 无窗口模式: 没有 ImGui, 也没有着色器热重载,
+ * 每帧把选中的 Test 画到 Framebuffer 里, 跑完 options.Frames 帧后打印平均帧时间退出。
+ */
+static int RunHeadless(const CommandLineOptions& options)
+{
+    HeadlessContext context(3, 3);
+    if (!context.IsCreated())
+        return -1;
+    if (!InitGLEW(true))
+        return -1;
+    std::cout << "Renderer: " << glGetString(GL_RENDERER) << " (" << glGetString(GL_VERSION) << ")" << std::endl;
+
+#if defined(GL_USE_DEBUG_OUTPUT) && !defined(NDEBUG)
+    GLEnableDebugOutput(OPENGL_DEBUG_OUTPUT_SYNC);
+#endif
+
+    AssetPack assetPack("res/assets.pack");
+    AssetPack::Mount(&assetPack);
+
+    std::unique_ptr<TextureLoader> textureLoader = std::make_unique<TextureLoader>();
+    std::unique_ptr<ResourceManager> resourceManager = std::make_unique<ResourceManager>();
+    FrameLoopSettings settings;
+    settings.Pacing = FramePacing::Uncapped;
+    std::unique_ptr<FrameLoop> frameLoop = std::make_unique<FrameLoop>(nullptr, settings);
+    std::unique_ptr<Framebuffer> framebuffer = std::make_unique<Framebuffer>(options.Width, options.Height);
+
+    test::Test* currentTest = nullptr;
+    test::TestMenu testMenu(currentTest);
+    RegisterTests(testMenu);
+    currentTest = CreateTestByName(testMenu, options.TestName);
+    if (!currentTest)
+        return -1;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < options.Frames; frame++)
+    {
+        frameLoop->BeginFrame();
+        Profiler::BeginFrame();
+
+        GLState::ResetStats();
+        textureLoader->Update();
+        resourceManager->Update();
+        framebuffer->Bind();
+        frameLoop->Update(currentTest);
+        {
+            PROFILE_GPU_SCOPE("Test::OnRender");
+            currentTest->OnRender();
+        }
+        // 没有交换缓冲来推动提交, 手动 flush 一下
+        GLCall(glFlush());
+        frameLoop->EndFrame();
+    }
+    GLCall(glFinish());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Ran " << options.Frames << " frames of '" << options.TestName << "' at "
+        << options.Width << "x" << options.Height << " in " << seconds << " s: "
+        << seconds * 1000.0 / std::max(options.Frames, 1) << " ms/frame, "
+        << options.Frames / std::max(seconds, 1e-9) << " fps" << std::endl;
+    ExportProfile(options);
+    int result = CheckLastFrame(options, *framebuffer);
+
+    frameLoop.reset();
+    delete currentTest;
+    framebuffer.reset();
+    resourceManager.reset();
+    textureLoader.reset();
+    Profiler::Shutdown();
+    return result;
+}
+
+static int RunWindowed(const CommandLineOptions& options)
+{
     GLFWwindow* window;
     
     if (!glfwInit()) 
@@ -28,9 +294,12 @@ int main() {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#if defined(GL_USE_DEBUG_OUTPUT) && !defined(NDEBUG)
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
     
     // 创建一个窗口和它的 OpenGL 上下文
-    window = glfwCreateWindow(960, 540, "Hello World", nullptr, nullptr);
+    window = glfwCreateWindow(options.Width, options.Height, "Hello World", nullptr, nullptr);
     if (!window)
     {           
         std::cerr << "Failed to create GLFW window" << std::endl;
@@ -41,17 +310,14 @@ int main() {
     // 将窗口的上下文设置为当前线程的上下文
     glfwMakeContextCurrent(window);
 
-    // 启用垂直同步
-    glfwSwapInterval(1);
-
     // 初始化 GLEW，加载所有 OpenGL 函数指针
     // std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
-    if (glewInit() != GLEW_OK)
-    {
-        std::cerr << "Error: Failed to initialize GLEW!" << std::endl;
+    if (!InitGLEW(false))
         return -1;
-    }
 
+#if defined(GL_USE_DEBUG_OUTPUT) && !defined(NDEBUG)
+    GLEnableDebugOutput(OPENGL_DEBUG_OUTPUT_SYNC);
+#endif
 
     ImGui::CreateContext();
     ImGui_ImplGlfw_InitForOpenGL(window, true);
@@ -61,24 +327,63 @@ int main() {
     const char* glsl_version = "#version 330";
     ImGui_ImplOpenGL3_Init(glsl_version);
 
+    // AssetCooker 生成的资源包, 存在时纹理和着色器都优先从这里加载 (不用再解码图片)
+    AssetPack assetPack("res/assets.pack");
+    AssetPack::Mount(&assetPack);
+    if (assetPack.IsOpen())
+        std::cout << "Mounted asset pack with " << assetPack.GetEntryCount() << " entries" << std::endl;
+
+    // 异步纹理加载器, 要在GL上下文销毁之前析构
+    std::unique_ptr<TextureLoader> textureLoader = std::make_unique<TextureLoader>();
+    // 着色器热重载, 改了 .shader 文件保存后自动重新编译替换; 要比所有 Shader 先创建、后销毁
+    std::unique_ptr<ShaderHotReload> shaderHotReload = std::make_unique<ShaderHotReload>();
+    // 按路径共享纹理和着色器, 持有 Shader 所以要在 ShaderHotReload 之后创建、之前销毁
+    std::unique_ptr<ResourceManager> resourceManager = std::make_unique<ResourceManager>();
+
+    // 垂直同步 / 不限帧率 / 目标帧率, 以及固定步长模拟, 都在 "Frame Loop" 窗口里切换
+    std::unique_ptr<FrameLoop> frameLoop = std::make_unique<FrameLoop>(window);
+
     test::Test* currentTest = nullptr;
     test::TestMenu* testMenu = new test::TestMenu(currentTest);
     currentTest = testMenu;
 
-    testMenu->RegisterTest<test::TestClearColor>("Clear Color");
-    testMenu->RegisterTest<test::TestTexture2D>("2D Texture");
-    
-    while (!glfwWindowShouldClose(window))
+    RegisterTests(*testMenu);
+    if (!options.TestName.empty())
     {
+        test::Test* test = CreateTestByName(*testMenu, options.TestName);
+        if (test)
+            currentTest = test;
+    }
+
+    // F12 截图: 交换前把后缓冲读到PBO里, 之后几帧里取回来写文件, 不会让这一帧卡住
+    std::unique_ptr<FramebufferReadback> screenshots = std::make_unique<FramebufferReadback>();
+    bool screenshotKeyDown = false;
+    int screenshotCount = 0;
+
+    int frameCount = 0;
+    while (!glfwWindowShouldClose(window) && (options.Frames == 0 || frameCount < options.Frames))
+    {
+        frameLoop->BeginFrame();
+        // 结束上一帧的计时, 读回几帧之前的 GPU 时间戳
+        Profiler::BeginFrame();
 
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
+        GLState::ResetStats();
+        textureLoader->Update();
+        shaderHotReload->Update();
+        resourceManager->Update();
         if (currentTest)
             {
-                currentTest->OnUpdate(0.0f);
-                currentTest->OnRender();
+                // 模拟线程打开时, 它和这里轮流访问 Test; 切换 Test 也要在锁里完成
+                std::lock_guard<std::mutex> lock(frameLoop->GetMutex());
+                frameLoop->Update(currentTest);
+                {
+                    PROFILE_GPU_SCOPE("Test::OnRender");
+                    currentTest->OnRender();
+                }
                 ImGui::Begin("Test");
                 if (currentTest != testMenu && ImGui::Button("<-"))
                 {
@@ -87,16 +392,51 @@ int main() {
                 }
                 currentTest->OnImGuiRender();
                 ImGui::End();
+                frameLoop->SetTest(currentTest);
             }
+        frameLoop->OnImGuiRender();
+        Profiler::OnImGuiRender();
+
+        {
+            PROFILE_GPU_SCOPE("ImGui");
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+        // ImGui 后端直接调用GL改绑定, 状态缓存已经不可信了
+        GLState::Invalidate();
 
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        bool screenshotKey = glfwGetKey(window, GLFW_KEY_F12) == GLFW_PRESS;
+        if (screenshotKey && !screenshotKeyDown)
+        {
+            int width, height;
+            glfwGetFramebufferSize(window, &width, &height);
+            if (!screenshots->Request(0, width, height))
+                std::cout << "Screenshot skipped, previous ones are still being read back" << std::endl;
+        }
+        screenshotKeyDown = screenshotKey;
+        CapturedImage screenshot;
+        while (screenshots->Poll(screenshot))
+        {
+            std::string filepath = "screenshot_" + std::to_string(screenshotCount++) + ".ppm";
+            if (FramebufferReadback::WritePPM(filepath, screenshot))
+                std::cout << "Saved " << filepath << std::endl;
+        }
         
         // 交换前后缓冲
-        glfwSwapBuffers(window);
+        {
+            PROFILE_SCOPE("SwapBuffers");
+            glfwSwapBuffers(window);
+        }
         // 处理所有待处理的事件
         glfwPollEvents();
+
+        frameLoop->EndFrame();
+        frameCount++;
     }
+    ExportProfile(options);
+
+    // 先停掉模拟线程, 再删除 Test
+    frameLoop.reset();
 
     delete currentTest;
     if (currentTest != testMenu)
@@ -104,6 +444,12 @@ int main() {
         delete testMenu;
     }
 
+    screenshots.reset();
+    resourceManager.reset();
+    shaderHotReload.reset();
+    textureLoader.reset();
+    Profiler::Shutdown();
+
     // Cleanup
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -113,4 +459,23 @@ int main() {
 
     std::cout << "Shutting down OpenGL" << std::endl;
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char** argv)
+{
+    CommandLineOptions options;
+    if (!ParseCommandLine(argc, argv, options))
+        return -1;
+
+    if (options.ListTests)
+    {
+        test::Test* currentTest = nullptr;
+        test::TestMenu testMenu(currentTest);
+        RegisterTests(testMenu);
+        for (const std::string& name : testMenu.GetTestNames())
+            std::cout << name << std::endl;
+        return 0;
+    }
+
+    return options.Headless ? RunHeadless(options) : RunWindowed(options);
+}
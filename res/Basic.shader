@@ -5,11 +5,16 @@
 
 out vec2 v_TexCoord; //着色器阶段之间的数据通道，out传递给下个着色器，即顶点着色器--->片段着色器
 
-uniform mat4 u_MVP;
+// 绑定点 UniformBuffer::CameraBinding 上当前绑定的相机缓冲, 每个使用者各有一块 (见 UniformBuffer.h 的 CameraUniforms)
+layout(std140) uniform Camera
+{
+    mat4 u_ViewProjection;
+};
+uniform mat4 u_Model;
 
  void main()   
  {   
-     gl_Position = u_MVP * position; // OpenGL 内置的特殊变量
+     gl_Position = u_ViewProjection * u_Model * position; // OpenGL 内置的特殊变量
      v_TexCoord = texCoord;
  }
 
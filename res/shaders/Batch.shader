@@ -0,0 +1,66 @@
+#shader vertex
+#version 330 core
+// 顶点是压缩格式 (见 BatchRenderer2D.h 的 QuadVertex), 颜色和纹理坐标由 GPU 解包成 float
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec4 a_Color;
+layout(location = 2) in vec2 a_TexCoord;
+layout(location = 3) in uint a_TexIndex; // 这个顶点用第几个纹理插槽, 整数属性
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+flat out uint v_TexIndex; // 整数不能插值
+
+// 绑定点 UniformBuffer::CameraBinding 上当前绑定的相机缓冲, 每个使用者各有一块 (见 UniformBuffer.h 的 CameraUniforms)
+layout(std140) uniform Camera
+{
+    mat4 u_ViewProjection;
+};
+
+void main()
+{
+    gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+    v_Color = a_Color;
+    v_TexCoord = a_TexCoord;
+    v_TexIndex = a_TexIndex;
+}
+
+#shader fragment
+#version 330 core
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+flat in uint v_TexIndex;
+
+// 数组大小要和 BatchRenderer2D::MaxTextureSlots 一致
+uniform sampler2D u_Textures[16];
+
+void main()
+{
+    // GLSL 3.30 里采样器数组只能用常量下标, 而且同一个 draw 里每个quad的插槽不同 (不是动态一致的),
+    // 所以展开成常量下标的 switch。分支里的隐式导数没有定义, 导数在分支外面算好, 用 textureGrad 采样
+    vec2 dx = dFdx(v_TexCoord);
+    vec2 dy = dFdy(v_TexCoord);
+    vec4 texel;
+    switch (v_TexIndex)
+    {
+        case 0u: texel = textureGrad(u_Textures[0], v_TexCoord, dx, dy); break;
+        case 1u: texel = textureGrad(u_Textures[1], v_TexCoord, dx, dy); break;
+        case 2u: texel = textureGrad(u_Textures[2], v_TexCoord, dx, dy); break;
+        case 3u: texel = textureGrad(u_Textures[3], v_TexCoord, dx, dy); break;
+        case 4u: texel = textureGrad(u_Textures[4], v_TexCoord, dx, dy); break;
+        case 5u: texel = textureGrad(u_Textures[5], v_TexCoord, dx, dy); break;
+        case 6u: texel = textureGrad(u_Textures[6], v_TexCoord, dx, dy); break;
+        case 7u: texel = textureGrad(u_Textures[7], v_TexCoord, dx, dy); break;
+        case 8u: texel = textureGrad(u_Textures[8], v_TexCoord, dx, dy); break;
+        case 9u: texel = textureGrad(u_Textures[9], v_TexCoord, dx, dy); break;
+        case 10u: texel = textureGrad(u_Textures[10], v_TexCoord, dx, dy); break;
+        case 11u: texel = textureGrad(u_Textures[11], v_TexCoord, dx, dy); break;
+        case 12u: texel = textureGrad(u_Textures[12], v_TexCoord, dx, dy); break;
+        case 13u: texel = textureGrad(u_Textures[13], v_TexCoord, dx, dy); break;
+        case 14u: texel = textureGrad(u_Textures[14], v_TexCoord, dx, dy); break;
+        case 15u: texel = textureGrad(u_Textures[15], v_TexCoord, dx, dy); break;
+        default: texel = vec4(1.0); break;
+    }
+    color = texel * v_Color;
+}
@@ -0,0 +1,29 @@
+#shader vertex
+#version 330 core
+layout(location = 0) in vec4 a_Position;
+layout(location = 1) in vec4 a_Color;
+
+out vec4 v_Color;
+
+// 绑定点 UniformBuffer::CameraBinding 上当前绑定的相机缓冲, 每个使用者各有一块 (见 UniformBuffer.h 的 CameraUniforms)
+layout(std140) uniform Camera
+{
+    mat4 u_ViewProjection;
+};
+
+void main()
+{
+    gl_Position = u_ViewProjection * a_Position;
+    v_Color = a_Color;
+}
+
+#shader fragment
+#version 330 core
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+
+void main()
+{
+    color = v_Color;
+}
@@ -0,0 +1,37 @@
+#shader vertex
+#version 330 core
+layout(location = 0) in vec4 a_Position;
+layout(location = 1) in vec2 a_TexCoord;
+// 逐实例属性: mat4 占 2,3,4,5 四个位置
+layout(location = 2) in mat4 a_Model;
+layout(location = 6) in vec4 a_Color;
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+
+// 绑定点 UniformBuffer::CameraBinding 上当前绑定的相机缓冲, 每个使用者各有一块 (见 UniformBuffer.h 的 CameraUniforms)
+layout(std140) uniform Camera
+{
+    mat4 u_ViewProjection;
+};
+
+void main()
+{
+    gl_Position = u_ViewProjection * a_Model * a_Position;
+    v_Color = a_Color;
+    v_TexCoord = a_TexCoord;
+}
+
+#shader fragment
+#version 330 core
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+    color = texture(u_Texture, v_TexCoord) * v_Color;
+}
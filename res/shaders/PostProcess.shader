@@ -0,0 +1,33 @@
+#shader vertex
+#version 330 core
+// 不需要顶点缓冲: 用 gl_VertexID 生成一个盖住整个屏幕的大三角形 (glDrawArrays 画 3 个顶点)
+out vec2 v_TexCoord;
+
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    v_TexCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Scene;
+uniform int u_Effect; // 0 不处理, 1 灰度, 2 反色, 3 暗角
+
+void main()
+{
+    vec4 scene = texture(u_Scene, v_TexCoord);
+    vec3 result = scene.rgb;
+    if (u_Effect == 1)
+        result = vec3(dot(result, vec3(0.2126, 0.7152, 0.0722)));
+    else if (u_Effect == 2)
+        result = 1.0 - result;
+    else if (u_Effect == 3)
+        result *= smoothstep(0.8, 0.25, length(v_TexCoord - 0.5));
+    color = vec4(result, 1.0);
+}
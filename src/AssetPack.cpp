@@ -0,0 +1,200 @@
+#include "AssetPack.h"
+
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+// mmap 只在 POSIX 系统上有, 其他平台把整个文件读进内存
+#if defined(__linux__) || defined(__APPLE__)
+#define ASSET_PACK_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AssetPack* AssetPack::s_Mounted = nullptr;
+
+void ExpandToRGBA(const PackedTexture& texture, unsigned char* rgba)
+{
+    size_t pixelCount = (size_t)texture.Width * texture.Height;
+    const unsigned char* src = texture.Pixels;
+    for (size_t i = 0; i < pixelCount; i++, src += texture.Channels, rgba += 4)
+    {
+        switch (texture.Channels)
+        {
+            case 1: rgba[0] = rgba[1] = rgba[2] = src[0]; rgba[3] = 255;    break;
+            case 2: rgba[0] = rgba[1] = rgba[2] = src[0]; rgba[3] = src[1]; break;
+            case 3: memcpy(rgba, src, 3);                 rgba[3] = 255;    break;
+            default: memcpy(rgba, src, 4); break;
+        }
+    }
+}
+
+AssetPack::AssetPack(const std::string& path)
+    : m_FilePath(path), m_Data(nullptr), m_Size(0)
+{
+    if (!Open(path))
+        return;
+
+    const AssetPackHeader* header = (const AssetPackHeader*)m_Data;
+    if (header->Magic != AssetPackMagic || header->Version != AssetPackVersion ||
+        header->EntryTableOffset + (uint64_t)header->EntryCount * sizeof(AssetPackEntry) > m_Size)
+    {
+        std::cout << "Warning: '" << path << "' is not a valid asset pack" << std::endl;
+        Close();
+        return;
+    }
+
+    const AssetPackEntry* entries = (const AssetPackEntry*)(m_Data + header->EntryTableOffset);
+    for (uint32_t i = 0; i < header->EntryCount; i++)
+    {
+        const AssetPackEntry& entry = entries[i];
+        if (entry.Offset > m_Size || entry.Size > m_Size - entry.Offset || entry.Name[AssetPackMaxNameLength - 1] != '\0')
+            continue; // 损坏的条目直接忽略
+        m_Entries[entry.Name] = &entry;
+    }
+}
+
+AssetPack::~AssetPack()
+{
+    if (s_Mounted == this)
+        s_Mounted = nullptr;
+    Close();
+}
+
+bool AssetPack::Open(const std::string& path)
+{
+#ifdef ASSET_PACK_USE_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(AssetPackHeader))
+    {
+        close(fd);
+        return false;
+    }
+
+    // 只读映射, 页面按需从磁盘/页缓存载入, 关闭 fd 后映射仍然有效
+    void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        std::cout << "Warning: failed to map asset pack '" << path << "'" << std::endl;
+        return false;
+    }
+    m_Data = (const unsigned char*)data;
+    m_Size = (size_t)info.st_size;
+#else
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream.is_open())
+        return false;
+    m_Buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    if (m_Buffer.size() < sizeof(AssetPackHeader))
+    {
+        m_Buffer.clear();
+        return false;
+    }
+    m_Data = m_Buffer.data();
+    m_Size = m_Buffer.size();
+#endif
+    return true;
+}
+
+void AssetPack::Close()
+{
+#ifdef ASSET_PACK_USE_MMAP
+    if (m_Data)
+        munmap((void*)m_Data, m_Size);
+#endif
+    m_Buffer.clear();
+    m_Buffer.shrink_to_fit();
+    m_Data = nullptr;
+    m_Size = 0;
+}
+
+const AssetPackEntry* AssetPack::Find(const std::string& name) const
+{
+    auto it = m_Entries.find(name);
+    if (it == m_Entries.end())
+        return nullptr;
+    return it->second;
+}
+
+bool AssetPack::GetTexture(const std::string& name, PackedTexture& texture) const
+{
+    const AssetPackEntry* entry = Find(name);
+    if (!entry || entry->Type != (uint32_t)AssetType::Texture)
+        return false;
+
+    const unsigned char* data = m_Data + entry->Offset;
+    texture.Width = (int)entry->Width;
+    texture.Height = (int)entry->Height;
+    texture.IsCompressed = entry->Format != 0;
+
+    if (entry->Width == 0 || entry->Height == 0 || entry->Width > INT_MAX || entry->Height > INT_MAX)
+        return false;
+
+    if (!texture.IsCompressed)
+    {
+        // 和压缩分支一样, 像素数据不能超出这个条目
+        if (entry->Channels < 1 || entry->Channels > 4 || entry->Size < (uint64_t)entry->Width * entry->Height * entry->Channels)
+            return false;
+        texture.Channels = (int)entry->Channels;
+        texture.Pixels = data;
+        return true;
+    }
+
+    CompressedImage& image = texture.Compressed;
+    image.InternalFormat = entry->Format;
+    image.Width = texture.Width;
+    image.Height = texture.Height;
+    image.Levels.clear();
+    uint64_t offset = 0;
+    for (uint32_t i = 0; i < entry->LevelCount && i < AssetPackMaxLevels; i++)
+    {
+        CompressedImage::Level level;
+        level.Data = data + offset;
+        level.Size = entry->LevelSizes[i];
+        level.Width = texture.Width >> i; if (level.Width < 1) level.Width = 1;
+        level.Height = texture.Height >> i; if (level.Height < 1) level.Height = 1;
+        offset += level.Size;
+        if (offset > entry->Size)
+            return false;
+        image.Levels.push_back(level);
+    }
+    return true;
+}
+
+bool AssetPack::GetShader(const std::string& name, ShaderProgramSource& source) const
+{
+    const AssetPackEntry* entry = Find(name);
+    if (!entry || entry->Type != (uint32_t)AssetType::Shader)
+        return false;
+
+    // 两段以 '\0' 结尾的源码
+    const char* data = (const char*)(m_Data + entry->Offset);
+    size_t vertexLength = strnlen(data, entry->Size);
+    if (vertexLength >= entry->Size)
+        return false;
+    const char* fragment = data + vertexLength + 1;
+    size_t fragmentLength = strnlen(fragment, entry->Size - vertexLength - 1);
+
+    source.VertexSource.assign(data, vertexLength);
+    source.FragmentSource.assign(fragment, fragmentLength);
+    return true;
+}
+
+void AssetPack::Mount(AssetPack* pack)
+{
+    s_Mounted = (pack && pack->IsOpen()) ? pack : nullptr;
+}
+
+AssetPack* AssetPack::GetMounted()
+{
+    return s_Mounted;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AssetPackFormat.h"
+#include "CompressedImage.h"
+#include "Shader.h"
+
+// 从资源包里取出的纹理, 所有指针都指向映射的文件内存
+struct PackedTexture
+{
+	bool IsCompressed = false;
+	int Width = 0, Height = 0;
+	int Channels = 0;                    // 未压缩时
+	const unsigned char* Pixels = nullptr; // 未压缩时, 已经上下翻转过, 可以直接上传
+	CompressedImage Compressed;          // 压缩时
+};
+
+// 未压缩纹理按 stb_image 强制 4 通道时的规则扩展成 RGBA (灰度复制到 RGB, 没有 alpha 的补 255), rgba 要有 Width*Height*4 字节
+void ExpandToRGBA(const PackedTexture& texture, unsigned char* rgba);
+
+/**
+ * 运行时的资源包读取:
+ *      用 mmap 把 AssetCooker 生成的 .pack 整个映射进内存 (没有 mmap 的平台上整个读进内存), 不做任何解码,
+ *      纹理数据直接从映射的内存上传给GL (不经过额外的拷贝)。
+ *      main 挂载之后, Texture / Shader 按路径构造时会先在资源包里找, 找不到再读原始文件。
+ */
+class AssetPack
+{
+private:
+	std::string m_FilePath;
+	const unsigned char* m_Data; // mmap 的起始地址, 或者指向 m_Buffer
+	size_t m_Size;
+	std::vector<unsigned char> m_Buffer; // 不用 mmap 时文件内容放在这里
+	std::unordered_map<std::string, const AssetPackEntry*> m_Entries;
+
+	static AssetPack* s_Mounted;
+
+public:
+	AssetPack(const std::string& path);
+	~AssetPack();
+
+	AssetPack(const AssetPack&) = delete;
+	AssetPack& operator=(const AssetPack&) = delete;
+
+	inline bool IsOpen() const { return m_Data != nullptr; }
+	inline unsigned int GetEntryCount() const { return (unsigned int)m_Entries.size(); }
+
+	const AssetPackEntry* Find(const std::string& name) const;
+	bool GetTexture(const std::string& name, PackedTexture& texture) const;
+	bool GetShader(const std::string& name, ShaderProgramSource& source) const;
+
+	// 挂载后 Texture/Shader 会优先从这个包加载; 传 nullptr 取消挂载
+	static void Mount(AssetPack* pack);
+	static AssetPack* GetMounted();
+
+private:
+	// 把整个文件放进 m_Data / m_Size
+	bool Open(const std::string& path);
+	void Close();
+};
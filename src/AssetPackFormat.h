@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * 资源包 (.pack) 的二进制格式, AssetCooker 写, AssetPack 读 (mmap)。
+ *      [AssetPackHeader][数据块 ...][AssetPackEntry * EntryCount]
+ *      每个数据块按 AssetPackAlignment 对齐, 映射之后可以直接把指针交给 glTexImage2D。
+ * 这里只放纯数据结构, 不依赖GL, 离线工具和运行时共用。
+ */
+
+static const uint32_t AssetPackMagic = 0x4B415041; // "APAK"
+static const uint32_t AssetPackVersion = 1;
+static const uint32_t AssetPackAlignment = 16;
+static const uint32_t AssetPackMaxNameLength = 128;
+static const uint32_t AssetPackMaxLevels = 16;
+
+enum class AssetType : uint32_t
+{
+	Texture = 1, // 解码好的像素 (Channels 个 8bit 通道) 或者 GPU 压缩格式的 mipmap 链
+	Shader = 2   // 预处理过的着色器: 顶点着色器源码 '\0' 片段着色器源码 '\0'
+};
+
+struct AssetPackHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t EntryCount;
+	uint32_t Reserved;
+	uint64_t EntryTableOffset;
+};
+
+struct AssetPackEntry
+{
+	char Name[AssetPackMaxNameLength]; // 以 '\0' 结尾, 和运行时使用的路径一致, 比如 "res/logo.png"
+	uint32_t Type;                     // AssetType
+	uint32_t Format;                   // 纹理: 0 表示未压缩, 否则是 GL_COMPRESSED_* 内部格式
+	uint32_t Width;
+	uint32_t Height;
+	uint32_t Channels;                 // 未压缩纹理的通道数 (1-4)
+	uint32_t LevelCount;               // 压缩纹理的 mipmap 级数, 未压缩纹理为 1
+	uint32_t LevelSizes[AssetPackMaxLevels]; // 每一级的字节数, 在数据块里依次紧挨着
+	uint64_t Offset;                   // 数据块在文件中的偏移
+	uint64_t Size;                     // 数据块总字节数
+};
@@ -0,0 +1,316 @@
+#include "BatchRenderer2D.h"
+
+#include "Render.h"
+#include "Profiler.h"
+#include "VertexBufferLayout.h"
+#include "SpriteBatch.h"
+
+#include <algorithm>
+
+static const Unorm16x2 s_QuadTexCoords[4] = {
+    Unorm16x2::Pack({ 0.0f, 0.0f }), Unorm16x2::Pack({ 1.0f, 0.0f }), Unorm16x2::Pack({ 1.0f, 1.0f }), Unorm16x2::Pack({ 0.0f, 1.0f })
+};
+
+static const glm::vec4 s_QuadPositions[4] = {
+    { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f, 1.0f },
+    { 1.0f, 1.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f, 1.0f }
+};
+
+BatchRenderer2D::BatchRenderer2D(const std::string& shaderPath)
+    : m_VertexBufferPtr(nullptr), m_IndexCount(0), m_TextureSlots{}, m_TextureSlotIndex(1),
+    m_TextureSlotCount(MaxTextureSlots)
+{
+    m_VAO = std::make_unique<VertexArray>();
+    m_VertexBuffer = std::make_unique<DynamicVertexBuffer>(MaxVertices * (unsigned int)sizeof(QuadVertex));
+
+    m_VAO->AddBuffer<QuadVertex>(*m_VertexBuffer);
+
+    // 所有quad的索引模式都一样, 只是每个quad的顶点偏移4
+    std::unique_ptr<unsigned int[]> indices(new unsigned int[MaxIndices]);
+    unsigned int offset = 0;
+    for (unsigned int i = 0; i < MaxIndices; i += 6)
+    {
+        indices[i + 0] = offset + 0;
+        indices[i + 1] = offset + 1;
+        indices[i + 2] = offset + 2;
+        indices[i + 3] = offset + 2;
+        indices[i + 4] = offset + 3;
+        indices[i + 5] = offset + 0;
+        offset += 4;
+    }
+    m_IndexBuffer = std::make_unique<IndexBuffer>(indices.get(), MaxIndices);
+
+    m_VertexBufferBase.reset(new QuadVertex[MaxVertices]);
+    m_SpriteSlots.reset(new uint32_t[MaxQuads]);
+
+    // 0 号插槽放一张 1x1 的白色纹理, 纯色quad采样它再乘上顶点颜色
+    m_WhiteTexture = std::make_unique<Texture>(1, 1);
+    unsigned int white = 0xffffffff;
+    m_WhiteTexture->SetData(&white, sizeof(unsigned int));
+    m_TextureSlots[0] = m_WhiteTexture.get();
+
+    // 实际可用的插槽数受硬件限制
+    int maxUnits = 0;
+    GLCall(glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits));
+    if (maxUnits > 0 && (unsigned int)maxUnits < m_TextureSlotCount)
+        m_TextureSlotCount = (unsigned int)maxUnits;
+
+    int samplers[MaxTextureSlots];
+    for (unsigned int i = 0; i < MaxTextureSlots; i++)
+        samplers[i] = (int)i;
+
+    m_Shader = std::make_unique<Shader>(shaderPath);
+    m_Shader->Bind();
+    m_Shader->SetUniform1iv("u_Textures", MaxTextureSlots, samplers);
+    m_Shader->BindUniformBlock("Camera", UniformBuffer::CameraBinding);
+
+    m_CameraBuffer = std::make_unique<UniformBuffer>((unsigned int)sizeof(CameraUniforms), UniformBuffer::CameraBinding);
+}
+
+BatchRenderer2D::~BatchRenderer2D()
+{
+}
+
+void BatchRenderer2D::BeginScene(const glm::mat4& viewProjection)
+{
+    // 一个场景只上传一次, 之后每批 Flush 只需要绑定
+    CameraUniforms camera = { viewProjection };
+    m_CameraBuffer->SetData(&camera, sizeof(CameraUniforms));
+    StartBatch();
+}
+
+void BatchRenderer2D::EndScene()
+{
+    Flush();
+}
+
+void BatchRenderer2D::StartBatch()
+{
+    m_IndexCount = 0;
+    m_VertexBufferPtr = m_VertexBufferBase.get();
+    m_TextureSlotIndex = 1;
+}
+
+void BatchRenderer2D::NextBatch()
+{
+    Flush();
+    StartBatch();
+}
+
+void BatchRenderer2D::Flush()
+{
+    if (m_IndexCount == 0)
+        return;
+
+    GL_DEBUG_SCOPE("BatchRenderer2D::Flush");
+    PROFILE_GPU_SCOPE("BatchRenderer2D::Flush");
+
+    // 只上传这一批实际写入的部分, 数据在环形缓冲里的位置通过 base vertex 告诉GPU
+    unsigned int size = (unsigned int)((m_VertexBufferPtr - m_VertexBufferBase.get()) * sizeof(QuadVertex));
+    unsigned int offset = m_VertexBuffer->SetData(m_VertexBufferBase.get(), size);
+    int baseVertex = (int)(offset / sizeof(QuadVertex));
+
+    for (unsigned int i = 0; i < m_TextureSlotIndex; i++)
+        m_TextureSlots[i]->Bind(i);
+
+    m_Shader->Bind();
+    m_CameraBuffer->Bind();
+    m_VAO->Bind();
+    m_IndexBuffer->Bind();
+    GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, m_IndexCount, GL_UNSIGNED_INT, nullptr, baseVertex));
+    m_Stats.DrawCalls++;
+
+    StartBatch();
+}
+
+bool BatchRenderer2D::TryGetTextureSlot(const Texture* texture, uint32_t& slot)
+{
+    if (!texture)
+    {
+        slot = 0;
+        return true;
+    }
+
+    // 同一批里已经占了插槽的纹理直接复用
+    for (unsigned int i = 1; i < m_TextureSlotIndex; i++)
+    {
+        if (m_TextureSlots[i]->GetRendererID() == texture->GetRendererID())
+        {
+            slot = i;
+            return true;
+        }
+    }
+
+    if (m_TextureSlotIndex >= m_TextureSlotCount)
+        return false;
+
+    m_TextureSlots[m_TextureSlotIndex] = texture;
+    slot = m_TextureSlotIndex++;
+    return true;
+}
+
+uint32_t BatchRenderer2D::GetTextureSlot(const Texture* texture)
+{
+    uint32_t slot;
+    if (!TryGetTextureSlot(texture, slot))
+    {
+        NextBatch();
+        TryGetTextureSlot(texture, slot);
+    }
+    return slot;
+}
+
+void BatchRenderer2D::EmitQuad(const glm::vec4 positions[4], const glm::vec4& color, uint32_t texIndex, const Unorm16x2* texCoords)
+{
+    if (!texCoords)
+        texCoords = s_QuadTexCoords;
+
+    // 颜色四个顶点一样, 只打包一次
+    Unorm8x4 packedColor = Unorm8x4::Pack(color);
+    for (int i = 0; i < 4; i++)
+    {
+        m_VertexBufferPtr->Position = glm::vec3(positions[i]);
+        m_VertexBufferPtr->Color = packedColor;
+        m_VertexBufferPtr->TexCoord = texCoords[i];
+        m_VertexBufferPtr->TexIndex = texIndex;
+        m_VertexBufferPtr++;
+    }
+    m_IndexCount += 6;
+    m_Stats.QuadCount++;
+}
+
+void BatchRenderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
+{
+    DrawQuad(glm::vec3(position, 0.0f), size, color);
+}
+
+void BatchRenderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color)
+{
+    if (m_IndexCount >= MaxIndices)
+        NextBatch();
+
+    // 轴对齐的quad直接算四个角, 省掉矩阵乘法
+    const glm::vec4 positions[4] = {
+        { position.x,          position.y,          position.z, 1.0f },
+        { position.x + size.x, position.y,          position.z, 1.0f },
+        { position.x + size.x, position.y + size.y, position.z, 1.0f },
+        { position.x,          position.y + size.y, position.z, 1.0f }
+    };
+    EmitQuad(positions, color, 0);
+}
+
+void BatchRenderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const Texture& texture, const glm::vec4& tint)
+{
+    DrawQuad(glm::vec3(position, 0.0f), size, texture, tint);
+}
+
+void BatchRenderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const Texture& texture, const glm::vec4& tint)
+{
+    if (m_IndexCount >= MaxIndices)
+        NextBatch();
+
+    // 先拿插槽: 插槽不够时会 Flush, 要在写顶点之前
+    uint32_t texIndex = GetTextureSlot(&texture);
+
+    const glm::vec4 positions[4] = {
+        { position.x,          position.y,          position.z, 1.0f },
+        { position.x + size.x, position.y,          position.z, 1.0f },
+        { position.x + size.x, position.y + size.y, position.z, 1.0f },
+        { position.x,          position.y + size.y, position.z, 1.0f }
+    };
+    EmitQuad(positions, tint, texIndex);
+}
+
+void BatchRenderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const AtlasRegion& region, const glm::vec4& tint)
+{
+    if (!region.IsValid())
+        return;
+
+    if (m_IndexCount >= MaxIndices)
+        NextBatch();
+
+    uint32_t texIndex = GetTextureSlot(region.Page);
+
+    const glm::vec4 positions[4] = {
+        { position.x,          position.y,          0.0f, 1.0f },
+        { position.x + size.x, position.y,          0.0f, 1.0f },
+        { position.x + size.x, position.y + size.y, 0.0f, 1.0f },
+        { position.x,          position.y + size.y, 0.0f, 1.0f }
+    };
+    const Unorm16x2 texCoords[4] = {
+        Unorm16x2::Pack({ region.UVMin.x, region.UVMin.y }), Unorm16x2::Pack({ region.UVMax.x, region.UVMin.y }),
+        Unorm16x2::Pack({ region.UVMax.x, region.UVMax.y }), Unorm16x2::Pack({ region.UVMin.x, region.UVMax.y })
+    };
+    EmitQuad(positions, tint, texIndex, texCoords);
+}
+
+void BatchRenderer2D::DrawQuad(const glm::mat4& transform, const glm::vec4& color, const Texture* texture)
+{
+    if (m_IndexCount >= MaxIndices)
+        NextBatch();
+
+    uint32_t texIndex = GetTextureSlot(texture);
+
+    const glm::vec4 positions[4] = {
+        transform * s_QuadPositions[0], transform * s_QuadPositions[1],
+        transform * s_QuadPositions[2], transform * s_QuadPositions[3]
+    };
+    EmitQuad(positions, color, texIndex);
+}
+
+void BatchRenderer2D::DrawSprites(const SpriteBatch& sprites, size_t first, size_t count)
+{
+    size_t end = first + std::min(count, sprites.Size() - std::min(first, sprites.Size()));
+    size_t i = first;
+    while (i < end)
+    {
+        if (m_IndexCount >= MaxIndices)
+            NextBatch();
+
+        // 这一批还能放多少个, 再按顺序分配纹理插槽, 插槽用完的地方就是这一段的结尾
+        size_t chunkEnd = std::min(end, i + (MaxIndices - m_IndexCount) / 6);
+        size_t j = i;
+        const Texture* lastTexture = nullptr;
+        uint32_t lastSlot = 0;
+        for (; j < chunkEnd; j++)
+        {
+            const Texture* texture = sprites.Textures[j];
+            // 相邻的 sprite 大多用同一张纹理, 不用每个都查一遍插槽
+            if (texture != lastTexture)
+            {
+                if (!TryGetTextureSlot(texture, lastSlot))
+                    break;
+                lastTexture = texture;
+            }
+            m_SpriteSlots[j - i] = lastSlot;
+        }
+
+        size_t quads = j - i;
+        if (quads > 0)
+        {
+            SpriteKernels::GenerateVertices(sprites, i, quads, m_SpriteSlots.get(), m_VertexBufferPtr);
+            m_VertexBufferPtr += quads * 4;
+            m_IndexCount += (unsigned int)quads * 6;
+            m_Stats.QuadCount += (unsigned int)quads;
+            i = j;
+        }
+        if (j < chunkEnd)
+            NextBatch();
+    }
+}
+
+void BatchRenderer2D::SubmitQuad(const QuadVertex vertices[4], const Texture* texture)
+{
+    if (m_IndexCount >= MaxIndices)
+        NextBatch();
+
+    uint32_t texIndex = GetTextureSlot(texture);
+    for (int i = 0; i < 4; i++)
+    {
+        *m_VertexBufferPtr = vertices[i];
+        m_VertexBufferPtr->TexIndex = texIndex;
+        m_VertexBufferPtr++;
+    }
+    m_IndexCount += 6;
+    m_Stats.QuadCount++;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <glm/glm.hpp>
+
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "TextureAtlas.h"
+#include "UniformBuffer.h"
+#include "VertexFormats.h"
+
+class SpriteBatch;
+
+// 批渲染的顶点格式, 和 Batch.shader 的 layout 一一对应
+// 每帧都要整块上传, 所以用压缩格式: 24 字节 (全用 float 是 44 字节)
+struct QuadVertex
+{
+	glm::vec3 Position;
+	Unorm8x4 Color;      // 超出 [0,1] 的颜色会被截断
+	Unorm16x2 TexCoord;  // 只支持 [0,1] 的纹理坐标 (整张纹理或图集里的一块), 不能用来平铺
+	uint32_t TexIndex;   // 纹理插槽, 0 号插槽固定是白色纹理 (纯色quad); 着色器里是 uint
+
+	static constexpr auto GetLayout()
+	{
+		return std::array{
+			VERTEX_ATTRIBUTE(QuadVertex, Position), // a_Position
+			VERTEX_ATTRIBUTE(QuadVertex, Color),    // a_Color
+			VERTEX_ATTRIBUTE(QuadVertex, TexCoord), // a_TexCoord
+			VERTEX_ATTRIBUTE(QuadVertex, TexIndex)  // a_TexIndex
+		};
+	}
+};
+
+/**
+ * 动态批渲染器:
+ *      每个 DrawQuad 只是把4个顶点写进CPU端的顶点数组, 真正的 draw call 在 Flush 时才发出。
+ *      顶点缓冲是持久映射的环形 DynamicVertexBuffer, 上传不会让CPU等GPU。
+ *      索引缓冲是固定的 (0,1,2,2,3,0 的模式), 构造时一次生成好, 之后所有批次共用。
+ *      顶点数组写满或者纹理插槽用完时会自动 Flush, 然后开始下一批。
+ * 用法:
+ *      renderer.BeginScene(proj * view);
+ *      renderer.DrawQuad(...); // 任意多次
+ *      renderer.EndScene();
+ */
+class BatchRenderer2D
+{
+public:
+	struct Statistics
+	{
+		unsigned int DrawCalls = 0;
+		unsigned int QuadCount = 0;
+
+		unsigned int GetVertexCount() const { return QuadCount * 4; }
+		unsigned int GetIndexCount() const { return QuadCount * 6; }
+	};
+
+	static const unsigned int MaxQuads = 10000;
+	static const unsigned int MaxVertices = MaxQuads * 4;
+	static const unsigned int MaxIndices = MaxQuads * 6;
+	static const unsigned int MaxTextureSlots = 16; // 和 Batch.shader 里 u_Textures 的数组大小一致
+
+private:
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<DynamicVertexBuffer> m_VertexBuffer;
+	std::unique_ptr<IndexBuffer> m_IndexBuffer;
+	std::unique_ptr<Shader> m_Shader;
+	std::unique_ptr<Texture> m_WhiteTexture;
+	std::unique_ptr<UniformBuffer> m_CameraBuffer;
+
+	// CPU端的顶点暂存区, Flush 时整块上传
+	std::unique_ptr<QuadVertex[]> m_VertexBufferBase;
+	QuadVertex* m_VertexBufferPtr;
+	unsigned int m_IndexCount;
+
+	std::array<const Texture*, MaxTextureSlots> m_TextureSlots;
+	unsigned int m_TextureSlotIndex; // 下一个空闲插槽
+	unsigned int m_TextureSlotCount; // min(GL_MAX_TEXTURE_IMAGE_UNITS, MaxTextureSlots)
+	std::unique_ptr<uint32_t[]> m_SpriteSlots; // DrawSprites 里每个 sprite 的纹理插槽, 交给内核
+
+	Statistics m_Stats;
+
+public:
+	BatchRenderer2D(const std::string& shaderPath = "res/shaders/Batch.shader");
+	~BatchRenderer2D();
+
+	void BeginScene(const glm::mat4& viewProjection);
+	void EndScene();
+	// 把当前批次提交给GPU, 然后开始新的一批
+	void Flush();
+
+	// 轴对齐的quad, position 是左下角
+	void DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
+	void DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color);
+	void DrawQuad(const glm::vec2& position, const glm::vec2& size, const Texture& texture, const glm::vec4& tint = glm::vec4(1.0f));
+	void DrawQuad(const glm::vec3& position, const glm::vec2& size, const Texture& texture, const glm::vec4& tint = glm::vec4(1.0f));
+	// 画图集里的一张小图
+	void DrawQuad(const glm::vec2& position, const glm::vec2& size, const AtlasRegion& region, const glm::vec4& tint = glm::vec4(1.0f));
+	// 任意变换的单位quad ([0,1] x [0,1]), texture 为空时画纯色
+	void DrawQuad(const glm::mat4& transform, const glm::vec4& color, const Texture* texture = nullptr);
+	// 画 sprites 里从 first 开始的 count 个 sprite, 顶点由 SpriteKernels 的 SIMD 内核成段生成 (见 SpriteBatch.h)
+	void DrawSprites(const SpriteBatch& sprites, size_t first = 0, size_t count = (size_t)-1);
+	// 提交已经算好的4个顶点 (比如工作线程里录制的 CommandList), 只在这里分配纹理插槽, 顶点里的 TexIndex 会被覆盖
+	void SubmitQuad(const QuadVertex vertices[4], const Texture* texture);
+
+	inline const Statistics& GetStats() const { return m_Stats; }
+	inline void ResetStats() { m_Stats = Statistics(); }
+
+private:
+	void StartBatch();
+	void NextBatch();
+	uint32_t GetTextureSlot(const Texture* texture);
+	// 和 GetTextureSlot 一样, 但插槽用完时不 Flush, 返回 false
+	bool TryGetTextureSlot(const Texture* texture, uint32_t& slot);
+	// texCoords 为空时用整张纹理
+	void EmitQuad(const glm::vec4 positions[4], const glm::vec4& color, uint32_t texIndex, const Unorm16x2* texCoords = nullptr);
+};
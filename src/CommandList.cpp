@@ -0,0 +1,73 @@
+#include "CommandList.h"
+
+#include <algorithm>
+
+static const Unorm16x2 s_QuadTexCoords[4] = {
+    Unorm16x2::Pack({ 0.0f, 0.0f }), Unorm16x2::Pack({ 1.0f, 0.0f }), Unorm16x2::Pack({ 1.0f, 1.0f }), Unorm16x2::Pack({ 0.0f, 1.0f })
+};
+
+static const glm::vec4 s_QuadPositions[4] = {
+    { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f, 1.0f },
+    { 1.0f, 1.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f, 1.0f }
+};
+
+static uint64_t MakeQuadKey(const Texture* texture, unsigned int layer)
+{
+    return ((uint64_t)layer << 32) | (texture ? texture->GetRendererID() : 0);
+}
+
+void CommandList::Reset()
+{
+    m_Quads.clear();
+    m_Items.clear();
+    m_ItemKeys.clear();
+}
+
+void CommandList::DrawQuad(const glm::mat4& transform, const glm::vec4& color, const Texture* texture, unsigned int layer)
+{
+    RecordedQuad& quad = m_Quads.emplace_back();
+    Unorm8x4 packedColor = Unorm8x4::Pack(color);
+    for (int i = 0; i < 4; i++)
+    {
+        quad.Vertices[i].Position = glm::vec3(transform * s_QuadPositions[i]);
+        quad.Vertices[i].Color = packedColor;
+        quad.Vertices[i].TexCoord = s_QuadTexCoords[i];
+        quad.Vertices[i].TexIndex = 0;
+    }
+    quad.Tex = texture;
+    quad.Key = MakeQuadKey(texture, layer);
+}
+
+void CommandList::DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, const Texture* texture, unsigned int layer)
+{
+    RecordedQuad& quad = m_Quads.emplace_back();
+    const glm::vec3 positions[4] = {
+        { position.x,          position.y,          position.z },
+        { position.x + size.x, position.y,          position.z },
+        { position.x + size.x, position.y + size.y, position.z },
+        { position.x,          position.y + size.y, position.z }
+    };
+    Unorm8x4 packedColor = Unorm8x4::Pack(color);
+    for (int i = 0; i < 4; i++)
+    {
+        quad.Vertices[i].Position = positions[i];
+        quad.Vertices[i].Color = packedColor;
+        quad.Vertices[i].TexCoord = s_QuadTexCoords[i];
+        quad.Vertices[i].TexIndex = 0;
+    }
+    quad.Tex = texture;
+    quad.Key = MakeQuadKey(texture, layer);
+}
+
+void CommandList::Draw(const RenderItem& item)
+{
+    m_Items.push_back(item);
+    m_ItemKeys.push_back(RenderQueue::MakeSortKey(item));
+}
+
+void CommandList::SortQuads()
+{
+    std::stable_sort(m_Quads.begin(), m_Quads.end(), [](const RecordedQuad& a, const RecordedQuad& b) {
+        return a.Key < b.Key;
+    });
+}
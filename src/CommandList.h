@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "BatchRenderer2D.h"
+#include "RenderQueue.h"
+
+// 录制好的一个quad: 顶点已经变换好, 回放时直接拷进 BatchRenderer2D
+struct RecordedQuad
+{
+	QuadVertex Vertices[4];
+	const Texture* Tex; // 为空时是纯色
+	uint64_t Key;       // 层 << 32 | 纹理ID, SortQuads 按它把同一纹理的quad排到一起
+};
+
+/**
+ * 命令列表:
+ *      只在CPU上记录绘制命令, 不调用任何GL函数, 所以可以在工作线程里录制 (每个线程一个列表)。
+ *      quad 在录制时就做完变换和顶点生成, 网格绘制在录制时就算好 RenderQueue 的排序键;
+ *      渲染线程用 CommandRecorder::Replay 把所有列表按顺序交给 BatchRenderer2D / RenderQueue。
+ */
+class CommandList
+{
+private:
+	std::vector<RecordedQuad> m_Quads;
+	std::vector<RenderItem> m_Items;
+	std::vector<uint64_t> m_ItemKeys;
+
+public:
+	// 清空但保留容量, 每帧重用
+	void Reset();
+
+	// 任意变换的单位quad ([0,1] x [0,1]), 和 BatchRenderer2D::DrawQuad 一致
+	void DrawQuad(const glm::mat4& transform, const glm::vec4& color, const Texture* texture = nullptr, unsigned int layer = 0);
+	// 轴对齐的quad, position 是左下角
+	void DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, const Texture* texture = nullptr, unsigned int layer = 0);
+	// 交给 RenderQueue 的网格绘制
+	void Draw(const RenderItem& item);
+
+	// 按 (层, 纹理) 稳定排序 quad, 减少纹理插槽用满时的 flush。
+	// 同层内会按纹理重排, 只有同纹理的quad之间保持录制顺序: 重叠的半透明quad前后关系会变, 这种情况不要排序
+	void SortQuads();
+
+	inline const std::vector<RecordedQuad>& GetQuads() const { return m_Quads; }
+	inline const std::vector<RenderItem>& GetItems() const { return m_Items; }
+	inline const std::vector<uint64_t>& GetItemKeys() const { return m_ItemKeys; }
+};
@@ -0,0 +1,102 @@
+#include "CommandRecorder.h"
+
+#include "Profiler.h"
+
+CommandRecorder::CommandRecorder(unsigned int threadCount)
+    : m_Workers(threadCount), m_JobCount(0), m_Sorted(false)
+{
+}
+
+CommandRecorder::~CommandRecorder()
+{
+}
+
+void CommandRecorder::Record(const RecordFunction& record, unsigned int jobCount, bool sortQuads)
+{
+    PROFILE_SCOPE("CommandRecorder::Record");
+    if (jobCount == 0)
+        jobCount = m_Workers.GetThreadCount();
+    while (m_Lists.size() < jobCount)
+        m_Lists.push_back(std::make_unique<CommandList>());
+    m_JobCount = jobCount;
+    m_Sorted = sortQuads;
+
+    // Wait 之后才返回, 任务里直接引用 record 是安全的
+    for (unsigned int job = 0; job < jobCount; job++)
+    {
+        CommandList* list = m_Lists[job].get();
+        m_Workers.Submit([&record, list, job, jobCount, sortQuads]() {
+            PROFILE_SCOPE("CommandRecorder::Job");
+            list->Reset();
+            record(*list, job, jobCount);
+            if (sortQuads)
+                list->SortQuads();
+        });
+    }
+    m_Workers.Wait();
+
+    m_Stats = Statistics();
+    m_Stats.Jobs = jobCount;
+    for (unsigned int job = 0; job < jobCount; job++)
+    {
+        m_Stats.Quads += (unsigned int)m_Lists[job]->GetQuads().size();
+        m_Stats.Items += (unsigned int)m_Lists[job]->GetItems().size();
+    }
+}
+
+void CommandRecorder::Replay(BatchRenderer2D& batch, RenderQueue* queue)
+{
+    PROFILE_SCOPE("CommandRecorder::Replay");
+    if (m_Sorted)
+        ReplayMergedQuads(batch);
+
+    for (unsigned int job = 0; job < m_JobCount; job++)
+    {
+        const CommandList& list = *m_Lists[job];
+        if (!m_Sorted)
+        {
+            for (const RecordedQuad& quad : list.GetQuads())
+                batch.SubmitQuad(quad.Vertices, quad.Tex);
+        }
+
+        // 网格绘制由 RenderQueue 自己排序, 按 job 顺序交过去就行
+        if (!queue)
+            continue;
+        const std::vector<RenderItem>& items = list.GetItems();
+        const std::vector<uint64_t>& keys = list.GetItemKeys();
+        for (size_t i = 0; i < items.size(); i++)
+            queue->Submit(items[i], keys[i]);
+    }
+}
+
+void CommandRecorder::ReplayMergedQuads(BatchRenderer2D& batch)
+{
+    // 单线程录制后整体稳定排序时, 键相同的quad保持录制顺序, 也就是 job 0 的在前、job 1 的在后 ...
+    // 每个列表已经各自排好序, 所以每次找出所有列表开头最小的键, 再按 job 顺序把各列表里这个键的一整段提交,
+    // 得到的就是整体排序的结果。键的种类 (层 x 纹理) 很少, 比逐个quad比较快得多
+    m_MergeCursors.assign(m_JobCount, 0);
+    while (true)
+    {
+        bool remaining = false;
+        uint64_t key = 0;
+        for (unsigned int job = 0; job < m_JobCount; job++)
+        {
+            const std::vector<RecordedQuad>& quads = m_Lists[job]->GetQuads();
+            if (m_MergeCursors[job] < quads.size() && (!remaining || quads[m_MergeCursors[job]].Key < key))
+            {
+                key = quads[m_MergeCursors[job]].Key;
+                remaining = true;
+            }
+        }
+        if (!remaining)
+            break;
+
+        for (unsigned int job = 0; job < m_JobCount; job++)
+        {
+            const std::vector<RecordedQuad>& quads = m_Lists[job]->GetQuads();
+            size_t& cursor = m_MergeCursors[job];
+            for (; cursor < quads.size() && quads[cursor].Key == key; cursor++)
+                batch.SubmitQuad(quads[cursor].Vertices, quads[cursor].Tex);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "CommandList.h"
+#include "ThreadPool.h"
+
+/**
+ * 多线程录制, 单线程提交:
+ *      Record 把工作拆成 jobCount 份交给线程池, 每份往自己的 CommandList 里录制 (剔除、排序、顶点生成都在工作线程),
+ *      全部完成后返回; 之后渲染线程调用 Replay, 按 job 的顺序把所有列表提交给GL, 结果和单线程录制完全一样。
+ *      排序时每个 job 只排自己的列表, Replay 再把各列表归并起来, 和单线程录制后整体 SortQuads 的顺序也一样。
+ * 录制函数里不能调用GL, 也不能修改被多个 job 共享的数据。
+ */
+class CommandRecorder
+{
+public:
+	// job 是第几份 (0 ~ jobCount-1), 录制到 list 里
+	using RecordFunction = std::function<void(CommandList& list, unsigned int job, unsigned int jobCount)>;
+
+	struct Statistics
+	{
+		unsigned int Jobs = 0;
+		unsigned int Quads = 0;
+		unsigned int Items = 0;
+	};
+
+private:
+	ThreadPool m_Workers;
+	std::vector<std::unique_ptr<CommandList>> m_Lists;
+	std::vector<size_t> m_MergeCursors; // 归并时每个列表提交到第几个quad
+	unsigned int m_JobCount;
+	bool m_Sorted; // 上一次 Record 排过序, Replay 要归并
+	Statistics m_Stats;
+
+public:
+	// threadCount 为 0 时用 (CPU核数 - 1)
+	CommandRecorder(unsigned int threadCount = 0);
+	~CommandRecorder();
+
+	// jobCount 为 0 时每个工作线程一份; sortQuads 时每个 job 录完在自己的线程里 SortQuads (会改变同层内的绘制顺序, 见 CommandList)
+	void Record(const RecordFunction& record, unsigned int jobCount = 0, bool sortQuads = false);
+	// 只能在渲染线程调用; batch 要已经 BeginScene, queue 为空时忽略网格绘制
+	void Replay(BatchRenderer2D& batch, RenderQueue* queue = nullptr);
+
+	inline unsigned int GetThreadCount() const { return m_Workers.GetThreadCount(); }
+	inline const Statistics& GetStats() const { return m_Stats; }
+
+private:
+	void ReplayMergedQuads(BatchRenderer2D& batch);
+};
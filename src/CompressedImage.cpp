@@ -0,0 +1,307 @@
+#include "CompressedImage.h"
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include <GL/glew.h>
+
+static std::string GetExtension(const std::string& path)
+{
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos)
+        return "";
+    std::string ext = path.substr(dot + 1);
+    for (auto& c : ext)
+        c = (char)tolower(c);
+    return ext;
+}
+
+static unsigned int ReadU32(const unsigned char* p)
+{
+    unsigned int value;
+    memcpy(&value, p, sizeof(value)); // 文件里是小端, 和我们支持的平台一致
+    return value;
+}
+
+static unsigned int MakeFourCC(char a, char b, char c, char d)
+{
+    return (unsigned int)a | ((unsigned int)b << 8) | ((unsigned int)c << 16) | ((unsigned int)d << 24);
+}
+
+bool IsCompressedImagePath(const std::string& path)
+{
+    std::string ext = GetExtension(path);
+    return ext == "dds" || ext == "ktx";
+}
+
+unsigned int GetCompressedBlockSize(unsigned int internalFormat)
+{
+    switch (internalFormat)
+    {
+        // BC1 / BC4 / ETC2 RGB / EAC R11: 每块8字节
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RED_RGTC1:
+        case GL_COMPRESSED_SIGNED_RED_RGTC1:
+        case GL_COMPRESSED_RGB8_ETC2:
+        case GL_COMPRESSED_SRGB8_ETC2:
+        case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+        case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+        case GL_COMPRESSED_R11_EAC:
+        case GL_COMPRESSED_SIGNED_R11_EAC:
+            return 8;
+        // BC2 / BC3 / BC5 / BC7 / ETC2 RGBA / EAC RG11: 每块16字节
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_RG_RGTC2:
+        case GL_COMPRESSED_SIGNED_RG_RGTC2:
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+        case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+        case GL_COMPRESSED_RG11_EAC:
+        case GL_COMPRESSED_SIGNED_RG11_EAC:
+            return 16;
+    }
+    return 0;
+}
+
+bool IsCompressedFormatSupported(unsigned int internalFormat)
+{
+    switch (internalFormat)
+    {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+            return GLEW_EXT_texture_compression_s3tc;
+        case GL_COMPRESSED_RED_RGTC1:
+        case GL_COMPRESSED_SIGNED_RED_RGTC1:
+        case GL_COMPRESSED_RG_RGTC2:
+        case GL_COMPRESSED_SIGNED_RG_RGTC2:
+            return true; // GL 3.0 核心
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+            return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc;
+    }
+    // ETC2 / EAC: GL 4.3 核心或 ARB_ES3_compatibility
+    if (GetCompressedBlockSize(internalFormat) != 0)
+        return GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility;
+    return false;
+}
+
+// 用 64 位算, 宽高都接近 2^31 时 32 位会溢出
+static uint64_t GetLevelSize(unsigned int internalFormat, int width, int height)
+{
+    uint64_t blocksX = ((uint64_t)width + 3) / 4;
+    uint64_t blocksY = ((uint64_t)height + 3) / 4;
+    return blocksX * blocksY * GetCompressedBlockSize(internalFormat);
+}
+
+// 文件头里的宽高是 uint32, 为 0 或者转成 int 后为负的都是坏文件; 宽高都小于 2^31 时最多 32 级 mipmap
+static bool IsValidImageSize(unsigned int width, unsigned int height, unsigned int mipCount)
+{
+    return width > 0 && height > 0 && width <= INT_MAX && height <= INT_MAX && mipCount <= 32;
+}
+
+// ---------------- DDS ----------------
+
+static const unsigned int DDSPixelFormatFourCC = 0x4;
+
+// DX10 扩展头里的 DXGI_FORMAT
+static unsigned int DXGIFormatToGL(unsigned int dxgi)
+{
+    switch (dxgi)
+    {
+        case 71: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;       // BC1_UNORM
+        case 72: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT; // BC1_UNORM_SRGB
+        case 74: return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;       // BC2_UNORM
+        case 75: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT; // BC2_UNORM_SRGB
+        case 77: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;       // BC3_UNORM
+        case 78: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT; // BC3_UNORM_SRGB
+        case 80: return GL_COMPRESSED_RED_RGTC1;                // BC4_UNORM
+        case 81: return GL_COMPRESSED_SIGNED_RED_RGTC1;         // BC4_SNORM
+        case 83: return GL_COMPRESSED_RG_RGTC2;                 // BC5_UNORM
+        case 84: return GL_COMPRESSED_SIGNED_RG_RGTC2;          // BC5_SNORM
+        case 98: return GL_COMPRESSED_RGBA_BPTC_UNORM;          // BC7_UNORM
+        case 99: return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;    // BC7_UNORM_SRGB
+    }
+    return 0;
+}
+
+bool ParseDDS(const unsigned char* data, size_t size, CompressedImage& image)
+{
+    // "DDS " + 124 字节的 DDS_HEADER
+    if (size < 128 || memcmp(data, "DDS ", 4) != 0 || ReadU32(data + 4) != 124)
+        return false;
+
+    const unsigned char* header = data + 4;
+    unsigned int height = ReadU32(header + 8);
+    unsigned int width = ReadU32(header + 12);
+    unsigned int mipCount = ReadU32(header + 24);
+    const unsigned char* pixelFormat = header + 72; // DDS_PIXELFORMAT
+    unsigned int pfFlags = ReadU32(pixelFormat + 4);
+    unsigned int fourCC = ReadU32(pixelFormat + 8);
+
+    if (!(pfFlags & DDSPixelFormatFourCC))
+    {
+        std::cout << "Warning: DDS without FourCC (uncompressed) is not supported" << std::endl;
+        return false;
+    }
+
+    size_t offset = 128;
+    unsigned int format = 0;
+    if (fourCC == MakeFourCC('D', 'X', 'T', '1')) format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    else if (fourCC == MakeFourCC('D', 'X', 'T', '3')) format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+    else if (fourCC == MakeFourCC('D', 'X', 'T', '5')) format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    else if (fourCC == MakeFourCC('A', 'T', 'I', '1') || fourCC == MakeFourCC('B', 'C', '4', 'U')) format = GL_COMPRESSED_RED_RGTC1;
+    else if (fourCC == MakeFourCC('A', 'T', 'I', '2') || fourCC == MakeFourCC('B', 'C', '5', 'U')) format = GL_COMPRESSED_RG_RGTC2;
+    else if (fourCC == MakeFourCC('D', 'X', '1', '0'))
+    {
+        // DDS_HEADER_DXT10: dxgiFormat, resourceDimension, miscFlag, arraySize, miscFlags2
+        if (size < 148)
+            return false;
+        format = DXGIFormatToGL(ReadU32(data + 128));
+        offset = 148;
+    }
+
+    if (format == 0)
+    {
+        std::cout << "Warning: unsupported DDS pixel format" << std::endl;
+        return false;
+    }
+    if (!IsValidImageSize(width, height, mipCount))
+        return false;
+    if (mipCount == 0)
+        mipCount = 1;
+
+    // 所有级都校验通过才写进 image, 失败时 image 保持原样
+    std::vector<CompressedImage::Level> levels;
+    for (unsigned int i = 0; i < mipCount; i++)
+    {
+        int w = (int)width >> i; if (w < 1) w = 1;
+        int h = (int)height >> i; if (h < 1) h = 1;
+        uint64_t levelSize = GetLevelSize(format, w, h);
+        if (levelSize > size - offset)
+            return false;
+
+        CompressedImage::Level level;
+        level.Data = data + offset;
+        level.Size = (unsigned int)levelSize;
+        level.Width = w;
+        level.Height = h;
+        levels.push_back(level);
+        offset += (size_t)levelSize;
+    }
+
+    image.InternalFormat = format;
+    image.Width = (int)width;
+    image.Height = (int)height;
+    image.Levels = std::move(levels);
+    return true;
+}
+
+// ---------------- KTX 1.1 ----------------
+
+static const unsigned char s_KTXIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+bool ParseKTX(const unsigned char* data, size_t size, CompressedImage& image)
+{
+    // 12 字节标识 + 13 个 uint32 字段
+    if (size < 64 || memcmp(data, s_KTXIdentifier, 12) != 0)
+        return false;
+    if (ReadU32(data + 12) != 0x04030201)
+    {
+        std::cout << "Warning: big-endian KTX files are not supported" << std::endl;
+        return false;
+    }
+
+    unsigned int glType = ReadU32(data + 16);
+    unsigned int internalFormat = ReadU32(data + 28);
+    unsigned int width = ReadU32(data + 36);
+    unsigned int height = ReadU32(data + 40);
+    unsigned int depth = ReadU32(data + 44);
+    unsigned int arrayElements = ReadU32(data + 48);
+    unsigned int faces = ReadU32(data + 52);
+    unsigned int mipCount = ReadU32(data + 56);
+    unsigned int keyValueBytes = ReadU32(data + 60);
+
+    // glType 为 0 表示压缩格式; 只支持普通的 2D 纹理
+    if (glType != 0 || GetCompressedBlockSize(internalFormat) == 0)
+    {
+        std::cout << "Warning: KTX file is not in a supported compressed format" << std::endl;
+        return false;
+    }
+    if (depth > 1 || arrayElements > 0 || faces != 1)
+    {
+        std::cout << "Warning: only 2D KTX textures are supported" << std::endl;
+        return false;
+    }
+    if (!IsValidImageSize(width, height, mipCount) || keyValueBytes > size - 64)
+        return false;
+    if (mipCount == 0)
+        mipCount = 1;
+
+    // 所有级都校验通过才写进 image, 失败时 image 保持原样
+    std::vector<CompressedImage::Level> levels;
+    size_t offset = 64 + (size_t)keyValueBytes;
+    for (unsigned int i = 0; i < mipCount; i++)
+    {
+        if (offset > size || size - offset < 4)
+            return false;
+        unsigned int imageSize = ReadU32(data + offset);
+        offset += 4;
+
+        CompressedImage::Level level;
+        level.Width = (int)width >> i; if (level.Width < 1) level.Width = 1;
+        level.Height = (int)height >> i; if (level.Height < 1) level.Height = 1;
+        // imageSize 必须正好是这一级的块数据大小, 否则 glCompressedTexImage2D 会读越界或报错
+        if (imageSize != GetLevelSize(internalFormat, level.Width, level.Height) || imageSize > size - offset)
+            return false;
+        level.Data = data + offset;
+        level.Size = imageSize;
+        levels.push_back(level);
+
+        offset += ((size_t)imageSize + 3) & ~(size_t)3; // mipPadding: 4字节对齐
+    }
+
+    image.InternalFormat = internalFormat;
+    image.Width = (int)width;
+    image.Height = (int)height;
+    image.Levels = std::move(levels);
+    return true;
+}
+
+bool LoadCompressedImage(const std::string& path, CompressedImage& image)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream.is_open())
+    {
+        std::cout << "Warning: failed to open '" << path << "'" << std::endl;
+        return false;
+    }
+    image.Storage.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+
+    std::string ext = GetExtension(path);
+    bool ok = false;
+    if (ext == "dds")
+        ok = ParseDDS(image.Storage.data(), image.Storage.size(), image);
+    else if (ext == "ktx")
+        ok = ParseKTX(image.Storage.data(), image.Storage.size(), image);
+
+    if (!ok)
+        std::cout << "Warning: failed to parse compressed image '" << path << "'" << std::endl;
+    return ok;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * 预压缩的GPU纹理 (DDS / KTX1 文件里的 BCn / ETC2 数据)。
+ *      解析只做校验和定位, 每一级 mipmap 直接指向原始数据, 不解压也不拷贝,
+ *      之后用 glCompressedTexImage2D 原样上传。
+ * 注意: DDS/KTX 的第一行像素在图片顶部, 而我们 stb_image 加载时会上下翻转,
+ *      压缩数据没法在加载时翻转, 所以这些文件要在制作时就先翻转好 (AssetCooker 会这样做)。
+ */
+struct CompressedImage
+{
+	struct Level
+	{
+		const unsigned char* Data = nullptr;
+		unsigned int Size = 0;
+		int Width = 0, Height = 0;
+	};
+
+	unsigned int InternalFormat = 0; // GL_COMPRESSED_*
+	int Width = 0, Height = 0;
+	std::vector<Level> Levels;        // 第0级是原图, 之后每级尺寸减半
+	std::vector<unsigned char> Storage; // 从文件加载时持有数据; 从内存解析时为空, Level 指向调用者的内存
+};
+
+// 文件扩展名是 .dds 或 .ktx
+bool IsCompressedImagePath(const std::string& path);
+// 按扩展名读取并解析 DDS / KTX 文件
+bool LoadCompressedImage(const std::string& path, CompressedImage& image);
+// 解析内存里的文件内容, data 必须比 image 活得久
+bool ParseDDS(const unsigned char* data, size_t size, CompressedImage& image);
+bool ParseKTX(const unsigned char* data, size_t size, CompressedImage& image);
+
+// 压缩格式每个 4x4 块的字节数, 不认识的格式返回 0
+unsigned int GetCompressedBlockSize(unsigned int internalFormat);
+// 当前驱动能否直接使用这个压缩格式
+bool IsCompressedFormatSupported(unsigned int internalFormat);
@@ -0,0 +1,72 @@
+#include "DrawCommandBuffer.h"
+
+#include "Render.h"
+
+static bool IsModeSupported(DrawCommandBuffer::SubmitMode mode)
+{
+    switch (mode)
+    {
+        case DrawCommandBuffer::SubmitMode::MultiDrawIndirect: return GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect;
+        case DrawCommandBuffer::SubmitMode::DrawIndirect: return GLEW_VERSION_4_0 || GLEW_ARB_draw_indirect;
+        case DrawCommandBuffer::SubmitMode::Direct: return true;
+    }
+    return false;
+}
+
+DrawCommandBuffer::DrawCommandBuffer(unsigned int maxCommands)
+    : m_MaxCommands(maxCommands), m_Mode(SubmitMode::Direct)
+{
+    m_Commands.reserve(maxCommands);
+    SetSubmitMode(GetBestSupportedMode());
+}
+
+DrawCommandBuffer::~DrawCommandBuffer()
+{
+}
+
+DrawCommandBuffer::SubmitMode DrawCommandBuffer::GetBestSupportedMode()
+{
+    if (IsModeSupported(SubmitMode::MultiDrawIndirect))
+        return SubmitMode::MultiDrawIndirect;
+    if (IsModeSupported(SubmitMode::DrawIndirect))
+        return SubmitMode::DrawIndirect;
+    return SubmitMode::Direct;
+}
+
+DrawCommandBuffer::SubmitMode DrawCommandBuffer::SetSubmitMode(SubmitMode mode)
+{
+    if (!IsModeSupported(mode))
+        mode = GetBestSupportedMode();
+    m_Mode = mode;
+
+    if (m_Mode != SubmitMode::Direct && !m_Buffer)
+        m_Buffer = std::make_unique<StreamBuffer>(GL_DRAW_INDIRECT_BUFFER, m_MaxCommands * (unsigned int)sizeof(DrawElementsIndirectCommand));
+    return m_Mode;
+}
+
+void DrawCommandBuffer::Clear()
+{
+    m_Commands.clear();
+}
+
+bool DrawCommandBuffer::Add(const MeshAllocation& mesh, unsigned int instanceCount, unsigned int baseInstance)
+{
+    return Add({ mesh.IndexCount, instanceCount, mesh.FirstIndex, mesh.BaseVertex, baseInstance });
+}
+
+bool DrawCommandBuffer::Add(const DrawElementsIndirectCommand& command)
+{
+    if (m_Commands.size() >= m_MaxCommands)
+        return false;
+    m_Commands.push_back(command);
+    return true;
+}
+
+unsigned int DrawCommandBuffer::Upload()
+{
+    if (m_Mode == SubmitMode::Direct || m_Commands.empty())
+        return 0;
+    unsigned int offset = m_Buffer->SetData(m_Commands.data(), GetCount() * (unsigned int)sizeof(DrawElementsIndirectCommand));
+    m_Buffer->Bind();
+    return offset;
+}
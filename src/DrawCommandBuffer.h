@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "StreamBuffer.h"
+#include "GeometryPool.h"
+
+// glDrawElementsIndirect / glMultiDrawElementsIndirect 规定的命令格式, 字段顺序不能改
+struct DrawElementsIndirectCommand
+{
+	unsigned int Count;
+	unsigned int InstanceCount;
+	unsigned int FirstIndex;
+	int BaseVertex;
+	unsigned int BaseInstance; // GL 4.2 之前必须为 0
+};
+
+/**
+ * 间接绘制命令缓冲:
+ *      每个 Add 只是往CPU端的数组里追加一条命令, Renderer::DrawIndirect 时一次上传到 GL_DRAW_INDIRECT_BUFFER,
+ *      然后一次 glMultiDrawElementsIndirect 画完所有命令, 不管有多少个不同的网格。
+ *      命令里的索引/顶点位置来自同一个 GeometryPool。
+ * 按驱动能力逐级退回:
+ *      GL 4.3 / ARB_multi_draw_indirect: 一次 glMultiDrawElementsIndirect
+ *      GL 4.0 / ARB_draw_indirect:       每条命令一次 glDrawElementsIndirect (命令还是在GPU缓冲里)
+ *      都不支持:                          每条命令一次 glDrawElementsInstancedBaseVertex(BaseInstance)
+ */
+class DrawCommandBuffer
+{
+public:
+	enum class SubmitMode
+	{
+		MultiDrawIndirect, DrawIndirect, Direct
+	};
+
+private:
+	std::vector<DrawElementsIndirectCommand> m_Commands;
+	std::unique_ptr<StreamBuffer> m_Buffer; // 只有间接模式才创建
+	unsigned int m_MaxCommands;
+	SubmitMode m_Mode;
+
+public:
+	DrawCommandBuffer(unsigned int maxCommands = 4096);
+	~DrawCommandBuffer();
+
+	void Clear();
+	// 命令数达到上限时返回 false, 需要先提交再继续
+	bool Add(const MeshAllocation& mesh, unsigned int instanceCount = 1, unsigned int baseInstance = 0);
+	bool Add(const DrawElementsIndirectCommand& command);
+
+	// 只能选驱动支持的模式, 不支持时退回到能用的最好的模式; 返回实际使用的模式
+	SubmitMode SetSubmitMode(SubmitMode mode);
+	inline SubmitMode GetSubmitMode() const { return m_Mode; }
+	static SubmitMode GetBestSupportedMode();
+
+	// 把命令写进间接绘制缓冲并绑定, 返回命令在缓冲里的字节偏移 (Direct 模式下不上传, 返回0)
+	unsigned int Upload();
+
+	inline const std::vector<DrawElementsIndirectCommand>& GetCommands() const { return m_Commands; }
+	inline unsigned int GetCount() const { return (unsigned int)m_Commands.size(); }
+	inline unsigned int GetMaxCommands() const { return m_MaxCommands; }
+};
@@ -0,0 +1,14 @@
+#include "DynamicIndexBuffer.h"
+
+#include "Render.h"
+
+DynamicIndexBuffer::DynamicIndexBuffer(unsigned int maxCount, Mode mode)
+    : StreamBuffer(GL_ELEMENT_ARRAY_BUFFER, maxCount * sizeof(unsigned int), mode), m_Count(0)
+{
+}
+
+unsigned int DynamicIndexBuffer::SetData(const unsigned int* data, unsigned int count)
+{
+    m_Count = count;
+    return StreamBuffer::SetData(data, count * sizeof(unsigned int));
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "StreamBuffer.h"
+
+// 每帧更新的索引缓冲, 见 StreamBuffer
+class DynamicIndexBuffer : public StreamBuffer
+{
+private:
+	unsigned int m_Count; // 最近一次 SetData 写入的索引个数
+
+public:
+	DynamicIndexBuffer(unsigned int maxCount, Mode mode = Mode::Persistent);
+
+	// 返回字节偏移, 画的时候作为 glDrawElements 的 indices 参数
+	unsigned int SetData(const unsigned int* data, unsigned int count);
+
+	inline unsigned int GetCount() const { return m_Count; }
+};
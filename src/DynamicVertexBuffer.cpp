@@ -0,0 +1,8 @@
+#include "DynamicVertexBuffer.h"
+
+#include "Render.h"
+
+DynamicVertexBuffer::DynamicVertexBuffer(unsigned int size, Mode mode)
+    : StreamBuffer(GL_ARRAY_BUFFER, size, mode)
+{
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "StreamBuffer.h"
+
+// 每帧更新的顶点缓冲, 见 StreamBuffer
+class DynamicVertexBuffer : public StreamBuffer
+{
+public:
+	DynamicVertexBuffer(unsigned int size, Mode mode = Mode::Persistent);
+};
@@ -0,0 +1,154 @@
+#include "FileWatcher.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+static std::string NormalizePath(const std::string& path)
+{
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(path, error);
+    if (error)
+        absolute = path;
+    return absolute.lexically_normal().string();
+}
+
+static std::filesystem::file_time_type GetLastWriteTime(const std::string& path)
+{
+    std::error_code error;
+    std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+    return error ? std::filesystem::file_time_type::min() : time;
+}
+
+FileWatcher::FileWatcher(Callback callback, unsigned int pollInterval)
+    : m_Callback(std::move(callback)), m_PollInterval(pollInterval), m_Inotify(-1), m_Running(true)
+{
+#ifdef __linux__
+    m_Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_Inotify == -1)
+        std::cout << "Warning: inotify unavailable, falling back to polling file timestamps" << std::endl;
+#endif
+    m_Thread = std::thread(&FileWatcher::Run, this);
+}
+
+FileWatcher::~FileWatcher()
+{
+    m_Running = false;
+    m_Thread.join();
+#ifdef __linux__
+    if (m_Inotify != -1)
+        close(m_Inotify); // 关闭后所有 watch descriptor 自动移除
+#endif
+}
+
+void FileWatcher::Watch(const std::string& path)
+{
+    std::string normalized = NormalizePath(path);
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Files.find(normalized) != m_Files.end())
+        return;
+    m_Files[normalized] = { path, GetLastWriteTime(path) };
+
+#ifdef __linux__
+    if (m_Inotify == -1)
+        return;
+    std::string directory = std::filesystem::path(normalized).parent_path().string();
+    if (m_DirectoryWatches.find(directory) != m_DirectoryWatches.end())
+        return;
+    int wd = inotify_add_watch(m_Inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd == -1)
+    {
+        std::cout << "Warning: failed to watch directory '" << directory << "'" << std::endl;
+        return;
+    }
+    m_Directories[wd] = directory;
+    m_DirectoryWatches[directory] = wd;
+#endif
+}
+
+void FileWatcher::Unwatch(const std::string& path)
+{
+    // 目录的 watch 留着, 同目录下别的文件可能还要用, 没有被监视的文件的事件会被忽略
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Files.erase(NormalizePath(path));
+}
+
+void FileWatcher::Run()
+{
+    while (m_Running.load())
+    {
+        if (m_Inotify != -1)
+            ReadEvents();
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(m_PollInterval));
+            PollTimestamps();
+        }
+    }
+}
+
+void FileWatcher::ReadEvents()
+{
+#ifdef __linux__
+    // 超时返回是为了能定期检查 m_Running
+    pollfd pfd = { m_Inotify, POLLIN, 0 };
+    if (poll(&pfd, 1, (int)m_PollInterval) <= 0)
+        return;
+
+    alignas(inotify_event) char buffer[4096];
+    std::vector<std::string> changed;
+    ssize_t length;
+    while ((length = read(m_Inotify, buffer, sizeof(buffer))) > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (char* p = buffer; p < buffer + length; )
+        {
+            const inotify_event* event = (const inotify_event*)p;
+            p += sizeof(inotify_event) + event->len;
+
+            auto directory = m_Directories.find(event->wd);
+            if (event->len == 0 || directory == m_Directories.end())
+                continue;
+            auto file = m_Files.find(directory->second + "/" + event->name);
+            if (file == m_Files.end())
+                continue;
+            // 一次保存可能产生好几个事件, 同一批里只通知一次
+            bool duplicate = false;
+            for (const std::string& path : changed)
+                duplicate |= path == file->second.Path;
+            if (!duplicate)
+                changed.push_back(file->second.Path);
+        }
+    }
+
+    // 回调在锁外调用, 回调里可以再调用 Watch/Unwatch
+    for (const std::string& path : changed)
+        m_Callback(path);
+#endif
+}
+
+void FileWatcher::PollTimestamps()
+{
+    std::vector<std::string> changed;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (auto& [normalized, file] : m_Files)
+        {
+            std::filesystem::file_time_type time = GetLastWriteTime(normalized);
+            if (time != file.LastWriteTime)
+            {
+                file.LastWriteTime = time;
+                changed.push_back(file.Path);
+            }
+        }
+    }
+
+    for (const std::string& path : changed)
+        m_Callback(path);
+}
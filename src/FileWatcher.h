@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * 文件监视:
+ *      后台线程监视一组文件, 文件被改写后在这个后台线程里调用回调 (参数是 Watch 时传入的原始路径)。
+ *      Linux 下用 inotify 监视文件所在的目录 (编辑器保存时经常是 "写临时文件再 rename",
+ *      直接监视文件本身会在第一次保存后失效), 只关心 IN_CLOSE_WRITE / IN_MOVED_TO, 不会读到写了一半的文件。
+ *      其他平台或 inotify 不可用时, 退回到每隔 pollInterval 毫秒比较一次修改时间。
+ */
+class FileWatcher
+{
+public:
+	using Callback = std::function<void(const std::string& path)>;
+
+private:
+	struct WatchedFile
+	{
+		std::string Path; // Watch 时传入的路径, 回调时原样返回
+		std::filesystem::file_time_type LastWriteTime; // 只有轮询模式用到
+	};
+
+	Callback m_Callback;
+	unsigned int m_PollInterval;
+
+	std::mutex m_Mutex; // 保护下面几个表, Watch/Unwatch 和后台线程会同时访问
+	std::unordered_map<std::string, WatchedFile> m_Files; // 规范化后的路径 -> 文件
+	std::unordered_map<int, std::string> m_Directories;   // inotify watch descriptor -> 目录
+	std::unordered_map<std::string, int> m_DirectoryWatches;
+
+	int m_Inotify; // -1 表示用轮询
+	std::atomic<bool> m_Running;
+	std::thread m_Thread;
+
+public:
+	FileWatcher(Callback callback, unsigned int pollInterval = 250);
+	~FileWatcher();
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	void Watch(const std::string& path);
+	void Unwatch(const std::string& path);
+
+	inline bool IsUsingInotify() const { return m_Inotify != -1; }
+
+private:
+	void Run();
+	void ReadEvents();
+	void PollTimestamps();
+};
@@ -0,0 +1,223 @@
+#include "FrameLoop.h"
+
+#include <algorithm>
+#include <cmath>
+#include <GLFW/glfw3.h>
+
+#include "Profiler.h"
+#include "vendor/imgui/imgui.h"
+
+// 卡顿 (比如拖动窗口、断点) 之后最多补这么多时间, 再多就直接丢掉
+static const float s_MaxFrameDelta = 0.25f;
+
+// 构造和 SetSettings 都经过这里: 步长太小会让一帧补几万步, 目标帧率为0会除以0
+static FrameLoopSettings SanitizeSettings(FrameLoopSettings settings)
+{
+    settings.TargetFPS = std::max(settings.TargetFPS, 1.0f);
+    settings.FixedDeltaTime = std::max(settings.FixedDeltaTime, 0.001f);
+    return settings;
+}
+
+FrameLoop::FrameLoop(GLFWwindow* window, const FrameLoopSettings& settings)
+    : m_Window(window), m_Settings(SanitizeSettings(settings)), m_SwapInterval(-1), m_DeltaTime(0.0f), m_Accumulator(0.0f),
+    m_StepsThisFrame(0), m_FrameTimes{}, m_FrameIndex(0), m_Test(nullptr), m_SimulationRunning(false),
+    m_LastStepTime(0), m_SimulationSteps(0)
+{
+    m_FrameStart = m_LastFrameStart = Clock::now();
+    ApplySwapInterval();
+    if (m_Settings.FixedTimestep && m_Settings.SimulationThread)
+        StartSimulationThread();
+}
+
+FrameLoop::~FrameLoop()
+{
+    StopSimulationThread();
+}
+
+void FrameLoop::SetSettings(const FrameLoopSettings& settings)
+{
+    FrameLoopSettings sanitized = SanitizeSettings(settings);
+    bool wasThreaded = m_SimulationRunning.load();
+    bool threaded = sanitized.FixedTimestep && sanitized.SimulationThread;
+    if (wasThreaded && (!threaded || sanitized.FixedDeltaTime != m_Settings.FixedDeltaTime))
+        StopSimulationThread();
+
+    m_Settings = sanitized;
+    ApplySwapInterval();
+
+    if (threaded && !m_SimulationRunning.load())
+    {
+        m_Accumulator = 0.0f;
+        StartSimulationThread();
+    }
+}
+
+void FrameLoop::ApplySwapInterval()
+{
+    int interval = m_Settings.Pacing == FramePacing::VSync ? 1 : 0;
+    // 无窗口模式没有交换链
+    if (!m_Window || interval == m_SwapInterval)
+        return;
+    glfwSwapInterval(interval);
+    m_SwapInterval = interval;
+}
+
+float FrameLoop::BeginFrame()
+{
+    m_LastFrameStart = m_FrameStart;
+    m_FrameStart = Clock::now();
+    m_DeltaTime = std::chrono::duration<float>(m_FrameStart - m_LastFrameStart).count();
+
+    m_FrameTimes[m_FrameIndex] = m_DeltaTime * 1000.0f;
+    m_FrameIndex = (m_FrameIndex + 1) % HistorySize;
+    return m_DeltaTime;
+}
+
+void FrameLoop::Update(test::Test* test)
+{
+    PROFILE_SCOPE("FrameLoop::Update");
+    m_Test = test;
+    m_StepsThisFrame = 0;
+    if (!test)
+        return;
+
+    if (!m_Settings.FixedTimestep)
+    {
+        test->OnUpdate(m_DeltaTime);
+        return;
+    }
+
+    float step = m_Settings.FixedDeltaTime;
+    if (m_SimulationRunning.load())
+    {
+        // 模拟线程自己在走, 这里只根据上一步完成到现在过了多久算插值系数
+        Clock::time_point lastStep(Clock::duration(m_LastStepTime.load()));
+        float sinceStep = std::chrono::duration<float>(Clock::now() - lastStep).count();
+        test->OnInterpolate(std::clamp(sinceStep / step, 0.0f, 1.0f));
+        return;
+    }
+
+    m_Accumulator += std::min(m_DeltaTime, s_MaxFrameDelta);
+    while (m_Accumulator >= step && m_StepsThisFrame < m_Settings.MaxStepsPerFrame)
+    {
+        test->OnFixedUpdate(step);
+        m_Accumulator -= step;
+        m_StepsThisFrame++;
+    }
+    // 追不上了就丢掉多出来的时间, 模拟变慢但不会越来越卡
+    if (m_Accumulator >= step)
+        m_Accumulator = std::fmod(m_Accumulator, step);
+
+    test->OnInterpolate(m_Accumulator / step);
+}
+
+void FrameLoop::EndFrame()
+{
+    if (m_Settings.Pacing != FramePacing::TargetFPS)
+        return;
+
+    PROFILE_SCOPE("FrameLoop::Wait");
+    // sleep 的精度只有毫秒级 (有的系统更差), 先睡到差 1ms, 剩下的忙等
+    Clock::time_point deadline = m_FrameStart + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float>(1.0f / m_Settings.TargetFPS));
+    Clock::time_point coarse = deadline - std::chrono::milliseconds(1);
+    if (Clock::now() < coarse)
+        std::this_thread::sleep_until(coarse);
+    while (Clock::now() < deadline)
+        std::this_thread::yield();
+}
+
+float FrameLoop::GetAverageFrameTime() const
+{
+    float sum = 0.0f;
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < HistorySize; i++)
+    {
+        if (m_FrameTimes[i] > 0.0f)
+        {
+            sum += m_FrameTimes[i];
+            count++;
+        }
+    }
+    return count ? sum / count : 0.0f;
+}
+
+void FrameLoop::StartSimulationThread()
+{
+    m_LastStepTime = Clock::now().time_since_epoch().count();
+    m_SimulationRunning = true;
+    m_SimulationThread = std::thread(&FrameLoop::SimulationLoop, this, m_Settings.FixedDeltaTime);
+}
+
+void FrameLoop::StopSimulationThread()
+{
+    if (!m_SimulationThread.joinable())
+        return;
+    m_SimulationRunning = false;
+    m_SimulationThread.join();
+}
+
+void FrameLoop::SimulationLoop(float fixedDeltaTime)
+{
+    Clock::duration step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(fixedDeltaTime));
+    Clock::time_point next = Clock::now();
+    while (m_SimulationRunning.load())
+    {
+        next += step;
+        std::this_thread::sleep_until(next);
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            PROFILE_SCOPE("FrameLoop::FixedUpdate");
+            if (m_Test)
+                m_Test->OnFixedUpdate(fixedDeltaTime);
+        }
+        Clock::time_point now = Clock::now();
+        m_LastStepTime = now.time_since_epoch().count();
+        m_SimulationSteps++;
+
+        // 落后太多时不再补, 从现在重新开始计时
+        if (now - next > std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(s_MaxFrameDelta)))
+            next = now;
+    }
+}
+
+void FrameLoop::OnImGuiRender()
+{
+    FrameLoopSettings settings = m_Settings;
+    bool changed = false;
+
+    ImGui::Begin("Frame Loop");
+    const char* pacing[] = { "VSync", "Uncapped", "Target FPS" };
+    int pacingIndex = (int)settings.Pacing;
+    if (ImGui::Combo("Pacing", &pacingIndex, pacing, 3))
+    {
+        settings.Pacing = (FramePacing)pacingIndex;
+        changed = true;
+    }
+    if (settings.Pacing == FramePacing::TargetFPS)
+        changed |= ImGui::SliderFloat("Target FPS", &settings.TargetFPS, 10.0f, 500.0f, "%.0f");
+
+    changed |= ImGui::Checkbox("Fixed timestep", &settings.FixedTimestep);
+    if (settings.FixedTimestep)
+    {
+        float rate = 1.0f / settings.FixedDeltaTime;
+        if (ImGui::SliderFloat("Simulation Hz", &rate, 10.0f, 240.0f, "%.0f"))
+        {
+            settings.FixedDeltaTime = 1.0f / rate;
+            changed = true;
+        }
+        changed |= ImGui::Checkbox("Simulation thread", &settings.SimulationThread);
+    }
+
+    float average = GetAverageFrameTime();
+    ImGui::Text("Frame time: %.3f ms (avg %.3f ms, %.1f FPS)", m_DeltaTime * 1000.0f, average, average > 0.0f ? 1000.0f / average : 0.0f);
+    if (m_SimulationRunning.load())
+        ImGui::Text("Simulation steps: %u (threaded)", m_SimulationSteps.load());
+    else if (settings.FixedTimestep)
+        ImGui::Text("Simulation steps this frame: %u", m_StepsThisFrame);
+    ImGui::PlotLines("##FrameTimes", m_FrameTimes, HistorySize, m_FrameIndex, "frame ms", 0.0f, average * 3.0f + 1.0f, ImVec2(0, 60));
+    ImGui::End();
+
+    if (changed)
+        SetSettings(settings);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "tests/Test.h"
+
+struct GLFWwindow;
+
+enum class FramePacing
+{
+	VSync,     // glfwSwapInterval(1), 帧率跟着显示器刷新率
+	Uncapped,  // 不等垂直同步, 能跑多快跑多快 (测吞吐量用)
+	TargetFPS  // 不等垂直同步, CPU 自己睡到下一帧的时间点
+};
+
+struct FrameLoopSettings
+{
+	FramePacing Pacing = FramePacing::VSync;
+	float TargetFPS = 60.0f;
+	// 固定步长: 模拟按 FixedDeltaTime 前进, 渲染时用 OnInterpolate 在最近两步之间插值
+	bool FixedTimestep = false;
+	float FixedDeltaTime = 1.0f / 60.0f;
+	unsigned int MaxStepsPerFrame = 8; // 一帧最多补几步, 防止卡顿后越追越慢
+	// 固定步长的模拟放到单独的线程里跑 (只在 FixedTimestep 时有效)
+	bool SimulationThread = false;
+};
+
+/**
+ * 帧循环:
+ *      BeginFrame 测量真实的 deltaTime, Update 按设置调用 Test 的 OnUpdate 或 OnFixedUpdate + OnInterpolate,
+ *      EndFrame 在 TargetFPS 模式下睡到下一帧的时间点。
+ *      打开模拟线程后, OnFixedUpdate 在模拟线程里按固定频率调用, 和渲染线程用 GetMutex() 互斥:
+ *      渲染线程在调用 Test 的 OnInterpolate / OnRender / OnImGuiRender 期间要持有这把锁, 切换 Test 也要在锁内,
+ *      交换缓冲、等垂直同步、ImGui 提交这些不碰 Test 的工作不用加锁, 和模拟并行。
+ *      模拟线程里不能调用GL和ImGui。
+ */
+class FrameLoop
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static const unsigned int HistorySize = 240;
+
+private:
+	GLFWwindow* m_Window;
+	FrameLoopSettings m_Settings;
+	int m_SwapInterval; // 当前设置的交换间隔, -1 表示还没设置过
+
+	Clock::time_point m_FrameStart;
+	Clock::time_point m_LastFrameStart;
+	float m_DeltaTime;
+	float m_Accumulator;
+	unsigned int m_StepsThisFrame;
+
+	// 最近几帧的帧间隔 (毫秒), 环形数组
+	float m_FrameTimes[HistorySize];
+	unsigned int m_FrameIndex;
+
+	// 模拟线程
+	std::mutex m_Mutex;
+	test::Test* m_Test; // 受 m_Mutex 保护
+	std::thread m_SimulationThread;
+	std::atomic<bool> m_SimulationRunning;
+	std::atomic<long long> m_LastStepTime; // 上一步完成的时间 (Clock 的 tick 数), 渲染线程用它算插值系数
+	std::atomic<unsigned int> m_SimulationSteps;
+
+public:
+	// window 为空时 (无窗口模式) 不设置交换间隔, VSync 等同于 Uncapped
+	FrameLoop(GLFWwindow* window, const FrameLoopSettings& settings = FrameLoopSettings());
+	~FrameLoop();
+
+	FrameLoop(const FrameLoop&) = delete;
+	FrameLoop& operator=(const FrameLoop&) = delete;
+
+	void SetSettings(const FrameLoopSettings& settings);
+	inline const FrameLoopSettings& GetSettings() const { return m_Settings; }
+
+	// 每帧开始时调用, 返回距离上一帧开始的真实时间 (秒)
+	float BeginFrame();
+	// 推进 test 的模拟, 调用者要持有 GetMutex(); 同时把 test 设为模拟线程的目标
+	void Update(test::Test* test);
+	// 切换了 Test 之后告诉模拟线程, 调用者要持有 GetMutex()
+	inline void SetTest(test::Test* test) { m_Test = test; }
+	// 交换缓冲之后调用
+	void EndFrame();
+
+	inline std::mutex& GetMutex() { return m_Mutex; }
+
+	inline float GetDeltaTime() const { return m_DeltaTime; }
+	inline unsigned int GetStepsThisFrame() const { return m_StepsThisFrame; }
+	// 平均帧间隔 (毫秒), 取最近 HistorySize 帧
+	float GetAverageFrameTime() const;
+
+	// 帧间隔曲线和设置面板; 可能会停止模拟线程, 不能在持有 GetMutex() 时调用
+	void OnImGuiRender();
+
+private:
+	void ApplySwapInterval();
+	void StartSimulationThread();
+	void StopSimulationThread();
+	// 步长在启动时确定, 改步长要重启线程
+	void SimulationLoop(float fixedDeltaTime);
+};
@@ -0,0 +1,203 @@
+#include "Framebuffer.h"
+
+#include <algorithm>
+
+#include "Render.h"
+#include "GLState.h"
+
+static GLenum GetInternalFormat(FramebufferColorFormat format)
+{
+    return format == FramebufferColorFormat::RGBA16F ? GL_RGBA16F : GL_RGBA8;
+}
+
+static FramebufferSpec MakeSpec(int width, int height)
+{
+    FramebufferSpec spec;
+    spec.Width = width;
+    spec.Height = height;
+    return spec;
+}
+
+Framebuffer::Framebuffer(const FramebufferSpec& spec)
+    : m_Spec(spec), m_RendererID(0), m_ColorAttachment(0), m_MultisampleColor(0), m_DepthAttachment(0), m_ResolveID(0),
+    m_MaxSamples(1), m_Complete(false), m_PreviousFramebuffer(0), m_PreviousViewport{}, m_NeedsResolve(false)
+{
+    GLint maxSamples = 1;
+    GLCall(glGetIntegerv(GL_MAX_SAMPLES, &maxSamples));
+    m_MaxSamples = (unsigned int)std::max(maxSamples, 1);
+    Create();
+}
+
+Framebuffer::Framebuffer(int width, int height)
+    : Framebuffer(MakeSpec(width, height))
+{
+}
+
+Framebuffer::~Framebuffer()
+{
+    Destroy();
+}
+
+void Framebuffer::Create()
+{
+    m_Spec.Width = std::max(m_Spec.Width, 1);
+    m_Spec.Height = std::max(m_Spec.Height, 1);
+    m_Spec.Samples = std::min(std::max(m_Spec.Samples, 1u), m_MaxSamples);
+    bool multisample = m_Spec.Samples > 1;
+    GLenum internalFormat = GetInternalFormat(m_Spec.ColorFormat);
+
+    // Resize / SetSamples 可能在绘制中途调用, 结束后恢复调用者绑定的帧缓冲 (和 Resolve 一样)
+    GLint previousFramebuffer = 0;
+    GLCall(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer));
+
+    // 单采样时直接画在这张纹理上, 多重采样时它是解析的目标
+    GLCall(glGenTextures(1, &m_ColorAttachment));
+    GLState::BindTexture(m_ColorAttachment);
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_Spec.Width, m_Spec.Height, 0, GL_RGBA,
+        m_Spec.ColorFormat == FramebufferColorFormat::RGBA16F ? GL_FLOAT : GL_UNSIGNED_BYTE, nullptr));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    GLState::BindTexture(0);
+
+    if (multisample)
+    {
+        GLCall(glGenRenderbuffers(1, &m_MultisampleColor));
+        GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_MultisampleColor));
+        GLCall(glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_Spec.Samples, internalFormat, m_Spec.Width, m_Spec.Height));
+    }
+    if (m_Spec.DepthStencil)
+    {
+        // 深度只在绘制时用, 不需要采样, 渲染缓冲比纹理省事
+        GLCall(glGenRenderbuffers(1, &m_DepthAttachment));
+        GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment));
+        if (multisample)
+        {
+            GLCall(glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_Spec.Samples, GL_DEPTH24_STENCIL8, m_Spec.Width, m_Spec.Height));
+        }
+        else
+        {
+            GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Spec.Width, m_Spec.Height));
+        }
+    }
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+    GLCall(glGenFramebuffers(1, &m_RendererID));
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+    if (multisample)
+    {
+        GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_MultisampleColor));
+    }
+    else
+    {
+        GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ColorAttachment, 0));
+    }
+    if (m_DepthAttachment)
+    {
+        GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthAttachment));
+    }
+    m_Complete = CheckStatus(m_RendererID);
+
+    if (multisample)
+    {
+        GLCall(glGenFramebuffers(1, &m_ResolveID));
+        GLState::BindFramebuffer(GL_FRAMEBUFFER, m_ResolveID);
+        GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ColorAttachment, 0));
+        m_Complete = CheckStatus(m_ResolveID) && m_Complete;
+    }
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, (unsigned int)previousFramebuffer);
+
+    if (!m_Complete)
+        std::cout << "Warning: framebuffer " << m_Spec.Width << "x" << m_Spec.Height << " (" << m_Spec.Samples << " samples) is incomplete" << std::endl;
+    m_NeedsResolve = false;
+}
+
+void Framebuffer::Destroy()
+{
+    GLState::OnFramebufferDeleted(m_RendererID);
+    GLCall(glDeleteFramebuffers(1, &m_RendererID));
+    if (m_ResolveID)
+    {
+        GLState::OnFramebufferDeleted(m_ResolveID);
+        GLCall(glDeleteFramebuffers(1, &m_ResolveID));
+    }
+    if (m_MultisampleColor)
+    {
+        GLCall(glDeleteRenderbuffers(1, &m_MultisampleColor));
+    }
+    if (m_DepthAttachment)
+    {
+        GLCall(glDeleteRenderbuffers(1, &m_DepthAttachment));
+    }
+    GLState::OnTextureDeleted(m_ColorAttachment);
+    GLCall(glDeleteTextures(1, &m_ColorAttachment));
+    m_RendererID = m_ResolveID = m_MultisampleColor = m_DepthAttachment = m_ColorAttachment = 0;
+}
+
+bool Framebuffer::CheckStatus(unsigned int framebuffer) const
+{
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    GLenum status;
+    GLCall(status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    return status == GL_FRAMEBUFFER_COMPLETE;
+}
+
+void Framebuffer::Bind() const
+{
+    // 查询状态不会等GPU, 只是读驱动里记录的值
+    GLCall(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_PreviousFramebuffer));
+    GLCall(glGetIntegerv(GL_VIEWPORT, m_PreviousViewport));
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+    GLCall(glViewport(0, 0, m_Spec.Width, m_Spec.Height));
+    m_NeedsResolve = m_ResolveID != 0;
+}
+
+void Framebuffer::Unbind() const
+{
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, (unsigned int)m_PreviousFramebuffer);
+    GLCall(glViewport(m_PreviousViewport[0], m_PreviousViewport[1], m_PreviousViewport[2], m_PreviousViewport[3]));
+}
+
+void Framebuffer::Resolve() const
+{
+    if (!m_NeedsResolve)
+        return;
+    m_NeedsResolve = false;
+
+    // 改了读/写绑定, 结束后恢复成 GL_FRAMEBUFFER 上原来的 (绘制时一般还绑着自己)
+    GLint drawFramebuffer = 0;
+    GLCall(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer));
+    GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID);
+    GLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, m_ResolveID);
+    GLCall(glBlitFramebuffer(0, 0, m_Spec.Width, m_Spec.Height, 0, 0, m_Spec.Width, m_Spec.Height, GL_COLOR_BUFFER_BIT, GL_NEAREST));
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, (unsigned int)drawFramebuffer);
+}
+
+void Framebuffer::Resize(int width, int height)
+{
+    width = std::max(width, 1);
+    height = std::max(height, 1);
+    if (width == m_Spec.Width && height == m_Spec.Height)
+        return;
+    Destroy();
+    m_Spec.Width = width;
+    m_Spec.Height = height;
+    Create();
+}
+
+void Framebuffer::SetSamples(unsigned int samples)
+{
+    samples = std::min(std::max(samples, 1u), m_MaxSamples);
+    if (samples == m_Spec.Samples)
+        return;
+    Destroy();
+    m_Spec.Samples = samples;
+    Create();
+}
+
+void Framebuffer::BindColorAttachment(unsigned int slot) const
+{
+    Resolve();
+    GLState::BindTexture(slot, m_ColorAttachment);
+}
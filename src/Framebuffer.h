@@ -0,0 +1,82 @@
+#pragma once
+
+enum class FramebufferColorFormat
+{
+	RGBA8,  // 普通的 8 位颜色
+	RGBA16F // 半精度浮点, 后处理 (比如 HDR) 时不会被截断到 0-1
+};
+
+struct FramebufferSpec
+{
+	int Width = 0, Height = 0;
+	unsigned int Samples = 1; // > 1 时多重采样, 用之前要 Resolve 到普通纹理
+	FramebufferColorFormat ColorFormat = FramebufferColorFormat::RGBA8;
+	bool DepthStencil = true; // 24位深度 + 8位模板
+};
+
+/**
+ * 帧缓冲对象 (FBO):
+ *      一个颜色附件加一个可选的深度/模板附件, 绑定之后所有绘制都画到这里 (离屏渲染 / 后处理 / 截图)。
+ *      Samples == 1 时颜色附件直接是纹理, 可以马上采样;
+ *      Samples > 1 时画在多重采样的渲染缓冲里, Resolve 用 glBlitFramebuffer 解析到另一个 FBO 的纹理上,
+ *      GetColorAttachment 返回的总是那张单采样纹理。
+ *      无窗口模式下没有默认帧缓冲, 整个画面都画在这里。
+ */
+class Framebuffer
+{
+private:
+	FramebufferSpec m_Spec;
+	unsigned int m_RendererID;      // 绘制用的 FBO
+	unsigned int m_ColorAttachment; // Samples == 1 时的颜色纹理
+	unsigned int m_MultisampleColor; // Samples > 1 时的颜色渲染缓冲
+	unsigned int m_DepthAttachment; // 渲染缓冲
+	unsigned int m_ResolveID;       // Samples > 1 时解析用的 FBO, 颜色附件是 m_ColorAttachment
+	unsigned int m_MaxSamples;
+	bool m_Complete;
+
+	// Bind 时记下原来的绑定和视口, Unbind 时恢复 (嵌套使用时能回到外层的帧缓冲)
+	mutable int m_PreviousFramebuffer;
+	mutable int m_PreviousViewport[4];
+	mutable bool m_NeedsResolve;
+
+public:
+	Framebuffer(const FramebufferSpec& spec);
+	Framebuffer(int width, int height);
+	~Framebuffer();
+
+	Framebuffer(const Framebuffer&) = delete;
+	Framebuffer& operator=(const Framebuffer&) = delete;
+
+	// 绑定为读和写的帧缓冲, 同时把视口设成整个帧缓冲
+	void Bind() const;
+	// 恢复 Bind 之前的帧缓冲和视口
+	void Unbind() const;
+
+	// 多重采样时把画好的内容解析到颜色纹理上, 自上次 Bind 之后已经解析过就什么都不做; 单采样时什么都不做
+	void Resolve() const;
+
+	// 尺寸变了才重建附件, 内容会丢失
+	void Resize(int width, int height);
+	// 改采样数, 会被限制在驱动支持的最大值以内, 内容会丢失
+	void SetSamples(unsigned int samples);
+
+	// 颜色纹理, 可以直接当普通纹理采样 (多重采样时要先 Resolve)
+	inline unsigned int GetColorAttachment() const { return m_ColorAttachment; }
+	void BindColorAttachment(unsigned int slot = 0) const;
+	// 读像素时用的 FBO: 多重采样时是解析后的那个
+	inline unsigned int GetReadFramebuffer() const { return m_ResolveID ? m_ResolveID : m_RendererID; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+
+	inline const FramebufferSpec& GetSpec() const { return m_Spec; }
+	inline int GetWidth() const { return m_Spec.Width; }
+	inline int GetHeight() const { return m_Spec.Height; }
+	inline unsigned int GetSamples() const { return m_Spec.Samples; }
+	inline unsigned int GetMaxSamples() const { return m_MaxSamples; }
+	// 最近一次创建附件后检查的结果
+	inline bool IsComplete() const { return m_Complete; }
+
+private:
+	void Create();
+	void Destroy();
+	bool CheckStatus(unsigned int framebuffer) const;
+};
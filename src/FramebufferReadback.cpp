@@ -0,0 +1,241 @@
+#include "FramebufferReadback.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include "Render.h"
+#include "GLState.h"
+#include "Framebuffer.h"
+#include "Profiler.h"
+
+FramebufferReadback::FramebufferReadback()
+    : m_NextSlot(0), m_NextRequestId(1)
+{
+    for (Slot& slot : m_Slots)
+    {
+        GLCall(glGenBuffers(1, &slot.Buffer));
+    }
+}
+
+FramebufferReadback::~FramebufferReadback()
+{
+    for (Slot& slot : m_Slots)
+    {
+        if (slot.Fence)
+        {
+            GLCall(glDeleteSync((GLsync)slot.Fence));
+        }
+        GLState::OnBufferDeleted(slot.Buffer);
+        GLCall(glDeleteBuffers(1, &slot.Buffer));
+    }
+}
+
+uint64_t FramebufferReadback::Request(const Framebuffer& framebuffer)
+{
+    framebuffer.Resolve();
+    return Request(framebuffer.GetReadFramebuffer(), framebuffer.GetWidth(), framebuffer.GetHeight());
+}
+
+uint64_t FramebufferReadback::Request(unsigned int framebuffer, int width, int height)
+{
+    PROFILE_FUNCTION();
+    if (width <= 0 || height <= 0)
+        return 0;
+
+    // 槽按顺序轮流用, 下一个还没被取走就说明三个都在路上
+    Slot& slot = m_Slots[m_NextSlot];
+    if (slot.Pending)
+        return 0;
+    m_NextSlot = (m_NextSlot + 1) % SlotCount;
+
+    unsigned int size = (unsigned int)width * (unsigned int)height * 4;
+    GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+    if (size > slot.Capacity)
+    {
+        GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ));
+        slot.Capacity = size;
+    }
+
+    GLint previousRead = 0;
+    GLCall(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead));
+    GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+    // 绑定了 PBO 时最后一个参数是缓冲区里的偏移, 调用马上返回
+    GLCall(glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, (unsigned int)previousRead);
+    GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    GLsync fence;
+    GLCall(fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    // fence 要被提交给GPU才会通过, 先 flush 一下, 否则 Poll 可能要等到下一次交换缓冲
+    GLCall(glFlush());
+
+    slot.Fence = fence;
+    slot.Width = width;
+    slot.Height = height;
+    slot.RequestId = m_NextRequestId++;
+    slot.Pending = true;
+    return slot.RequestId;
+}
+
+FramebufferReadback::Slot* FramebufferReadback::GetOldestPending()
+{
+    Slot* oldest = nullptr;
+    for (Slot& slot : m_Slots)
+    {
+        if (slot.Pending && (!oldest || slot.RequestId < oldest->RequestId))
+            oldest = &slot;
+    }
+    return oldest;
+}
+
+bool FramebufferReadback::Poll(CapturedImage& image)
+{
+    Slot* slot = GetOldestPending();
+    if (!slot)
+        return false;
+
+    GLint status = GL_UNSIGNALED;
+    GLCall(glGetSynciv((GLsync)slot->Fence, GL_SYNC_STATUS, 1, nullptr, &status));
+    if (status != GL_SIGNALED)
+        return false;
+
+    Retrieve(*slot, image);
+    return true;
+}
+
+bool FramebufferReadback::Wait(CapturedImage& image)
+{
+    Slot* slot = GetOldestPending();
+    if (!slot)
+        return false;
+
+    GLenum result = GL_TIMEOUT_EXPIRED;
+    while (result == GL_TIMEOUT_EXPIRED)
+    {
+        GLCall(result = glClientWaitSync((GLsync)slot->Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000)); // 1s
+    }
+    Retrieve(*slot, image);
+    return result != GL_WAIT_FAILED;
+}
+
+void FramebufferReadback::Retrieve(Slot& slot, CapturedImage& image)
+{
+    PROFILE_FUNCTION();
+    unsigned int size = (unsigned int)slot.Width * (unsigned int)slot.Height * 4;
+    image.Width = slot.Width;
+    image.Height = slot.Height;
+    image.RequestId = slot.RequestId;
+    image.Pixels.resize(size);
+
+    GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+    void* data;
+    GLCall(data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT));
+    if (data)
+    {
+        std::memcpy(image.Pixels.data(), data, size);
+        GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    }
+    GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    GLCall(glDeleteSync((GLsync)slot.Fence));
+    slot.Fence = nullptr;
+    slot.Pending = false;
+}
+
+unsigned int FramebufferReadback::GetPendingCount() const
+{
+    unsigned int count = 0;
+    for (const Slot& slot : m_Slots)
+    {
+        if (slot.Pending)
+            count++;
+    }
+    return count;
+}
+
+bool FramebufferReadback::WritePPM(const std::string& filepath, const CapturedImage& image)
+{
+    std::ofstream stream(filepath, std::ios::binary);
+    if (!stream)
+    {
+        std::cout << "Failed to write image '" << filepath << "'" << std::endl;
+        return false;
+    }
+    stream << "P6\n" << image.Width << " " << image.Height << "\n255\n";
+
+    std::vector<unsigned char> row((size_t)image.Width * 3);
+    for (int y = image.Height - 1; y >= 0; y--)
+    {
+        const unsigned char* src = image.Pixels.data() + (size_t)y * image.Width * 4;
+        for (int x = 0; x < image.Width; x++)
+        {
+            row[x * 3 + 0] = src[x * 4 + 0];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 2];
+        }
+        stream.write((const char*)row.data(), row.size());
+    }
+    return (bool)stream;
+}
+
+bool FramebufferReadback::ReadPPM(const std::string& filepath, CapturedImage& image)
+{
+    std::ifstream stream(filepath, std::ios::binary);
+    std::string magic;
+    int maxValue = 0;
+    stream >> magic >> image.Width >> image.Height >> maxValue;
+    if (!stream || magic != "P6" || maxValue != 255 || image.Width <= 0 || image.Height <= 0)
+    {
+        std::cout << "Failed to read image '" << filepath << "' (expected a binary 8-bit PPM)" << std::endl;
+        return false;
+    }
+    stream.get(); // 头后面的一个空白字符
+
+    image.Pixels.resize((size_t)image.Width * image.Height * 4);
+    std::vector<unsigned char> row((size_t)image.Width * 3);
+    for (int y = image.Height - 1; y >= 0; y--)
+    {
+        if (!stream.read((char*)row.data(), row.size()))
+        {
+            std::cout << "Image '" << filepath << "' is truncated" << std::endl;
+            return false;
+        }
+        unsigned char* dst = image.Pixels.data() + (size_t)y * image.Width * 4;
+        for (int x = 0; x < image.Width; x++)
+        {
+            dst[x * 4 + 0] = row[x * 3 + 0];
+            dst[x * 4 + 1] = row[x * 3 + 1];
+            dst[x * 4 + 2] = row[x * 3 + 2];
+            dst[x * 4 + 3] = 255;
+        }
+    }
+    image.RequestId = 0;
+    return true;
+}
+
+double FramebufferReadback::CompareImages(const CapturedImage& a, const CapturedImage& b, int tolerance)
+{
+    if (a.Width != b.Width || a.Height != b.Height)
+        return -1.0;
+
+    size_t pixelCount = (size_t)a.Width * a.Height;
+    if (pixelCount == 0)
+        return 0.0;
+    size_t different = 0;
+    for (size_t i = 0; i < pixelCount; i++)
+    {
+        const unsigned char* pa = &a.Pixels[i * 4];
+        const unsigned char* pb = &b.Pixels[i * 4];
+        for (int c = 0; c < 3; c++)
+        {
+            if (std::abs((int)pa[c] - (int)pb[c]) > tolerance)
+            {
+                different++;
+                break;
+            }
+        }
+    }
+    return (double)different / pixelCount;
+}
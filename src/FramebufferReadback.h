@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Framebuffer;
+
+// 读回来的一帧, RGBA8, 按GL的习惯从下往上存
+struct CapturedImage
+{
+	int Width = 0, Height = 0;
+	std::vector<unsigned char> Pixels;
+	uint64_t RequestId = 0; // Request 返回的编号
+};
+
+/**
+ * 异步读回帧缓冲的像素:
+ *      glReadPixels 直接读到内存里会让CPU一直等到GPU画完这一帧 (整个管线排空);
+ *      这里读到像素打包缓冲 (GL_PIXEL_PACK_BUFFER) 里, glReadPixels 只是往命令队列里加一次拷贝, 马上返回,
+ *      同时插入一个 fence, 之后每帧 Poll 一下, fence 已经通过了才映射缓冲区把数据拷出来。
+ *      一般要晚 1~2 帧才能拿到结果, 最多同时有 SlotCount 个请求在路上。
+ */
+class FramebufferReadback
+{
+public:
+	static const unsigned int SlotCount = 3;
+
+private:
+	struct Slot
+	{
+		unsigned int Buffer = 0;   // PBO
+		unsigned int Capacity = 0; // 字节
+		void* Fence = nullptr;     // GLsync
+		int Width = 0, Height = 0;
+		uint64_t RequestId = 0;
+		bool Pending = false;
+	};
+
+	Slot m_Slots[SlotCount];
+	unsigned int m_NextSlot;
+	uint64_t m_NextRequestId;
+
+public:
+	FramebufferReadback();
+	~FramebufferReadback();
+
+	FramebufferReadback(const FramebufferReadback&) = delete;
+	FramebufferReadback& operator=(const FramebufferReadback&) = delete;
+
+	// 读整个帧缓冲 (多重采样时先解析), 返回请求编号; 所有槽都在用时返回 0
+	uint64_t Request(const Framebuffer& framebuffer);
+	// 读 framebuffer 号 FBO 左下角 width x height 的区域, 0 是窗口的后缓冲 (要在交换之前调用)
+	uint64_t Request(unsigned int framebuffer, int width, int height);
+
+	// 不阻塞: 有请求已经完成就把最早的那个拷到 image 里并返回 true
+	bool Poll(CapturedImage& image);
+	// 阻塞: 等最早的请求完成, 没有请求时返回 false
+	bool Wait(CapturedImage& image);
+
+	unsigned int GetPendingCount() const;
+
+	// 写成二进制 PPM (P6, 丢掉 alpha), 会把行序翻成从上往下
+	static bool WritePPM(const std::string& filepath, const CapturedImage& image);
+	// 读 WritePPM 写出的文件, 转回 RGBA8、从下往上
+	static bool ReadPPM(const std::string& filepath, CapturedImage& image);
+	// 有多少比例的像素在某个通道 (RGB) 上相差超过 tolerance, 尺寸不同时返回 -1
+	static double CompareImages(const CapturedImage& a, const CapturedImage& b, int tolerance);
+
+private:
+	// 还在路上的请求里最早的那个, 没有时返回 nullptr
+	Slot* GetOldestPending();
+	void Retrieve(Slot& slot, CapturedImage& image);
+};
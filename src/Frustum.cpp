@@ -0,0 +1,136 @@
+#include "Frustum.h"
+
+#include <cmath>
+
+// x64 上 SSE 总是可用, 32 位 MSVC 看 /arch 设置, 其它平台看编译器宏
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define FRUSTUM_USE_SSE
+    #include <xmmintrin.h>
+#endif
+
+void AABBList::Clear()
+{
+    MinX.clear(); MinY.clear(); MinZ.clear();
+    MaxX.clear(); MaxY.clear(); MaxZ.clear();
+}
+
+void AABBList::Reserve(size_t count)
+{
+    MinX.reserve(count); MinY.reserve(count); MinZ.reserve(count);
+    MaxX.reserve(count); MaxY.reserve(count); MaxZ.reserve(count);
+}
+
+void AABBList::Push(const AABB& box)
+{
+    MinX.push_back(box.Min.x); MinY.push_back(box.Min.y); MinZ.push_back(box.Min.z);
+    MaxX.push_back(box.Max.x); MaxY.push_back(box.Max.y); MaxZ.push_back(box.Max.z);
+}
+
+Frustum::Frustum()
+{
+    Set(glm::mat4(1.0f));
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+    Set(viewProjection);
+}
+
+void Frustum::Set(const glm::mat4& viewProjection)
+{
+    // glm 是列主序, 第 i 行是 (m[0][i], m[1][i], m[2][i], m[3][i])
+    const glm::mat4& m = viewProjection;
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; i++)
+        row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+    m_Planes[0] = row[3] + row[0]; // 左
+    m_Planes[1] = row[3] - row[0]; // 右
+    m_Planes[2] = row[3] + row[1]; // 下
+    m_Planes[3] = row[3] - row[1]; // 上
+    m_Planes[4] = row[3] + row[2]; // 近
+    m_Planes[5] = row[3] - row[2]; // 远
+    for (glm::vec4& plane : m_Planes)
+    {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f)
+            plane /= length;
+    }
+
+    // NDC 立方体的8个角变换回世界空间
+    glm::mat4 inverse = glm::inverse(viewProjection);
+    m_Bounds.Min = glm::vec3(INFINITY);
+    m_Bounds.Max = glm::vec3(-INFINITY);
+    for (int i = 0; i < 8; i++)
+    {
+        glm::vec4 corner = inverse * glm::vec4(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f, 1.0f);
+        glm::vec3 point = glm::vec3(corner) / corner.w;
+        m_Bounds.Min = glm::min(m_Bounds.Min, point);
+        m_Bounds.Max = glm::max(m_Bounds.Max, point);
+    }
+}
+
+bool Frustum::Intersects(const AABB& box) const
+{
+    for (const glm::vec4& plane : m_Planes)
+    {
+        glm::vec3 p(plane.x >= 0.0f ? box.Max.x : box.Min.x,
+                    plane.y >= 0.0f ? box.Max.y : box.Min.y,
+                    plane.z >= 0.0f ? box.Max.z : box.Min.z);
+        if (glm::dot(glm::vec3(plane), p) + plane.w < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+void Frustum::Intersects(const AABBList& boxes, unsigned char* visible) const
+{
+    size_t count = boxes.Size();
+    // 同一个平面对所有盒子选的是同一侧的角, 所以可以事先为每个平面选好从哪几个数组读
+    const float* px[6];
+    const float* py[6];
+    const float* pz[6];
+    for (int i = 0; i < 6; i++)
+    {
+        px[i] = m_Planes[i].x >= 0.0f ? boxes.MaxX.data() : boxes.MinX.data();
+        py[i] = m_Planes[i].y >= 0.0f ? boxes.MaxY.data() : boxes.MinY.data();
+        pz[i] = m_Planes[i].z >= 0.0f ? boxes.MaxZ.data() : boxes.MinZ.data();
+    }
+
+    size_t i = 0;
+#ifdef FRUSTUM_USE_SSE
+    __m128 nx[6], ny[6], nz[6], d[6];
+    for (int p = 0; p < 6; p++)
+    {
+        nx[p] = _mm_set1_ps(m_Planes[p].x);
+        ny[p] = _mm_set1_ps(m_Planes[p].y);
+        nz[p] = _mm_set1_ps(m_Planes[p].z);
+        d[p] = _mm_set1_ps(m_Planes[p].w);
+    }
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 outside = zero;
+        for (int p = 0; p < 6; p++)
+        {
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(nx[p], _mm_loadu_ps(px[p] + i)), _mm_mul_ps(ny[p], _mm_loadu_ps(py[p] + i))),
+                _mm_add_ps(_mm_mul_ps(nz[p], _mm_loadu_ps(pz[p] + i)), d[p]));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, zero));
+        }
+        int mask = _mm_movemask_ps(outside);
+        visible[i + 0] = (mask & 1) == 0;
+        visible[i + 1] = (mask & 2) == 0;
+        visible[i + 2] = (mask & 4) == 0;
+        visible[i + 3] = (mask & 8) == 0;
+    }
+#endif
+    // 剩下不足4个的 (或者没有SSE时全部)
+    for (; i < count; i++)
+    {
+        bool inside = true;
+        for (int p = 0; p < 6 && inside; p++)
+            inside = m_Planes[p].x * px[p][i] + m_Planes[p].y * py[p][i] + m_Planes[p].z * pz[p][i] + m_Planes[p].w >= 0.0f;
+        visible[i] = inside;
+    }
+}
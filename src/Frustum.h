@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// 轴对齐包围盒
+struct AABB
+{
+	glm::vec3 Min = glm::vec3(0.0f);
+	glm::vec3 Max = glm::vec3(0.0f);
+
+	AABB() {}
+	AABB(const glm::vec3& min, const glm::vec3& max) : Min(min), Max(max) {}
+
+	// 2D quad, position 是左下角, 和 BatchRenderer2D::DrawQuad 一致
+	static AABB FromQuad(const glm::vec2& position, const glm::vec2& size, float z = 0.0f)
+	{
+		return AABB(glm::vec3(position, z), glm::vec3(position + size, z));
+	}
+};
+
+/**
+ * 一组包围盒, 按分量分开存 (SoA):
+ *      Frustum::Intersects 一次从每个数组里连续读4个值, 正好装进一个SSE寄存器。
+ */
+struct AABBList
+{
+	std::vector<float> MinX, MinY, MinZ;
+	std::vector<float> MaxX, MaxY, MaxZ;
+
+	void Clear();
+	void Reserve(size_t count);
+	void Push(const AABB& box);
+	inline size_t Size() const { return MinX.size(); }
+};
+
+/**
+ * 视锥体: 从 proj * view 矩阵里提取的6个平面 (Gribb-Hartmann 方法), 法线朝内。
+ *      包围盒只要完全在任意一个平面外面就不可见, 检查时只需要看离平面最近的那个角 ("p-vertex")。
+ *      检查结果偏保守: 靠近视锥体棱角的盒子可能被判为可见, 但可见的一定不会被剔除。
+ */
+class Frustum
+{
+private:
+	glm::vec4 m_Planes[6]; // xyz 是法线, w 是距离, 点 p 在里面 <=> dot(n, p) + w >= 0
+	AABB m_Bounds;         // 视锥体8个角的包围盒, 空间索引用它找要检查的格子
+
+public:
+	Frustum();
+	Frustum(const glm::mat4& viewProjection);
+
+	void Set(const glm::mat4& viewProjection);
+
+	bool Intersects(const AABB& box) const;
+	// 一次检查 boxes 里所有的包围盒, visible[i] 为 0/1 (SSE 每次处理4个)
+	void Intersects(const AABBList& boxes, unsigned char* visible) const;
+
+	inline const glm::vec4& GetPlane(unsigned int index) const { return m_Planes[index]; }
+	inline const AABB& GetBounds() const { return m_Bounds; }
+};
@@ -0,0 +1,243 @@
+#include "GLState.h"
+
+#include "Render.h"
+
+// 表示 "不知道当前绑定的是什么", 任何绑定都会真正执行
+static const unsigned int s_Unknown = 0xffffffff;
+
+enum BufferSlot
+{
+    ArrayBufferSlot = 0, ElementArrayBufferSlot, PixelUnpackBufferSlot, PixelPackBufferSlot,
+    UniformBufferSlot, DrawIndirectBufferSlot, BufferSlotCount
+};
+
+struct StateCache
+{
+    unsigned int Program = s_Unknown;
+    unsigned int VertexArray = s_Unknown;
+    unsigned int Buffers[BufferSlotCount] = { s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown, s_Unknown };
+    unsigned int UniformBuffers[GLState::MaxUniformBufferBindings];
+    unsigned int ActiveTexture = s_Unknown;
+    unsigned int Textures[GLState::MaxTextureUnits];
+    unsigned int DrawFramebuffer = s_Unknown;
+    unsigned int ReadFramebuffer = s_Unknown;
+    unsigned int Blend = s_Unknown; // 0 / 1
+    unsigned int BlendSrc = s_Unknown, BlendDst = s_Unknown;
+
+    StateCache()
+    {
+        for (unsigned int i = 0; i < GLState::MaxTextureUnits; i++)
+            Textures[i] = s_Unknown;
+        for (unsigned int i = 0; i < GLState::MaxUniformBufferBindings; i++)
+            UniformBuffers[i] = s_Unknown;
+    }
+};
+
+static StateCache s_Cache;
+static GLState::Statistics s_Stats;
+
+static int GetBufferSlot(unsigned int target)
+{
+    switch (target)
+    {
+        case GL_ARRAY_BUFFER: return ArrayBufferSlot;
+        case GL_ELEMENT_ARRAY_BUFFER: return ElementArrayBufferSlot;
+        case GL_PIXEL_UNPACK_BUFFER: return PixelUnpackBufferSlot;
+        case GL_PIXEL_PACK_BUFFER: return PixelPackBufferSlot;
+        case GL_UNIFORM_BUFFER: return UniformBufferSlot;
+        case GL_DRAW_INDIRECT_BUFFER: return DrawIndirectBufferSlot;
+    }
+    return -1;
+}
+
+// 值没变返回 true (跳过), 否则更新缓存返回 false
+static bool CheckAndSet(unsigned int& cached, unsigned int value)
+{
+    if (cached == value)
+    {
+        s_Stats.Skipped++;
+        return true;
+    }
+    cached = value;
+    s_Stats.Issued++;
+    return false;
+}
+
+void GLState::UseProgram(unsigned int program)
+{
+    if (CheckAndSet(s_Cache.Program, program))
+        return;
+    GLCall(glUseProgram(program));
+}
+
+void GLState::BindVertexArray(unsigned int vao)
+{
+    if (CheckAndSet(s_Cache.VertexArray, vao))
+        return;
+    GLCall(glBindVertexArray(vao));
+    // GL_ELEMENT_ARRAY_BUFFER 的绑定是VAO状态的一部分, 换了VAO就不知道当前是哪个了
+    s_Cache.Buffers[ElementArrayBufferSlot] = s_Unknown;
+}
+
+void GLState::BindBuffer(unsigned int target, unsigned int buffer)
+{
+    int slot = GetBufferSlot(target);
+    if (slot >= 0 && CheckAndSet(s_Cache.Buffers[slot], buffer))
+        return;
+    if (slot < 0)
+        s_Stats.Issued++;
+    GLCall(glBindBuffer(target, buffer));
+}
+
+void GLState::BindBufferBase(unsigned int target, unsigned int index, unsigned int buffer)
+{
+    bool cached = target == GL_UNIFORM_BUFFER && index < MaxUniformBufferBindings;
+    if (cached && CheckAndSet(s_Cache.UniformBuffers[index], buffer))
+        return;
+    if (!cached)
+        s_Stats.Issued++;
+    GLCall(glBindBufferBase(target, index, buffer));
+    int slot = GetBufferSlot(target);
+    if (slot >= 0)
+        s_Cache.Buffers[slot] = buffer;
+}
+
+void GLState::ActiveTexture(unsigned int slot)
+{
+    if (s_Cache.ActiveTexture == slot)
+        return;
+    s_Cache.ActiveTexture = slot;
+    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+}
+
+void GLState::BindTexture(unsigned int slot, unsigned int texture)
+{
+    if (slot < MaxTextureUnits && CheckAndSet(s_Cache.Textures[slot], texture))
+        return;
+    if (slot >= MaxTextureUnits)
+        s_Stats.Issued++;
+    ActiveTexture(slot);
+    GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+}
+
+void GLState::BindTexture(unsigned int texture)
+{
+    unsigned int slot = s_Cache.ActiveTexture;
+    if (slot == s_Unknown)
+    {
+        // 不知道当前是哪个纹理单元, 只能直接绑定并让所有纹理单元的缓存失效
+        s_Stats.Issued++;
+        GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+        for (unsigned int i = 0; i < MaxTextureUnits; i++)
+            s_Cache.Textures[i] = s_Unknown;
+        return;
+    }
+    BindTexture(slot, texture);
+}
+
+void GLState::BindFramebuffer(unsigned int target, unsigned int framebuffer)
+{
+    if (target == GL_FRAMEBUFFER)
+    {
+        if (s_Cache.DrawFramebuffer == framebuffer && s_Cache.ReadFramebuffer == framebuffer)
+        {
+            s_Stats.Skipped++;
+            return;
+        }
+        s_Cache.DrawFramebuffer = s_Cache.ReadFramebuffer = framebuffer;
+        s_Stats.Issued++;
+    }
+    else if (CheckAndSet(target == GL_READ_FRAMEBUFFER ? s_Cache.ReadFramebuffer : s_Cache.DrawFramebuffer, framebuffer))
+        return;
+    GLCall(glBindFramebuffer(target, framebuffer));
+}
+
+void GLState::SetBlend(bool enabled)
+{
+    if (CheckAndSet(s_Cache.Blend, enabled ? 1 : 0))
+        return;
+    if (enabled)
+    {
+        GLCall(glEnable(GL_BLEND));
+    }
+    else
+    {
+        GLCall(glDisable(GL_BLEND));
+    }
+}
+
+void GLState::SetBlendFunc(unsigned int src, unsigned int dst)
+{
+    if (s_Cache.BlendSrc == src && s_Cache.BlendDst == dst)
+    {
+        s_Stats.Skipped++;
+        return;
+    }
+    s_Cache.BlendSrc = src;
+    s_Cache.BlendDst = dst;
+    s_Stats.Issued++;
+    GLCall(glBlendFunc(src, dst));
+}
+
+void GLState::OnProgramDeleted(unsigned int program)
+{
+    if (s_Cache.Program == program)
+        s_Cache.Program = s_Unknown;
+}
+
+void GLState::OnVertexArrayDeleted(unsigned int vao)
+{
+    // 删除当前VAO后GL会回到0号VAO
+    if (s_Cache.VertexArray == vao)
+    {
+        s_Cache.VertexArray = 0;
+        s_Cache.Buffers[ElementArrayBufferSlot] = s_Unknown;
+    }
+}
+
+void GLState::OnBufferDeleted(unsigned int buffer)
+{
+    for (unsigned int i = 0; i < BufferSlotCount; i++)
+    {
+        if (s_Cache.Buffers[i] == buffer)
+            s_Cache.Buffers[i] = 0;
+    }
+    for (unsigned int i = 0; i < MaxUniformBufferBindings; i++)
+    {
+        if (s_Cache.UniformBuffers[i] == buffer)
+            s_Cache.UniformBuffers[i] = 0;
+    }
+}
+
+void GLState::OnTextureDeleted(unsigned int texture)
+{
+    for (unsigned int i = 0; i < MaxTextureUnits; i++)
+    {
+        if (s_Cache.Textures[i] == texture)
+            s_Cache.Textures[i] = 0;
+    }
+}
+
+void GLState::OnFramebufferDeleted(unsigned int framebuffer)
+{
+    // 删除当前帧缓冲后GL会回到默认帧缓冲
+    if (s_Cache.DrawFramebuffer == framebuffer)
+        s_Cache.DrawFramebuffer = 0;
+    if (s_Cache.ReadFramebuffer == framebuffer)
+        s_Cache.ReadFramebuffer = 0;
+}
+
+void GLState::Invalidate()
+{
+    s_Cache = StateCache();
+}
+
+const GLState::Statistics& GLState::GetStats()
+{
+    return s_Stats;
+}
+
+void GLState::ResetStats()
+{
+    s_Stats = Statistics();
+}
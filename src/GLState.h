@@ -0,0 +1,53 @@
+#pragma once
+
+/**
+ * OpenGL 状态缓存:
+ *      所有 Bind() 都经过这里, 记住当前绑定的 program / VAO / buffer / 纹理单元 / 帧缓冲 / 混合状态,
+ *      如果要绑定的对象已经是当前对象, 就直接跳过, 不再调用GL (驱动在每次状态切换上都有CPU开销)。
+ * 注意:
+ *      绕开这里直接调 glBindXXX 会让缓存失效, 这种情况 (比如 ImGui 的渲染后端) 之后要调用 Invalidate()。
+ *      删除GL对象时要通知缓存 (OnXXXDeleted), 因为GL会自动解绑被删除的对象, 而且ID之后可能被复用。
+ */
+class GLState
+{
+public:
+	struct Statistics
+	{
+		unsigned int Issued = 0;  // 真正调用了GL的状态切换
+		unsigned int Skipped = 0; // 因为状态没变而跳过的
+	};
+
+	static const unsigned int MaxTextureUnits = 32; // 超出的纹理单元不缓存, 每次都直接调用GL
+	static const unsigned int MaxUniformBufferBindings = 16; // GL 3.3 至少保证 GL_MAX_UNIFORM_BUFFER_BINDINGS >= 36
+
+public:
+	static void UseProgram(unsigned int program);
+	static void BindVertexArray(unsigned int vao);
+	static void BindBuffer(unsigned int target, unsigned int buffer);
+	// GL_UNIFORM_BUFFER 的 index 号绑定点, 同时也会改变 GL_UNIFORM_BUFFER 本身的绑定
+	static void BindBufferBase(unsigned int target, unsigned int index, unsigned int buffer);
+	// 在 slot 号纹理单元上绑定 GL_TEXTURE_2D
+	static void BindTexture(unsigned int slot, unsigned int texture);
+	// 在当前激活的纹理单元上绑定 GL_TEXTURE_2D (创建/更新纹理时用)
+	static void BindTexture(unsigned int texture);
+	// target 是 GL_FRAMEBUFFER 时同时绑定读和写, 也可以只绑 GL_READ_FRAMEBUFFER / GL_DRAW_FRAMEBUFFER
+	static void BindFramebuffer(unsigned int target, unsigned int framebuffer);
+
+	static void SetBlend(bool enabled);
+	static void SetBlendFunc(unsigned int src, unsigned int dst);
+
+	static void OnProgramDeleted(unsigned int program);
+	static void OnVertexArrayDeleted(unsigned int vao);
+	static void OnBufferDeleted(unsigned int buffer);
+	static void OnTextureDeleted(unsigned int texture);
+	static void OnFramebufferDeleted(unsigned int framebuffer);
+
+	// 忘掉所有缓存的状态, 下一次绑定一定会调用GL
+	static void Invalidate();
+
+	static const Statistics& GetStats();
+	static void ResetStats();
+
+private:
+	static void ActiveTexture(unsigned int slot);
+};
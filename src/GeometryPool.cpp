@@ -0,0 +1,112 @@
+#include "GeometryPool.h"
+
+#include <iterator>
+
+#include "Render.h"
+
+GeometryPool::FreeList::FreeList(unsigned int capacity)
+    : m_Capacity(capacity), m_Used(0)
+{
+    if (capacity > 0)
+        m_Free[0] = capacity;
+}
+
+bool GeometryPool::FreeList::Allocate(unsigned int count, unsigned int& offset)
+{
+    for (auto it = m_Free.begin(); it != m_Free.end(); ++it)
+    {
+        if (it->second < count)
+            continue;
+        offset = it->first;
+        unsigned int remaining = it->second - count;
+        m_Free.erase(it);
+        if (remaining > 0)
+            m_Free[offset + count] = remaining;
+        m_Used += count;
+        return true;
+    }
+    return false;
+}
+
+void GeometryPool::FreeList::Free(unsigned int offset, unsigned int count)
+{
+    m_Used -= count;
+    auto next = m_Free.lower_bound(offset);
+
+    // 和后面相邻的空闲块合并
+    if (next != m_Free.end() && offset + count == next->first)
+    {
+        count += next->second;
+        next = m_Free.erase(next);
+    }
+    // 和前面相邻的空闲块合并
+    if (next != m_Free.begin())
+    {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset)
+        {
+            prev->second += count;
+            return;
+        }
+    }
+    m_Free[offset] = count;
+}
+
+GeometryPool::GeometryPool(const VertexBufferLayout& layout, unsigned int maxVertices, unsigned int maxIndices)
+    : GeometryPool(layout.GetView(), maxVertices, maxIndices)
+{
+}
+
+GeometryPool::GeometryPool(const VertexLayoutView& layout, unsigned int maxVertices, unsigned int maxIndices)
+    : m_Stride(layout.Stride), m_Vertices(maxVertices), m_Indices(maxIndices), m_MeshCount(0)
+{
+    m_VAO = std::make_unique<VertexArray>();
+    m_VertexBuffer = std::make_unique<VertexBuffer>(maxVertices * m_Stride);
+    m_VAO->AddBuffer(*m_VertexBuffer, layout);
+
+    // 在VAO绑定的状态下创建, 索引缓冲就记录在这个VAO里了
+    m_IndexBuffer = std::make_unique<IndexBuffer>(nullptr, maxIndices);
+}
+
+GeometryPool::~GeometryPool()
+{
+}
+
+MeshAllocation GeometryPool::Allocate(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount)
+{
+    MeshAllocation mesh;
+    unsigned int firstVertex = 0, firstIndex = 0;
+    if (vertexCount == 0 || indexCount == 0 || !m_Vertices.Allocate(vertexCount, firstVertex))
+        return mesh;
+    if (!m_Indices.Allocate(indexCount, firstIndex))
+    {
+        m_Vertices.Free(firstVertex, vertexCount);
+        return mesh;
+    }
+
+    m_VertexBuffer->SetData(vertices, vertexCount * m_Stride, firstVertex * m_Stride);
+    m_VAO->Bind();
+    m_IndexBuffer->SetData(indices, indexCount, firstIndex);
+
+    mesh.FirstIndex = firstIndex;
+    mesh.IndexCount = indexCount;
+    mesh.BaseVertex = (int)firstVertex;
+    mesh.VertexCount = vertexCount;
+    m_MeshCount++;
+    return mesh;
+}
+
+void GeometryPool::Free(const MeshAllocation& mesh)
+{
+    if (!mesh.IsValid())
+        return;
+    // 数据不用清掉, 之后分配到这里的网格会覆盖
+    m_Vertices.Free((unsigned int)mesh.BaseVertex, mesh.VertexCount);
+    m_Indices.Free(mesh.FirstIndex, mesh.IndexCount);
+    m_MeshCount--;
+}
+
+void GeometryPool::Bind() const
+{
+    m_VAO->Bind();
+}
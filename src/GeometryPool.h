@@ -0,0 +1,81 @@
+#pragma once
+
+#include <map>
+#include <memory>
+
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "VertexBufferLayout.h"
+
+// 一个网格在 GeometryPool 里占的位置, 正好就是间接绘制命令需要的几个参数
+struct MeshAllocation
+{
+	unsigned int FirstIndex = 0;  // 在共享索引缓冲里的起始下标
+	unsigned int IndexCount = 0;
+	int BaseVertex = 0;           // 在共享顶点缓冲里的起始顶点, 网格自己的索引从0开始
+	unsigned int VertexCount = 0;
+
+	inline bool IsValid() const { return IndexCount > 0; }
+};
+
+/**
+ * 共享几何池:
+ *      所有网格 (顶点格式相同) 放进同一块大的顶点缓冲和索引缓冲, 共用一个VAO,
+ *      这样不同的网格可以用同一次 glMultiDrawElementsIndirect 画出来 (见 DrawCommandBuffer)。
+ *      顶点和索引各自用一个按偏移排序的空闲链表分配, Free 时和相邻的空闲块合并。
+ */
+class GeometryPool
+{
+private:
+	// 首次适配的区间分配器, 单位是顶点/索引个数
+	class FreeList
+	{
+	private:
+		std::map<unsigned int, unsigned int> m_Free; // 起始位置 -> 长度
+		unsigned int m_Capacity;
+		unsigned int m_Used;
+
+	public:
+		FreeList(unsigned int capacity);
+
+		// 失败返回 false
+		bool Allocate(unsigned int count, unsigned int& offset);
+		void Free(unsigned int offset, unsigned int count);
+
+		inline unsigned int GetCapacity() const { return m_Capacity; }
+		inline unsigned int GetUsed() const { return m_Used; }
+	};
+
+	std::unique_ptr<VertexArray> m_VAO;
+	std::unique_ptr<VertexBuffer> m_VertexBuffer;
+	std::unique_ptr<IndexBuffer> m_IndexBuffer;
+	unsigned int m_Stride;
+
+	FreeList m_Vertices;
+	FreeList m_Indices;
+	unsigned int m_MeshCount;
+
+public:
+	GeometryPool(const VertexBufferLayout& layout, unsigned int maxVertices, unsigned int maxIndices);
+	// 顶点是结构体时传 GetVertexLayout<Vertex>()
+	GeometryPool(const VertexLayoutView& layout, unsigned int maxVertices, unsigned int maxIndices);
+	~GeometryPool();
+
+	GeometryPool(const GeometryPool&) = delete;
+	GeometryPool& operator=(const GeometryPool&) = delete;
+
+	// 上传一个网格, vertices 的格式要和构造时的 layout 一致; 空间不够时返回无效的 MeshAllocation
+	MeshAllocation Allocate(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+	void Free(const MeshAllocation& mesh);
+
+	// 画之前绑定 (VAO 里已经包含了共享的索引缓冲)
+	void Bind() const;
+
+	inline unsigned int GetStride() const { return m_Stride; }
+	inline unsigned int GetMeshCount() const { return m_MeshCount; }
+	inline unsigned int GetVertexCapacity() const { return m_Vertices.GetCapacity(); }
+	inline unsigned int GetVerticesUsed() const { return m_Vertices.GetUsed(); }
+	inline unsigned int GetIndexCapacity() const { return m_Indices.GetCapacity(); }
+	inline unsigned int GetIndicesUsed() const { return m_Indices.GetUsed(); }
+};
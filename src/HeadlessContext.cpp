@@ -0,0 +1,162 @@
+#include "HeadlessContext.h"
+
+#include <cstring>
+#include <iostream>
+
+#if defined(GL_HAVE_EGL)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+static bool HasExtension(const char* extensions, const char* name)
+{
+    if (!extensions)
+        return false;
+    size_t length = std::strlen(name);
+    for (const char* p = std::strstr(extensions, name); p; p = std::strstr(p + length, name))
+    {
+        // 要整个单词匹配, 不能是别的扩展名的前缀
+        bool start = p == extensions || p[-1] == ' ';
+        bool end = p[length] == ' ' || p[length] == '\0';
+        if (start && end)
+            return true;
+    }
+    return false;
+}
+
+static EGLDisplay GetDisplay()
+{
+    // 客户端扩展在 EGL_NO_DISPLAY 上查询
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (HasExtension(clientExtensions, "EGL_MESA_platform_surfaceless") && HasExtension(clientExtensions, "EGL_EXT_platform_base"))
+    {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay)
+        {
+            EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if (display != EGL_NO_DISPLAY)
+                return display;
+        }
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+HeadlessContext::HeadlessContext(int major, int minor)
+    : m_Display(nullptr), m_Context(nullptr), m_Surface(nullptr)
+{
+    EGLDisplay display = GetDisplay();
+    EGLint eglMajor = 0, eglMinor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &eglMajor, &eglMinor))
+    {
+        std::cerr << "Failed to initialize EGL display (error 0x" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+        return;
+    }
+    m_Display = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        std::cerr << "EGL does not support desktop OpenGL" << std::endl;
+        Destroy();
+        return;
+    }
+
+    // 颜色/深度缓冲都在 Framebuffer 里, 这里的 config 只是创建上下文用
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0)
+    {
+        std::cerr << "No suitable EGL config for OpenGL" << std::endl;
+        Destroy();
+        return;
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION_KHR, major,
+        EGL_CONTEXT_MINOR_VERSION_KHR, minor,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT)
+    {
+        std::cerr << "Failed to create OpenGL " << major << "." << minor << " core context (error 0x"
+            << std::hex << eglGetError() << std::dec << ")" << std::endl;
+        Destroy();
+        return;
+    }
+
+    EGLSurface surface = EGL_NO_SURFACE;
+    if (!HasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context"))
+    {
+        const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        surface = eglCreatePbufferSurface(display, config, pbufferAttribs);
+        m_Surface = surface;
+    }
+
+    if (!eglMakeCurrent(display, surface, surface, context))
+    {
+        std::cerr << "Failed to make the EGL context current (error 0x" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+        eglDestroyContext(display, context);
+        Destroy();
+        return;
+    }
+    m_Context = context;
+    std::cout << "Created headless OpenGL context via EGL " << eglMajor << "." << eglMinor
+        << (surface == EGL_NO_SURFACE ? " (surfaceless)" : " (pbuffer)") << std::endl;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    Destroy();
+}
+
+void HeadlessContext::Destroy()
+{
+    if (!m_Display)
+        return;
+    eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_Context)
+        eglDestroyContext(m_Display, m_Context);
+    if (m_Surface)
+        eglDestroySurface(m_Display, m_Surface);
+    eglTerminate(m_Display);
+    m_Display = m_Context = m_Surface = nullptr;
+}
+
+bool HeadlessContext::IsSupported()
+{
+    return true;
+}
+
+#else
+
+HeadlessContext::HeadlessContext(int major, int minor)
+    : m_Display(nullptr), m_Context(nullptr), m_Surface(nullptr)
+{
+    std::cerr << "Headless mode is not available: built without EGL" << std::endl;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+}
+
+void HeadlessContext::Destroy()
+{
+}
+
+bool HeadlessContext::IsSupported()
+{
+    return false;
+}
+
+#endif
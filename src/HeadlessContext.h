@@ -0,0 +1,32 @@
+#pragma once
+
+/**
+ * 无窗口的 OpenGL 上下文:
+ *      用 EGL 创建, 不需要显示器和窗口系统 (Mesa 的 llvmpipe 软件渲染也可以), 给基准测试和 CI 用。
+ *      优先用 Mesa 的 surfaceless 平台, 没有时退回默认显示;
+ *      驱动支持 EGL_KHR_surfaceless_context 时不创建任何 surface, 否则建一个 1x1 的 pbuffer 凑数。
+ *      没有默认帧缓冲, 要画到 Framebuffer 里。
+ * 编译时没有找到 EGL (CMake 里没有 OpenGL::EGL) 时创建总是失败。
+ */
+class HeadlessContext
+{
+private:
+	void* m_Display;
+	void* m_Context;
+	void* m_Surface;
+
+public:
+	// 创建 major.minor 核心模式的上下文并设为当前线程的上下文, 失败时打印原因, IsCreated() 返回 false
+	HeadlessContext(int major = 3, int minor = 3);
+	~HeadlessContext();
+
+	HeadlessContext(const HeadlessContext&) = delete;
+	HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+	inline bool IsCreated() const { return m_Context != nullptr; }
+
+	static bool IsSupported();
+
+private:
+	void Destroy();
+};
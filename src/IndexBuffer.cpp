@@ -1,27 +1,36 @@
 #include "IndexBuffer.h"
 
 #include "Render.h"
+#include "GLState.h"
 
 IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count): m_count(count)
 {
     ASSERT(sizeof(unsigned int) == sizeof(GLuint));
 
     GLCall(glGenBuffers(1, &m_rendered_id));
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_rendered_id));
-    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW));
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_rendered_id);
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, data ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW));
+}
+
+void IndexBuffer::SetData(const unsigned int* data, unsigned int count, unsigned int offset)
+{
+    ASSERT(offset + count <= m_count);
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_rendered_id);
+    GLCall(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset * sizeof(unsigned int), count * sizeof(unsigned int), data));
 }
 
 IndexBuffer::~IndexBuffer()
 {
+    GLState::OnBufferDeleted(m_rendered_id);
     GLCall(glDeleteBuffers(1, &m_rendered_id ));
 }
 
 void IndexBuffer::Bind() const
 {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_rendered_id));
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_rendered_id);
 }
 
 void IndexBuffer::Unbind() const
 {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
\ No newline at end of file
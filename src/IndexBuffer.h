@@ -6,9 +6,14 @@ private:
 	unsigned int m_rendered_id;
 	unsigned int m_count;
 public:
+	// data 为空时只分配 count 个索引的空间, 之后用 SetData 填
 	IndexBuffer(const unsigned int* data, unsigned int count);
 	~IndexBuffer();
 
+	// 从第 offset 个索引开始覆盖写入 count 个索引
+	// 注意: 会绑定到 GL_ELEMENT_ARRAY_BUFFER, 这是当前VAO的状态, 要先绑定使用这个索引缓冲的VAO
+	void SetData(const unsigned int* data, unsigned int count, unsigned int offset = 0);
+
 	void Bind() const;
 	void Unbind() const;
 
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * 有界无锁队列 (Dmitry Vyukov 的 MPMC 环形队列):
+ *      每个格子带一个序号, 生产者/消费者用 CAS 抢位置, 再通过序号判断格子是否可写/可读。
+ *      多个生产者、多个消费者都可以, 不需要锁。容量必须是2的幂。
+ */
+template<typename T>
+class LockFreeQueue
+{
+private:
+	struct Cell
+	{
+		std::atomic<size_t> Sequence;
+		T Data;
+	};
+
+	std::unique_ptr<Cell[]> m_Buffer;
+	size_t m_Mask;
+	// 分开放在不同的缓存行, 避免生产者和消费者互相伪共享
+	alignas(64) std::atomic<size_t> m_EnqueuePos;
+	alignas(64) std::atomic<size_t> m_DequeuePos;
+
+public:
+	LockFreeQueue(size_t capacity)
+		: m_Buffer(new Cell[capacity]), m_Mask(capacity - 1), m_EnqueuePos(0), m_DequeuePos(0)
+	{
+		static_assert(std::atomic<size_t>::is_always_lock_free, "size_t atomics must be lock free");
+		// capacity 必须是2的幂
+		if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+			__builtin_trap();
+		for (size_t i = 0; i < capacity; i++)
+			m_Buffer[i].Sequence.store(i, std::memory_order_relaxed);
+	}
+
+	LockFreeQueue(const LockFreeQueue&) = delete;
+	LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+	// 队列满时返回 false, value 不会被移走
+	bool TryPush(T& value)
+	{
+		Cell* cell;
+		size_t pos = m_EnqueuePos.load(std::memory_order_relaxed);
+		while (true)
+		{
+			cell = &m_Buffer[pos & m_Mask];
+			size_t seq = cell->Sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+			if (diff == 0)
+			{
+				if (m_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+				return false; // 满了
+			else
+				pos = m_EnqueuePos.load(std::memory_order_relaxed);
+		}
+		cell->Data = std::move(value);
+		cell->Sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// 队列空时返回 false
+	bool TryPop(T& value)
+	{
+		Cell* cell;
+		size_t pos = m_DequeuePos.load(std::memory_order_relaxed);
+		while (true)
+		{
+			cell = &m_Buffer[pos & m_Mask];
+			size_t seq = cell->Sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+			if (diff == 0)
+			{
+				if (m_DequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+				return false; // 空的
+			else
+				pos = m_DequeuePos.load(std::memory_order_relaxed);
+		}
+		value = std::move(cell->Data);
+		cell->Sequence.store(pos + m_Mask + 1, std::memory_order_release);
+		return true;
+	}
+};
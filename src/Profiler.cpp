@@ -0,0 +1,503 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+#include "Render.h"
+#include "vendor/imgui/imgui.h"
+
+using ProfilerClock = std::chrono::steady_clock;
+
+namespace {
+
+	struct CpuScope
+	{
+		const char* Name;
+		double Start; // 相对分析器启动的时间, 毫秒; 开始时没打开分析器则为负数, 结束时不记录
+	};
+
+	struct GpuScope
+	{
+		const char* Name;
+		unsigned int Depth;
+		unsigned int BeginQuery;
+		unsigned int EndQuery; // 还没结束时是 InvalidQuery
+	};
+
+	// 一帧用到的时间戳查询, 第 0 个是帧开始
+	struct GpuFrame
+	{
+		uint64_t FrameIndex = 0;
+		std::vector<unsigned int> Queries;
+		unsigned int QueryCount = 0;
+		std::vector<GpuScope> Scopes;
+		bool Pending = false;
+	};
+
+	const unsigned int InvalidQuery = 0xFFFFFFFF;
+
+}
+
+#if defined(GL_ENABLE_PROFILER)
+static std::atomic<bool> s_RequestedEnabled(true);
+#else
+static std::atomic<bool> s_RequestedEnabled(false);
+#endif
+// 只在帧边界从 s_RequestedEnabled 更新, 一帧之内的开关状态是一致的
+static std::atomic<bool> s_Enabled(false);
+
+static const ProfilerClock::time_point s_Epoch = ProfilerClock::now();
+
+// 保护 s_Current (工作线程也会往里面写) 和 s_History
+static std::mutex s_Mutex;
+static Profiler::Frame s_Current;
+static bool s_FrameActive = false;
+static uint64_t s_FrameCounter = 0;
+static std::deque<Profiler::Frame> s_History;
+
+static std::atomic<unsigned int> s_NextThreadIndex(0);
+static unsigned int s_RenderThreadIndex = 0;
+static thread_local std::vector<CpuScope> t_Scopes;
+
+// 下面的只在渲染线程访问
+static int s_GpuSupported = -1; // -1: 还没检查过 (要等有GL上下文)
+static GpuFrame s_GpuFrames[Profiler::GpuLatency];
+static GpuFrame* s_GpuCurrent = nullptr;
+static std::vector<unsigned int> s_GpuStack; // 未结束的 GPU 作用域在 Scopes 里的下标
+static unsigned int s_GpuStalls = 0;
+
+static double NowMs()
+{
+    return std::chrono::duration<double, std::milli>(ProfilerClock::now() - s_Epoch).count();
+}
+
+static unsigned int GetThreadIndex()
+{
+    static thread_local unsigned int index = s_NextThreadIndex++;
+    return index;
+}
+
+void Profiler::SetEnabled(bool enabled)
+{
+    s_RequestedEnabled = enabled;
+}
+
+bool Profiler::IsEnabled()
+{
+    return s_RequestedEnabled;
+}
+
+// ---------------- CPU ----------------
+
+void Profiler::BeginScope(const char* name)
+{
+    // 关闭时也要压栈, 保证中途打开/关闭后 Begin/End 仍然一一对应
+    t_Scopes.push_back({ name, s_Enabled ? NowMs() : -1.0 });
+}
+
+void Profiler::EndScope()
+{
+    if (t_Scopes.empty())
+        return;
+    CpuScope scope = t_Scopes.back();
+    t_Scopes.pop_back();
+    if (scope.Start < 0.0 || !s_Enabled)
+        return;
+
+    Event event;
+    event.Name = scope.Name;
+    event.Start = scope.Start; // 帧结束时再换算成相对帧开始的时间
+    event.Duration = NowMs() - scope.Start;
+    event.Depth = (unsigned int)t_Scopes.size();
+    event.Thread = GetThreadIndex();
+
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    if (s_FrameActive)
+        s_Current.Cpu.push_back(event);
+}
+
+// ---------------- GPU ----------------
+
+static unsigned int AllocateQuery(GpuFrame& frame)
+{
+    if (frame.QueryCount == frame.Queries.size())
+    {
+        size_t oldSize = frame.Queries.size();
+        size_t newSize = std::max<size_t>(oldSize * 2, 64);
+        frame.Queries.resize(newSize);
+        GLCall(glGenQueries((GLsizei)(newSize - oldSize), &frame.Queries[oldSize]));
+    }
+    return frame.QueryCount++;
+}
+
+static void IssueTimestamp(GpuFrame& frame, unsigned int query)
+{
+    GLCall(glQueryCounter(frame.Queries[query], GL_TIMESTAMP));
+}
+
+// 读回一帧的时间戳, 填到历史记录里对应的帧上
+static void ResolveGpuFrame(GpuFrame& frame)
+{
+    frame.Pending = false;
+    if (frame.QueryCount == 0)
+        return;
+
+    // 最后一个查询完成了, 前面的肯定也完成了; 没完成说明GPU落后超过 GpuLatency 帧, 读结果会等待
+    GLint available = 0;
+    GLCall(glGetQueryObjectiv(frame.Queries[frame.QueryCount - 1], GL_QUERY_RESULT_AVAILABLE, &available));
+    if (!available)
+        s_GpuStalls++;
+
+    std::vector<GLuint64> timestamps(frame.QueryCount);
+    for (unsigned int i = 0; i < frame.QueryCount; i++)
+    {
+        GLCall(glGetQueryObjectui64v(frame.Queries[i], GL_QUERY_RESULT, &timestamps[i]));
+    }
+
+    std::vector<Profiler::Event> events;
+    events.reserve(frame.Scopes.size());
+    double gpuDuration = 0.0;
+    GLuint64 base = timestamps[0];
+    for (const GpuScope& scope : frame.Scopes)
+    {
+        if (scope.EndQuery == InvalidQuery)
+            continue;
+        GLuint64 begin = timestamps[scope.BeginQuery];
+        GLuint64 end = std::max(timestamps[scope.EndQuery], begin);
+        Profiler::Event event;
+        event.Name = scope.Name;
+        event.Start = begin > base ? (begin - base) / 1.0e6 : 0.0;
+        event.Duration = (end - begin) / 1.0e6;
+        event.Depth = scope.Depth;
+        event.Thread = 0;
+        events.push_back(event);
+        gpuDuration = std::max(gpuDuration, event.Start + event.Duration);
+    }
+
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    for (auto it = s_History.rbegin(); it != s_History.rend(); ++it)
+    {
+        if (it->Index != frame.FrameIndex)
+            continue;
+        it->Gpu = std::move(events);
+        it->GpuDuration = gpuDuration;
+        it->GpuResolved = true;
+        break;
+    }
+}
+
+void Profiler::BeginGpuScope(const char* name)
+{
+    BeginScope(name);
+    if (!s_GpuCurrent)
+        return;
+
+    GpuScope scope;
+    scope.Name = name;
+    scope.Depth = (unsigned int)s_GpuStack.size();
+    scope.BeginQuery = AllocateQuery(*s_GpuCurrent);
+    scope.EndQuery = InvalidQuery;
+    IssueTimestamp(*s_GpuCurrent, scope.BeginQuery);
+    s_GpuStack.push_back((unsigned int)s_GpuCurrent->Scopes.size());
+    s_GpuCurrent->Scopes.push_back(scope);
+}
+
+void Profiler::EndGpuScope()
+{
+    if (s_GpuCurrent && !s_GpuStack.empty())
+    {
+        GpuScope& scope = s_GpuCurrent->Scopes[s_GpuStack.back()];
+        s_GpuStack.pop_back();
+        scope.EndQuery = AllocateQuery(*s_GpuCurrent);
+        IssueTimestamp(*s_GpuCurrent, scope.EndQuery);
+    }
+    EndScope();
+}
+
+// ---------------- 帧 ----------------
+
+void Profiler::BeginFrame()
+{
+    double now = NowMs();
+    bool enabled = s_RequestedEnabled;
+    s_Enabled = enabled;
+    s_RenderThreadIndex = GetThreadIndex();
+
+    uint64_t frameIndex;
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        if (s_FrameActive)
+        {
+            s_Current.Duration = now - s_Current.Start;
+            for (Event& event : s_Current.Cpu)
+                event.Start -= s_Current.Start;
+            s_History.push_back(std::move(s_Current));
+            while (s_History.size() > HistorySize)
+                s_History.pop_front();
+        }
+        s_Current = Frame();
+        s_Current.Index = frameIndex = s_FrameCounter++;
+        s_Current.Start = now;
+        s_FrameActive = enabled;
+    }
+
+    if (s_GpuSupported < 0)
+        s_GpuSupported = (GLEW_VERSION_3_3 || GLEW_ARB_timer_query) ? 1 : 0;
+
+    // 上一帧没结束的 GPU 作用域直接丢掉
+    s_GpuStack.clear();
+    s_GpuCurrent = nullptr;
+    GpuFrame& gpu = s_GpuFrames[frameIndex % GpuLatency];
+    if (gpu.Pending)
+        ResolveGpuFrame(gpu);
+    if (!enabled || !s_GpuSupported)
+        return;
+
+    gpu.FrameIndex = frameIndex;
+    gpu.QueryCount = 0;
+    gpu.Scopes.clear();
+    gpu.Pending = true;
+    IssueTimestamp(gpu, AllocateQuery(gpu));
+    s_GpuCurrent = &gpu;
+}
+
+void Profiler::Shutdown()
+{
+    s_GpuCurrent = nullptr;
+    s_GpuStack.clear();
+    for (GpuFrame& frame : s_GpuFrames)
+    {
+        if (!frame.Queries.empty())
+        {
+            GLCall(glDeleteQueries((GLsizei)frame.Queries.size(), frame.Queries.data()));
+        }
+        frame = GpuFrame();
+    }
+}
+
+bool Profiler::GetLatestFrame(Frame& frame)
+{
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    for (auto it = s_History.rbegin(); it != s_History.rend(); ++it)
+    {
+        if (it->GpuResolved || s_GpuSupported != 1)
+        {
+            frame = *it;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------- Chrome trace ----------------
+
+static void WriteJsonString(std::ofstream& out, const char* text)
+{
+    out << '"';
+    for (const char* c = text; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            out << '\\';
+        out << *c;
+    }
+    out << '"';
+}
+
+static void WriteTraceEvent(std::ofstream& out, bool& first, const char* name, const char* category,
+    double startMs, double durationMs, int pid, unsigned int tid)
+{
+    out << (first ? "\n" : ",\n");
+    first = false;
+    char times[96];
+    // Chrome trace 的时间单位是微秒
+    std::snprintf(times, sizeof(times), "\"ts\":%.3f,\"dur\":%.3f", startMs * 1000.0, durationMs * 1000.0);
+    out << "{\"name\":";
+    WriteJsonString(out, name);
+    out << ",\"cat\":\"" << category << "\",\"ph\":\"X\"," << times << ",\"pid\":" << pid << ",\"tid\":" << tid << "}";
+}
+
+bool Profiler::ExportChromeTrace(const std::string& path)
+{
+    std::deque<Frame> frames;
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        frames = s_History;
+    }
+
+    std::ofstream out(path);
+    if (!out)
+    {
+        std::cout << "Warning: failed to write profile '" << path << "'" << std::endl;
+        return false;
+    }
+
+    // pid 0 是 CPU 的各个线程, pid 1 是 GPU; GPU 时间按帧开始对齐到 CPU 的时间轴上 (两个时钟没法精确对齐)
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    out << "\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"CPU\"}}";
+    out << ",\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"GPU\"}}";
+    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << s_RenderThreadIndex << ",\"args\":{\"name\":\"Render\"}}";
+    first = false;
+
+    for (const Frame& frame : frames)
+    {
+        WriteTraceEvent(out, first, "Frame", "frame", frame.Start, frame.Duration, 0, s_RenderThreadIndex);
+        for (const Event& event : frame.Cpu)
+            WriteTraceEvent(out, first, event.Name, "cpu", frame.Start + event.Start, event.Duration, 0, event.Thread);
+        for (const Event& event : frame.Gpu)
+            WriteTraceEvent(out, first, event.Name, "gpu", frame.Start + event.Start, event.Duration, 1, 0);
+    }
+    out << "\n]}\n";
+
+    std::cout << "Wrote " << frames.size() << " profiled frames to " << path << std::endl;
+    return true;
+}
+
+// ---------------- ImGui ----------------
+
+static ImU32 GetEventColor(const char* name)
+{
+    // 同名的作用域颜色固定, 按名字哈希取色相
+    unsigned int hash = 2166136261u;
+    for (const char* c = name; *c; c++)
+        hash = (hash ^ (unsigned char)*c) * 16777619u;
+    float hue = (hash % 360) / 360.0f;
+    return ImColor::HSV(hue, 0.55f, 0.75f);
+}
+
+// 画一行 (一个线程或GPU), 返回这一行的高度
+static float DrawTimelineRow(ImDrawList* drawList, const ImVec2& origin, float width, float scale,
+    const std::vector<Profiler::Event>& events, unsigned int thread, bool matchThread)
+{
+    const float barHeight = ImGui::GetTextLineHeight() + 4.0f;
+    unsigned int maxDepth = 0;
+    ImVec2 mouse = ImGui::GetIO().MousePos;
+    for (const Profiler::Event& event : events)
+    {
+        if (matchThread && event.Thread != thread)
+            continue;
+        maxDepth = std::max(maxDepth, event.Depth);
+
+        float x0 = origin.x + (float)event.Start * scale;
+        float x1 = std::max(origin.x + (float)(event.Start + event.Duration) * scale, x0 + 1.0f);
+        if (x0 > origin.x + width)
+            continue;
+        float y0 = origin.y + event.Depth * barHeight;
+        ImVec2 min(x0, y0), max(std::min(x1, origin.x + width), y0 + barHeight - 1.0f);
+        drawList->AddRectFilled(min, max, GetEventColor(event.Name));
+
+        ImVec2 textSize = ImGui::CalcTextSize(event.Name);
+        if (textSize.x + 4.0f < max.x - min.x)
+            drawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32(255, 255, 255, 255), event.Name);
+
+        if (ImGui::IsWindowHovered() && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+            ImGui::SetTooltip("%s\n%.3f ms (start %.3f ms)", event.Name, event.Duration, event.Start);
+    }
+    return (maxDepth + 1) * barHeight;
+}
+
+void Profiler::OnImGuiRender()
+{
+    static bool paused = false;
+    static Frame displayed;
+    static bool hasFrame = false;
+    static std::string exportStatus;
+
+    ImGui::Begin("Profiler");
+
+    bool enabled = IsEnabled();
+    if (ImGui::Checkbox("Enabled", &enabled))
+        SetEnabled(enabled);
+    ImGui::SameLine();
+    ImGui::Checkbox("Pause", &paused);
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome Trace"))
+        exportStatus = ExportChromeTrace("profile.json") ? "saved profile.json" : "export failed";
+    if (!exportStatus.empty())
+    {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(exportStatus.c_str());
+    }
+
+#if !defined(GL_ENABLE_PROFILER)
+    ImGui::TextUnformatted("Built without OPENGL_PROFILER, PROFILE_SCOPE markers are compiled out");
+#endif
+
+    if (!paused)
+        hasFrame = GetLatestFrame(displayed);
+    if (!hasFrame)
+    {
+        ImGui::TextUnformatted("No profiled frames yet");
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Text("Frame %llu  CPU %.3f ms  GPU %.3f ms  (GPU stalls %u)", (unsigned long long)displayed.Index,
+        displayed.Duration, displayed.GpuDuration, s_GpuStalls);
+
+    // 时间线: 每个线程一行, 最后一行是 GPU
+    std::vector<unsigned int> threads;
+    for (const Event& event : displayed.Cpu)
+    {
+        if (std::find(threads.begin(), threads.end(), event.Thread) == threads.end())
+            threads.push_back(event.Thread);
+    }
+    std::sort(threads.begin(), threads.end());
+
+    const float labelWidth = 70.0f;
+    float width = std::max(ImGui::GetContentRegionAvail().x - labelWidth, 50.0f);
+    float span = (float)std::max(std::max(displayed.Duration, displayed.GpuDuration), 0.001);
+    float scale = width / span;
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+    for (unsigned int thread : threads)
+    {
+        ImVec2 cursor = ImGui::GetCursorScreenPos();
+        if (thread == s_RenderThreadIndex)
+            drawList->AddText(cursor, IM_COL32(200, 200, 200, 255), "Render");
+        else
+        {
+            char label[32];
+            std::snprintf(label, sizeof(label), "Thread %u", thread);
+            drawList->AddText(cursor, IM_COL32(200, 200, 200, 255), label);
+        }
+        float height = DrawTimelineRow(drawList, ImVec2(cursor.x + labelWidth, cursor.y), width, scale, displayed.Cpu, thread, true);
+        ImGui::Dummy(ImVec2(labelWidth + width, height + 4.0f));
+    }
+    if (!displayed.Gpu.empty())
+    {
+        ImVec2 cursor = ImGui::GetCursorScreenPos();
+        drawList->AddText(cursor, IM_COL32(200, 200, 200, 255), "GPU");
+        float height = DrawTimelineRow(drawList, ImVec2(cursor.x + labelWidth, cursor.y), width, scale, displayed.Gpu, 0, false);
+        ImGui::Dummy(ImVec2(labelWidth + width, height + 4.0f));
+    }
+
+    // 按名字汇总, 看时间都花在哪
+    if (ImGui::CollapsingHeader("Totals"))
+    {
+        std::unordered_map<const char*, double> cpuTotals, gpuTotals;
+        for (const Event& event : displayed.Cpu)
+            cpuTotals[event.Name] += event.Duration;
+        for (const Event& event : displayed.Gpu)
+            gpuTotals[event.Name] += event.Duration;
+
+        std::vector<std::pair<const char*, double>> sorted(cpuTotals.begin(), cpuTotals.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+        for (const auto& total : sorted)
+        {
+            auto gpu = gpuTotals.find(total.first);
+            if (gpu != gpuTotals.end())
+                ImGui::Text("%-32s CPU %8.3f ms  GPU %8.3f ms", total.first, total.second, gpu->second);
+            else
+                ImGui::Text("%-32s CPU %8.3f ms", total.first, total.second);
+        }
+    }
+
+    ImGui::End();
+}
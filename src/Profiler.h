@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * 内置性能分析器:
+ *      PROFILE_SCOPE(name) 记录当前作用域的 CPU 耗时 (steady_clock), 任何线程都可以用, 嵌套深度按线程分别记录;
+ *      PROFILE_GPU_SCOPE(name) 额外在作用域前后各插一个 GL_TIMESTAMP 查询, 只能在渲染线程 (有GL上下文) 用。
+ *      GPU 计时用 glQueryCounter 时间戳而不是 GL_TIME_ELAPSED: 后者同一时刻只能有一个活动的查询, 不能嵌套。
+ *      查询对象按帧分成 GpuLatency 组轮流使用, 第 N 帧的结果在第 N + GpuLatency 帧开头才去读, 正常情况下早就完成了, 不会等GPU。
+ *      每帧的结果保存最近 HistorySize 帧, OnImGuiRender 画成时间线, ExportChromeTrace 导出成 chrome://tracing (Perfetto) 能打开的 JSON。
+ * name 必须是字符串字面量之类生命周期足够长的字符串, 这里只保存指针。
+ * 编译时没有定义 GL_ENABLE_PROFILER (CMake 选项 OPENGL_PROFILER) 时宏展开成空, 一点开销都没有。
+ */
+class Profiler
+{
+public:
+	struct Event
+	{
+		const char* Name;
+		double Start;    // 相对帧开始的时间, 毫秒
+		double Duration; // 毫秒
+		unsigned int Depth;
+		unsigned int Thread; // 线程编号, 按第一次记录的顺序分配, GPU 事件都是 0
+	};
+
+	struct Frame
+	{
+		uint64_t Index = 0;
+		double Start = 0.0;    // 相对分析器启动的时间, 毫秒
+		double Duration = 0.0; // CPU 帧间隔, 毫秒
+		double GpuDuration = 0.0; // 帧开始到最后一个 GPU 事件结束, 毫秒
+		std::vector<Event> Cpu;
+		std::vector<Event> Gpu;
+		bool GpuResolved = false;
+	};
+
+	static const unsigned int HistorySize = 300;
+	static const unsigned int GpuLatency = 3; // 查询对象组数 (三缓冲)
+
+	// 运行时开关, 关闭后作用域宏只剩一次判断
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled();
+
+	// 渲染线程每帧开始时调用: 结束上一帧, 读回 GpuLatency 帧之前的 GPU 查询
+	static void BeginFrame();
+	// 删除查询对象, 要在GL上下文销毁之前调用
+	static void Shutdown();
+
+	static void BeginScope(const char* name);
+	static void EndScope();
+	static void BeginGpuScope(const char* name);
+	static void EndGpuScope();
+
+	// 最近一个 GPU 结果已经读回的帧, 没有时返回 false
+	static bool GetLatestFrame(Frame& frame);
+	// 把保存的所有帧写成 Chrome trace 格式
+	static bool ExportChromeTrace(const std::string& path);
+
+	// "Profiler" 窗口: 帧时间线 (火焰图) 和导出按钮
+	static void OnImGuiRender();
+};
+
+class ProfileScope
+{
+public:
+	ProfileScope(const char* name) { Profiler::BeginScope(name); }
+	~ProfileScope() { Profiler::EndScope(); }
+};
+
+class GpuProfileScope
+{
+public:
+	GpuProfileScope(const char* name) { Profiler::BeginGpuScope(name); }
+	~GpuProfileScope() { Profiler::EndGpuScope(); }
+};
+
+#if defined(GL_ENABLE_PROFILER)
+	#define PROFILE_SCOPE_CONCAT2(a, b) a##b
+	#define PROFILE_SCOPE_CONCAT(a, b) PROFILE_SCOPE_CONCAT2(a, b)
+	#define PROFILE_SCOPE(name) ProfileScope PROFILE_SCOPE_CONCAT(profileScope, __LINE__)(name)
+	#define PROFILE_GPU_SCOPE(name) GpuProfileScope PROFILE_SCOPE_CONCAT(gpuProfileScope, __LINE__)(name)
+	#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#else
+	#define PROFILE_SCOPE(name)
+	#define PROFILE_GPU_SCOPE(name)
+	#define PROFILE_FUNCTION()
+#endif
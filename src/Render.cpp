@@ -1,5 +1,14 @@
 #include "Render.h"
 #include "Shader.h"
+#include "GeometryPool.h"
+#include "DrawCommandBuffer.h"
+#include "DynamicIndexBuffer.h"
+#include "Profiler.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
 
 void GLClearError()
 {
@@ -17,13 +26,121 @@ bool GLLogCall(const char* function, const char* file, int line)
     return true;   
 }
 
+// ---------------- KHR_debug ----------------
+
+struct GLCallSite
+{
+    const char* Function = nullptr;
+    const char* File = nullptr;
+    int Line = 0;
+};
+
+static bool s_DebugOutputActive = false;
+static bool s_DebugOutputSynchronous = false;
+static std::atomic<bool> s_DebugOutputError(false);
+static GLCallSite s_LastCallSite;
+// 异步模式下回调可能在驱动线程里执行, 调试分组栈根据回调收到的 PUSH/POP 消息重建, 和错误消息顺序一致
+static std::mutex s_DebugGroupMutex;
+static std::vector<std::string> s_DebugGroups;
+
+#if defined(GL_USE_DEBUG_OUTPUT)
+bool g_GLDebugOutputEnabled = false;
+
+void GLSetCallSite(const char* function, const char* file, int line)
+{
+    s_LastCallSite.Function = function;
+    s_LastCallSite.File = file;
+    s_LastCallSite.Line = line;
+}
+
+bool GLCheckDebugOutputError()
+{
+    // 异步模式下错误稍后才会报告, 这里没法断在出错的调用上
+    if (!s_DebugOutputSynchronous)
+        return true;
+    return !s_DebugOutputError.exchange(false);
+}
+#endif
+
+static void GLAPIENTRY GLDebugMessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+    GLsizei length, const GLchar* message, const void* userParam)
+{
+    std::lock_guard<std::mutex> lock(s_DebugGroupMutex);
+    if (type == GL_DEBUG_TYPE_PUSH_GROUP)
+    {
+        s_DebugGroups.push_back(message);
+        return;
+    }
+    if (type == GL_DEBUG_TYPE_POP_GROUP)
+    {
+        if (!s_DebugGroups.empty())
+            s_DebugGroups.pop_back();
+        return;
+    }
+    if (severity == GL_DEBUG_SEVERITY_NOTIFICATION)
+        return;
+
+    std::cout << "[OpenGL Debug] (" << id << "): " << message << std::endl;
+    for (auto it = s_DebugGroups.rbegin(); it != s_DebugGroups.rend(); ++it)
+        std::cout << "    in " << *it << std::endl;
+    if (s_DebugOutputSynchronous && s_LastCallSite.Function)
+        std::cout << "    at " << s_LastCallSite.Function << " " << s_LastCallSite.File << ":" << s_LastCallSite.Line << std::endl;
+
+    if (type == GL_DEBUG_TYPE_ERROR)
+        s_DebugOutputError = true;
+}
+
+bool GLEnableDebugOutput(bool synchronous)
+{
+    if (!GLEW_KHR_debug)
+    {
+        std::cout << "Warning: KHR_debug not supported, GLCall keeps polling glGetError" << std::endl;
+        return false;
+    }
+
+    s_DebugOutputSynchronous = synchronous;
+    glEnable(GL_DEBUG_OUTPUT);
+    if (synchronous)
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    else
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    glDebugMessageCallback(GLDebugMessageCallback, nullptr);
+    // 分组消息要打开, 回调靠它们重建分组栈
+    glDebugMessageControl(GL_DEBUG_SOURCE_APPLICATION, GL_DEBUG_TYPE_PUSH_GROUP, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+    glDebugMessageControl(GL_DEBUG_SOURCE_APPLICATION, GL_DEBUG_TYPE_POP_GROUP, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+
+    s_DebugOutputActive = true;
+#if defined(GL_USE_DEBUG_OUTPUT)
+    g_GLDebugOutputEnabled = true;
+#endif
+    return true;
+}
+
+GLDebugScope::GLDebugScope(const char* name, const char* file, int line)
+{
+    if (!s_DebugOutputActive)
+        return;
+    std::string label = std::string(name) + " (" + file + ":" + std::to_string(line) + ")";
+    glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, label.c_str());
+}
+
+GLDebugScope::~GLDebugScope()
+{
+    if (s_DebugOutputActive)
+        glPopDebugGroup();
+}
+
+// ---------------- Renderer ----------------
+
 void Renderer::Clear() const
 {
+    PROFILE_SCOPE("Renderer::Clear");
     GLCall(glClear(GL_COLOR_BUFFER_BIT));
 }
 
 void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const
 {
+    GL_DEBUG_SCOPE("Renderer::Draw");
     shader.Bind(); /* 为GPU绑定着色器程序 */
     va.Bind(); /* 包含实际处理数据的数组 */
     ib.Bind();
@@ -32,4 +149,89 @@ void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader&
     // glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr); # 通过一个额外的索引缓冲（EBO）以间接、非连续的方式从VBO中读取数据。
     // GLCall(glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr));
     GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr));
-}
\ No newline at end of file
+}
+
+void Renderer::Draw(const VertexArray& va, const DynamicIndexBuffer& ib, const Shader& shader, unsigned int count, unsigned int offset) const
+{
+    GL_DEBUG_SCOPE("Renderer::Draw");
+    shader.Bind();
+    va.Bind();
+    ib.Bind();
+
+    GLCall(glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (const void*)(uintptr_t)offset));
+}
+
+void Renderer::DrawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount, unsigned int baseInstance) const
+{
+    GL_DEBUG_SCOPE("Renderer::DrawInstanced");
+    PROFILE_SCOPE("Renderer::DrawInstanced");
+    shader.Bind();
+    va.Bind();
+    ib.Bind();
+
+    if (baseInstance == 0)
+    {
+        GLCall(glDrawElementsInstanced(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr, instanceCount));
+    }
+    else
+    {
+        ASSERT(IsBaseInstanceSupported());
+        GLCall(glDrawElementsInstancedBaseInstance(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr, instanceCount, baseInstance));
+    }
+}
+
+unsigned int Renderer::DrawIndirect(const GeometryPool& pool, DrawCommandBuffer& commands, const Shader& shader) const
+{
+    if (commands.GetCount() == 0)
+        return 0;
+
+    GL_DEBUG_SCOPE("Renderer::DrawIndirect");
+    PROFILE_SCOPE("Renderer::DrawIndirect");
+    shader.Bind();
+    pool.Bind();
+
+    unsigned int offset = commands.Upload();
+    unsigned int stride = (unsigned int)sizeof(DrawElementsIndirectCommand);
+    switch (commands.GetSubmitMode())
+    {
+        case DrawCommandBuffer::SubmitMode::MultiDrawIndirect:
+        {
+            GLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*)(uintptr_t)offset, commands.GetCount(), 0));
+            return 1;
+        }
+        case DrawCommandBuffer::SubmitMode::DrawIndirect:
+        {
+            for (unsigned int i = 0; i < commands.GetCount(); i++)
+            {
+                GLCall(glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*)(uintptr_t)(offset + i * stride)));
+            }
+            return commands.GetCount();
+        }
+        case DrawCommandBuffer::SubmitMode::Direct:
+        {
+            // 没有 base instance 时 BaseInstance 只能忽略, 逐实例属性从0开始
+            bool baseInstance = IsBaseInstanceSupported();
+            for (const DrawElementsIndirectCommand& command : commands.GetCommands())
+            {
+                const void* indices = (const void*)(uintptr_t)(command.FirstIndex * sizeof(unsigned int));
+                if (baseInstance)
+                {
+                    GLCall(glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, command.Count, GL_UNSIGNED_INT, indices,
+                        command.InstanceCount, command.BaseVertex, command.BaseInstance));
+                }
+                else
+                {
+                    GLCall(glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command.Count, GL_UNSIGNED_INT, indices,
+                        command.InstanceCount, command.BaseVertex));
+                }
+            }
+            return commands.GetCount();
+        }
+    }
+    return 0;
+}
+
+bool Renderer::IsBaseInstanceSupported()
+{
+    return GLEW_VERSION_4_2 || GLEW_ARB_base_instance;
+}
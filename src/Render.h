@@ -8,20 +8,95 @@
 #include "IndexBuffer.h"
 #include "Shader.h"
 
+class GeometryPool;
+class DrawCommandBuffer;
+class DynamicIndexBuffer;
+
 
 // 错误检查
 #define ASSERT(x) if(!(x)) __builtin_trap();  // 宏替换的细节 (x)
-#define GLCall(x) GLClearError();\
-    x;\
-    ASSERT(GLLogCall(#x, __FILE__, __LINE__))
+
+/**
+ * GLCall 的三种模式:
+ *      release (定义了 NDEBUG):   展开成裸调用, 没有任何额外开销。
+ *      GL_USE_DEBUG_OUTPUT:       用 KHR_debug 的 glDebugMessageCallback 报错, 每次调用只记录一下调用位置;
+ *                                 驱动不支持 KHR_debug 时 (比如 macOS) 自动退回 glGetError 轮询。
+ *      默认 (debug):              每次调用前清空错误, 调用后 glGetError 检查。每次都要和驱动同步一次, 很慢。
+ */
+#if defined(NDEBUG)
+    #define GLCall(x) x
+#elif defined(GL_USE_DEBUG_OUTPUT)
+    #define GLCall(x) GLBeginCall(#x, __FILE__, __LINE__);\
+        x;\
+        ASSERT(GLEndCall(#x, __FILE__, __LINE__))
+#else
+    #define GLCall(x) GLClearError();\
+        x;\
+        ASSERT(GLLogCall(#x, __FILE__, __LINE__))
+#endif
+
+// 调试分组: 在 RenderDoc 之类的工具里能看到, 异步回调报错时也会打印当时所在的分组 (带文件和行号)
+#if defined(GL_USE_DEBUG_OUTPUT) && !defined(NDEBUG)
+    #define GL_DEBUG_SCOPE_CONCAT2(a, b) a##b
+    #define GL_DEBUG_SCOPE_CONCAT(a, b) GL_DEBUG_SCOPE_CONCAT2(a, b)
+    #define GL_DEBUG_SCOPE(name) GLDebugScope GL_DEBUG_SCOPE_CONCAT(glDebugScope, __LINE__)(name, __FILE__, __LINE__)
+#else
+    #define GL_DEBUG_SCOPE(name)
+#endif
 
 
 void GLClearError();
 bool GLLogCall(const char* function, const char* file, int line);
 
+// 打开 KHR_debug 回调, synchronous 为 true 时回调在出错的那个GL调用里执行, 可以直接断在出错的 GLCall 上;
+// 为 false 时驱动可以异步报告 (开销最小), 只能靠调试分组定位。返回驱动是否支持。
+bool GLEnableDebugOutput(bool synchronous);
+
+// 由 CMake 的 OPENGL_DEBUG_OUTPUT_SYNC 选项定义; 不是 GL_ 前缀, 免得和 GL_DEBUG_OUTPUT_SYNCHRONOUS 之类的GL枚举混淆
+#ifndef OPENGL_DEBUG_OUTPUT_SYNC
+    #define OPENGL_DEBUG_OUTPUT_SYNC true
+#endif
+
+#if defined(GL_USE_DEBUG_OUTPUT)
+// GLCall 在 debug output 模式下的前后处理
+extern bool g_GLDebugOutputEnabled;
+void GLSetCallSite(const char* function, const char* file, int line);
+bool GLCheckDebugOutputError();
+
+inline void GLBeginCall(const char* function, const char* file, int line)
+{
+    if (g_GLDebugOutputEnabled)
+        GLSetCallSite(function, file, line);
+    else
+        GLClearError();
+}
+
+inline bool GLEndCall(const char* function, const char* file, int line)
+{
+    if (g_GLDebugOutputEnabled)
+        return GLCheckDebugOutputError();
+    return GLLogCall(function, file, line);
+}
+#endif
+
+class GLDebugScope
+{
+public:
+    GLDebugScope(const char* name, const char* file, int line);
+    ~GLDebugScope();
+};
+
 class Renderer
 {
 public:
     void Clear() const;
     void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const;
+    // 索引是每帧流式上传的: 画 ib 里从字节偏移 offset (DynamicIndexBuffer::SetData 的返回值) 开始的 count 个索引
+    void Draw(const VertexArray& va, const DynamicIndexBuffer& ib, const Shader& shader, unsigned int count, unsigned int offset) const;
+    // 一次 draw call 画 instanceCount 份同样的网格, 逐实例的数据由 va 里 divisor 不为0的属性提供
+    // baseInstance 是逐实例属性的起始下标 (数据写在环形缓冲中间时用), 不为0时需要 GL 4.2 / ARB_base_instance
+    void DrawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount, unsigned int baseInstance = 0) const;
+    // 一次提交 commands 里的所有命令, 几何数据都来自 pool (见 DrawCommandBuffer), 返回实际发出的 draw call 数
+    unsigned int DrawIndirect(const GeometryPool& pool, DrawCommandBuffer& commands, const Shader& shader) const;
+    static bool IsBaseInstanceSupported();
 };
\ No newline at end of file
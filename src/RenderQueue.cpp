@@ -0,0 +1,131 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+#include "GLState.h"
+#include "Profiler.h"
+
+RenderQueue::RenderQueue()
+    : m_SortEnabled(true)
+{
+}
+
+uint64_t RenderQueue::MakeSortKey(const RenderItem& item)
+{
+    uint64_t layer = std::min(item.Layer, 255u);
+    uint64_t shader = item.ShaderProgram->GetRendererID() & 0xfff;
+    uint64_t texture = (item.Tex ? item.Tex->GetRendererID() : 0) & 0xfff;
+    uint64_t vao = item.VAO->GetRendererID() & 0x7f;
+    uint64_t depth = (uint64_t)(std::clamp(item.Depth, 0.0f, 1.0f) * 0xffffff);
+
+    if (!item.Translucent)
+        return (layer << 56) | (shader << 43) | (texture << 31) | (vao << 24) | depth;
+    return (layer << 56) | (1ull << 55) | ((0xffffff - depth) << 31) | (shader << 19) | (texture << 7) | vao;
+}
+
+void RenderQueue::Submit(const RenderItem& item)
+{
+    Submit(item, MakeSortKey(item));
+}
+
+void RenderQueue::Submit(const RenderItem& item, uint64_t sortKey)
+{
+    m_Items.push_back(item);
+    m_Keys.push_back(sortKey);
+}
+
+const std::vector<uint32_t>& RenderQueue::Sort()
+{
+    size_t count = m_Items.size();
+    for (int i = 0; i < 2; i++)
+    {
+        m_SortKeys[i].resize(count);
+        m_SortIndices[i].resize(count);
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        m_SortKeys[0][i] = m_Keys[i];
+        m_SortIndices[0][i] = (uint32_t)i;
+    }
+    if (!m_SortEnabled)
+        return m_SortIndices[0];
+
+    // LSD 基数排序, 每趟 8 位, 共 8 趟; 所有键在这 8 位上都相同时跳过这一趟
+    int src = 0;
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        unsigned int histogram[256] = {};
+        for (size_t i = 0; i < count; i++)
+            histogram[(m_SortKeys[src][i] >> shift) & 0xff]++;
+        if (histogram[(m_SortKeys[src][0] >> shift) & 0xff] == count)
+            continue;
+
+        unsigned int offsets[256];
+        unsigned int sum = 0;
+        for (int b = 0; b < 256; b++)
+        {
+            offsets[b] = sum;
+            sum += histogram[b];
+        }
+
+        int dst = 1 - src;
+        for (size_t i = 0; i < count; i++)
+        {
+            unsigned int slot = offsets[(m_SortKeys[src][i] >> shift) & 0xff]++;
+            m_SortKeys[dst][slot] = m_SortKeys[src][i];
+            m_SortIndices[dst][slot] = m_SortIndices[src][i];
+        }
+        src = dst;
+    }
+    return m_SortIndices[src];
+}
+
+void RenderQueue::Flush(const Renderer& renderer)
+{
+    m_Stats = Statistics();
+    m_Stats.Submitted = (unsigned int)m_Items.size();
+    if (m_Items.empty())
+        return;
+
+    GL_DEBUG_SCOPE("RenderQueue::Flush");
+    PROFILE_GPU_SCOPE("RenderQueue::Flush");
+    const std::vector<uint32_t>& order = Sort();
+
+    const Shader* lastShader = nullptr;
+    const Texture* lastTexture = nullptr;
+    const VertexArray* lastVAO = nullptr;
+    UniformHandle model;
+    for (uint32_t index : order)
+    {
+        const RenderItem& item = m_Items[index];
+        if (item.ShaderProgram != lastShader)
+        {
+            // 句柄只在换着色器时查一次
+            model = item.ShaderProgram->GetUniformHandle("u_Model");
+            lastShader = item.ShaderProgram;
+            m_Stats.ShaderChanges++;
+        }
+        if (item.Tex != lastTexture)
+        {
+            lastTexture = item.Tex;
+            m_Stats.TextureChanges++;
+        }
+        if (item.VAO != lastVAO)
+        {
+            lastVAO = item.VAO;
+            m_Stats.VertexArrayChanges++;
+        }
+
+        GLState::SetBlend(item.Translucent);
+        if (item.Translucent)
+            GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        if (item.Tex)
+            item.Tex->Bind(0);
+        item.ShaderProgram->Bind();
+        item.ShaderProgram->SetUniformMat4f(model, item.Model);
+        renderer.Draw(*item.VAO, *item.IB, *item.ShaderProgram);
+    }
+
+    m_Items.clear();
+    m_Keys.clear();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Render.h"
+#include "Texture.h"
+
+// 提交给 RenderQueue 的一次绘制, 指针指向的对象要活到 Flush 之后
+struct RenderItem
+{
+	const VertexArray* VAO = nullptr;
+	const IndexBuffer* IB = nullptr;
+	Shader* ShaderProgram = nullptr;
+	const Texture* Tex = nullptr; // 绑定到 0 号纹理单元, 可以为空
+	glm::mat4 Model = glm::mat4(1.0f); // 设置到着色器的 u_Model
+	unsigned int Layer = 0;   // 0-255, 小的先画 (比如 UI 放在更大的层)
+	bool Translucent = false; // 透明物体开混合, 在同一层的不透明物体之后从远到近画
+	float Depth = 0.0f;       // 0 (近) - 1 (远), 超出范围会被截断
+};
+
+/**
+ * 延迟提交的渲染队列:
+ *      Submit 只是记录, Flush 时按 64 位排序键做基数排序后再依次 Draw, 让相同的着色器/纹理/VAO 排在一起,
+ *      配合 GLState 跳过重复的绑定。
+ * 排序键 (高位在前):
+ *      不透明: | 层 8 | 0 | 着色器 12 | 纹理 12 | VAO 7 | 深度 24 |   同一状态内从近到远, 减少 overdraw
+ *      透明:   | 层 8 | 1 | 深度取反 24 | 着色器 12 | 纹理 12 | VAO 7 |   必须从远到近, 状态只是次要的
+ *      着色器/纹理/VAO 用 GL 对象 ID 的低位, 偶尔撞了只影响排序的紧凑程度, 不影响正确性。
+ */
+class RenderQueue
+{
+public:
+	struct Statistics
+	{
+		unsigned int Submitted = 0;
+		unsigned int ShaderChanges = 0;
+		unsigned int TextureChanges = 0;
+		unsigned int VertexArrayChanges = 0;
+	};
+
+private:
+	std::vector<RenderItem> m_Items;
+	std::vector<uint64_t> m_Keys;
+	// 基数排序用的 (键, 下标) 双缓冲
+	std::vector<uint64_t> m_SortKeys[2];
+	std::vector<uint32_t> m_SortIndices[2];
+	bool m_SortEnabled;
+	Statistics m_Stats;
+
+public:
+	RenderQueue();
+
+	void Submit(const RenderItem& item);
+	// 排序键已经算好了 (比如工作线程录制时算的)
+	void Submit(const RenderItem& item, uint64_t sortKey);
+	// 排序并画出所有提交的绘制, 然后清空队列
+	void Flush(const Renderer& renderer);
+
+	// 关掉排序时按提交顺序画, 用来对比
+	inline void SetSortEnabled(bool enabled) { m_SortEnabled = enabled; }
+	inline bool IsSortEnabled() const { return m_SortEnabled; }
+	inline const Statistics& GetStats() const { return m_Stats; }
+
+	static uint64_t MakeSortKey(const RenderItem& item);
+
+private:
+	// 按键从小到大排序, 结果是 m_Items 的下标
+	const std::vector<uint32_t>& Sort();
+};
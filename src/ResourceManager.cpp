@@ -0,0 +1,256 @@
+#include "ResourceManager.h"
+
+#include <iostream>
+
+#include "Profiler.h"
+
+ResourceManager* ResourceManager::s_Instance = nullptr;
+
+ResourceManager::ResourceManager(size_t textureBudget)
+    : m_Budget(textureBudget), m_TextureMemory(0), m_Frame(0)
+{
+    s_Instance = this;
+}
+
+ResourceManager::~ResourceManager()
+{
+    // 还有引用说明有对象忘了 Release, 资源照样删除, 之后它手里的句柄都会失效
+    for (const Slot<Texture>& slot : m_Textures.Slots)
+    {
+        if (slot.Resource && slot.RefCount > 0)
+            std::cout << "Warning: texture '" << slot.Key << "' still has " << slot.RefCount << " references" << std::endl;
+    }
+    for (const Slot<Shader>& slot : m_Shaders.Slots)
+    {
+        if (slot.Resource && slot.RefCount > 0)
+            std::cout << "Warning: shader '" << slot.Key << "' still has " << slot.RefCount << " references" << std::endl;
+    }
+
+    if (s_Instance == this)
+        s_Instance = nullptr;
+}
+
+ResourceManager& ResourceManager::Get()
+{
+    ASSERT(s_Instance);
+    return *s_Instance;
+}
+
+std::string ResourceManager::MakeTextureKey(const std::string& path, const TextureSpec& spec)
+{
+    // 参数不同的同一张图是不同的GPU对象 (比如一个要 mipmap, 一个不要)
+    return path + "|" + std::to_string((int)spec.Filter) + std::to_string((int)spec.Wrap) + std::to_string((int)spec.GenerateMips)
+        + std::to_string((int)spec.KeepChannels) + "|" + std::to_string(spec.Anisotropy);
+}
+
+template<typename T>
+ResourceManager::Slot<T>* ResourceManager::Resolve(Pool<T>& pool, ResourceHandle<T> handle)
+{
+    if (handle.Index >= pool.Slots.size())
+        return nullptr;
+    Slot<T>& slot = pool.Slots[handle.Index];
+    if (!slot.Resource || slot.Generation != handle.Generation)
+        return nullptr;
+    return &slot;
+}
+
+template<typename T>
+ResourceHandle<T> ResourceManager::Acquire(Pool<T>& pool, const std::string& key)
+{
+    auto it = pool.Lookup.find(key);
+    if (it == pool.Lookup.end())
+        return ResourceHandle<T>();
+
+    Slot<T>& slot = pool.Slots[it->second];
+    slot.RefCount++;
+    slot.LastUsedFrame = m_Frame;
+    m_Stats.CacheHits++;
+    return { it->second, slot.Generation };
+}
+
+template<typename T>
+ResourceHandle<T> ResourceManager::Insert(Pool<T>& pool, const std::string& key, std::unique_ptr<T> resource, size_t memorySize)
+{
+    uint32_t index;
+    if (!pool.FreeSlots.empty())
+    {
+        index = pool.FreeSlots.back();
+        pool.FreeSlots.pop_back();
+    }
+    else
+    {
+        index = (uint32_t)pool.Slots.size();
+        pool.Slots.emplace_back();
+    }
+
+    Slot<T>& slot = pool.Slots[index];
+    slot.Resource = std::move(resource);
+    slot.Key = key;
+    slot.RefCount = 1;
+    slot.MemorySize = memorySize;
+    slot.LastUsedFrame = m_Frame;
+    pool.Lookup[key] = index;
+    m_Stats.Loads++;
+    return { index, slot.Generation };
+}
+
+template<typename T>
+void ResourceManager::Free(Pool<T>& pool, uint32_t index)
+{
+    Slot<T>& slot = pool.Slots[index];
+    pool.Lookup.erase(slot.Key);
+    slot.Resource.reset();
+    slot.Key.clear();
+    slot.RefCount = 0;
+    slot.MemorySize = 0;
+    slot.Generation++; // 之前发出去的句柄全部失效
+    pool.FreeSlots.push_back(index);
+}
+
+template<typename T>
+void ResourceManager::Release(Pool<T>& pool, ResourceHandle<T> handle)
+{
+    Slot<T>* slot = Resolve(pool, handle);
+    if (!slot)
+        return;
+    ASSERT(slot->RefCount > 0);
+    // 到 0 也先留在缓存里, 超出预算时才由 EnforceBudget 删除
+    slot->RefCount--;
+    slot->LastUsedFrame = m_Frame;
+}
+
+TextureHandle ResourceManager::LoadTexture(const std::string& path, const TextureSpec& spec)
+{
+    std::string key = MakeTextureKey(path, spec);
+    TextureHandle handle = Acquire(m_Textures, key);
+    if (handle.IsValid())
+        return handle;
+
+    PROFILE_SCOPE("ResourceManager::LoadTexture");
+    auto texture = std::make_unique<Texture>(path, spec);
+    size_t memorySize = texture->GetMemorySize();
+    m_TextureMemory += memorySize;
+    handle = Insert(m_Textures, key, std::move(texture), memorySize);
+    // 新纹理有引用, 不会被删; 腾地方的是之前缓存的
+    EnforceBudget();
+    return handle;
+}
+
+ShaderHandle ResourceManager::LoadShader(const std::string& path)
+{
+    ShaderHandle handle = Acquire(m_Shaders, path);
+    if (handle.IsValid())
+        return handle;
+
+    PROFILE_SCOPE("ResourceManager::LoadShader");
+    return Insert(m_Shaders, path, std::make_unique<Shader>(path), 0);
+}
+
+void ResourceManager::AddRef(TextureHandle handle)
+{
+    if (Slot<Texture>* slot = Resolve(m_Textures, handle))
+        slot->RefCount++;
+}
+
+void ResourceManager::AddRef(ShaderHandle handle)
+{
+    if (Slot<Shader>* slot = Resolve(m_Shaders, handle))
+        slot->RefCount++;
+}
+
+void ResourceManager::Release(TextureHandle handle)
+{
+    Release(m_Textures, handle);
+}
+
+void ResourceManager::Release(ShaderHandle handle)
+{
+    Release(m_Shaders, handle);
+}
+
+Texture* ResourceManager::GetTexture(TextureHandle handle)
+{
+    Slot<Texture>* slot = Resolve(m_Textures, handle);
+    if (!slot)
+        return nullptr;
+    slot->LastUsedFrame = m_Frame;
+    return slot->Resource.get();
+}
+
+Shader* ResourceManager::GetShader(ShaderHandle handle)
+{
+    Slot<Shader>* slot = Resolve(m_Shaders, handle);
+    if (!slot)
+        return nullptr;
+    slot->LastUsedFrame = m_Frame;
+    return slot->Resource.get();
+}
+
+void ResourceManager::Update()
+{
+    m_Frame++;
+    EnforceBudget();
+}
+
+void ResourceManager::EnforceBudget()
+{
+    while (m_TextureMemory > m_Budget)
+    {
+        // 缓存里的纹理一般只有几十张, 每次线性找最久没用的就够了
+        uint32_t oldest = 0xFFFFFFFF;
+        for (uint32_t i = 0; i < (uint32_t)m_Textures.Slots.size(); i++)
+        {
+            const Slot<Texture>& slot = m_Textures.Slots[i];
+            if (!slot.Resource || slot.RefCount > 0)
+                continue;
+            if (oldest == 0xFFFFFFFF || slot.LastUsedFrame < m_Textures.Slots[oldest].LastUsedFrame)
+                oldest = i;
+        }
+        // 剩下的都有人在用, 只能超预算
+        if (oldest == 0xFFFFFFFF)
+            return;
+
+        m_TextureMemory -= m_Textures.Slots[oldest].MemorySize;
+        Free(m_Textures, oldest);
+        m_Stats.Evictions++;
+    }
+}
+
+void ResourceManager::EvictUnused()
+{
+    for (uint32_t i = 0; i < (uint32_t)m_Textures.Slots.size(); i++)
+    {
+        Slot<Texture>& slot = m_Textures.Slots[i];
+        if (slot.Resource && slot.RefCount == 0)
+        {
+            m_TextureMemory -= slot.MemorySize;
+            Free(m_Textures, i);
+        }
+    }
+    for (uint32_t i = 0; i < (uint32_t)m_Shaders.Slots.size(); i++)
+    {
+        if (m_Shaders.Slots[i].Resource && m_Shaders.Slots[i].RefCount == 0)
+            Free(m_Shaders, i);
+    }
+}
+
+void ResourceManager::SetBudget(size_t bytes)
+{
+    m_Budget = bytes;
+    EnforceBudget();
+}
+
+void ResourceManager::GetEntries(std::vector<EntryInfo>& entries) const
+{
+    entries.clear();
+    for (const Slot<Texture>& slot : m_Textures.Slots)
+    {
+        if (slot.Resource)
+            entries.push_back({ slot.Key, true, slot.RefCount, slot.MemorySize, slot.LastUsedFrame });
+    }
+    for (const Slot<Shader>& slot : m_Shaders.Slots)
+    {
+        if (slot.Resource)
+            entries.push_back({ slot.Key, false, slot.RefCount, slot.MemorySize, slot.LastUsedFrame });
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Texture.h"
+#include "Shader.h"
+
+// 资源句柄: 槽位下标 + 代数。槽位里的资源被删除时代数加一, 旧句柄就解析不到东西了, 不会拿到重用这个槽位的新资源
+template<typename T>
+struct ResourceHandle
+{
+	uint32_t Index = 0xFFFFFFFF;
+	uint32_t Generation = 0;
+
+	inline bool IsValid() const { return Index != 0xFFFFFFFF; }
+	inline bool operator==(const ResourceHandle& other) const { return Index == other.Index && Generation == other.Generation; }
+	inline bool operator!=(const ResourceHandle& other) const { return !(*this == other); }
+};
+
+using TextureHandle = ResourceHandle<Texture>;
+using ShaderHandle = ResourceHandle<Shader>;
+
+/**
+ * 资源管理:
+ *      纹理按 (路径, TextureSpec)、着色器按路径去重, 同一个文件只解码/编译一次, 不同的 Test 拿到的是同一个GPU对象。
+ *      Load 返回句柄并把引用计数加一, 不用了调用 Release 减一。
+ *      引用计数到 0 的资源不会马上删除, 留在缓存里, 下次 Load 直接复用 (切换 Test 不用重新加载);
+ *      缓存的纹理显存总量超过预算时, 按最近最少使用 (LRU) 的顺序删除没人用的纹理, 直到回到预算以内。
+ *      有人用的资源永远不会被删除, 所以持有句柄期间 GetTexture / GetShader 总是有效。
+ * 用法:
+ *      TextureHandle logo = ResourceManager::Get().LoadTexture("res/logo.png");
+ *      renderer.DrawQuad(position, size, *ResourceManager::Get().GetTexture(logo));
+ *      ResourceManager::Get().Release(logo); // 析构时
+ * 所有函数都必须在渲染线程调用; main 里要在所有 Test 删除之后、ShaderHotReload 和GL上下文销毁之前析构。
+ */
+class ResourceManager
+{
+public:
+	struct Statistics
+	{
+		unsigned int Loads = 0;     // 真正从文件加载的次数
+		unsigned int CacheHits = 0; // Load 时已经在缓存里的次数
+		unsigned int Evictions = 0; // 超出预算被删除的纹理数
+	};
+
+	// 调试界面里显示的一条资源
+	struct EntryInfo
+	{
+		std::string Key;
+		bool IsTexture = false;
+		unsigned int RefCount = 0;
+		size_t MemorySize = 0;
+		uint64_t LastUsedFrame = 0;
+	};
+
+private:
+	template<typename T>
+	struct Slot
+	{
+		std::unique_ptr<T> Resource; // 为空表示槽位空闲
+		std::string Key;
+		uint32_t Generation = 0;
+		unsigned int RefCount = 0;
+		size_t MemorySize = 0;
+		uint64_t LastUsedFrame = 0;
+	};
+
+	template<typename T>
+	struct Pool
+	{
+		std::vector<Slot<T>> Slots; // 下标就是句柄的 Index
+		std::vector<uint32_t> FreeSlots;
+		std::unordered_map<std::string, uint32_t> Lookup; // Key -> 槽位
+	};
+
+	Pool<Texture> m_Textures;
+	Pool<Shader> m_Shaders;
+	size_t m_Budget;        // 缓存纹理的显存预算 (字节)
+	size_t m_TextureMemory; // 缓存里所有纹理的估算显存, 包括没人用的
+	uint64_t m_Frame;
+	Statistics m_Stats;
+
+	static ResourceManager* s_Instance;
+
+public:
+	ResourceManager(size_t textureBudget = 256 * 1024 * 1024);
+	~ResourceManager();
+
+	ResourceManager(const ResourceManager&) = delete;
+	ResourceManager& operator=(const ResourceManager&) = delete;
+
+	// main 里创建的那个实例
+	static ResourceManager& Get();
+
+	TextureHandle LoadTexture(const std::string& path, const TextureSpec& spec = TextureSpec());
+	ShaderHandle LoadShader(const std::string& path);
+
+	// 句柄要交给另一个对象一起持有时加一次引用
+	void AddRef(TextureHandle handle);
+	void AddRef(ShaderHandle handle);
+	// 失效的句柄直接忽略
+	void Release(TextureHandle handle);
+	void Release(ShaderHandle handle);
+
+	// 句柄失效 (资源已经被删除) 时返回空
+	Texture* GetTexture(TextureHandle handle);
+	Shader* GetShader(ShaderHandle handle);
+
+	// 每帧调用一次: 推进 LRU 的时间, 超出预算时删除最久没用的纹理
+	void Update();
+	// 删除所有没人用的资源 (纹理和着色器), 不管预算
+	void EvictUnused();
+
+	void SetBudget(size_t bytes);
+	inline size_t GetBudget() const { return m_Budget; }
+	inline size_t GetTextureMemory() const { return m_TextureMemory; }
+	inline const Statistics& GetStats() const { return m_Stats; }
+	inline void ResetStats() { m_Stats = Statistics(); }
+
+	// 缓存里的所有资源, 给调试界面用
+	void GetEntries(std::vector<EntryInfo>& entries) const;
+
+private:
+	static std::string MakeTextureKey(const std::string& path, const TextureSpec& spec);
+
+	template<typename T>
+	Slot<T>* Resolve(Pool<T>& pool, ResourceHandle<T> handle);
+	// 已经在缓存里时加引用并返回句柄, 否则返回无效句柄
+	template<typename T>
+	ResourceHandle<T> Acquire(Pool<T>& pool, const std::string& key);
+	template<typename T>
+	ResourceHandle<T> Insert(Pool<T>& pool, const std::string& key, std::unique_ptr<T> resource, size_t memorySize);
+	template<typename T>
+	void Free(Pool<T>& pool, uint32_t index);
+	template<typename T>
+	void Release(Pool<T>& pool, ResourceHandle<T> handle);
+
+	// 删除没人用的纹理, 直到显存回到预算以内 (或者没有能删的了)
+	void EnforceBudget();
+};
@@ -6,28 +6,41 @@
 // #include <glm/glm.hpp>
 
 #include "Render.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "AssetPack.h"
+#include "ShaderCache.h"
+#include "ShaderHotReload.h"
 
 Shader::Shader(const std::string& filepath)
 	:m_FilePath(filepath), m_RendererID(0)
 {
-    /* 从文件中解析着色器源码 */
-    ShaderProgramSource source = ParseShader(filepath);
+    PROFILE_SCOPE("Shader::Shader");
+    /* 挂载了资源包时直接用预处理好的源码, 否则从文件中解析着色器源码 */
+    ShaderProgramSource source;
+    AssetPack* pack = AssetPack::GetMounted();
+    if (!pack || !pack->GetShader(filepath, source))
+        source = ParseShader(filepath);
     m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+    Reflect();
+    ShaderHotReload::Register(this);
 }
 
 Shader::~Shader()
 {
+    ShaderHotReload::Unregister(this);
+    GLState::OnProgramDeleted(m_RendererID);
     GLCall(glDeleteProgram(m_RendererID));
 }
 
 void Shader::Bind() const
 {
-    GLCall(glUseProgram(m_RendererID));
+    GLState::UseProgram(m_RendererID);
 }
 
 void Shader::Unbind() const
 {
-    GLCall(glUseProgram(0));
+    GLState::UseProgram(0);
 }
 
 void Shader::SetUniform1i(const std::string& name, int value)
@@ -35,10 +48,10 @@ void Shader::SetUniform1i(const std::string& name, int value)
     GLCall(glUniform1i(GetUniformLocation(name), value));
 }
 
-// void Shader::SetUniform1f(const std::string& name, float value)
-// {
-//     GLCall(glUniform1f(GetUniformLocation(name), value));
-// }
+void Shader::SetUniform1f(const std::string& name, float value)
+{
+    GLCall(glUniform1f(GetUniformLocation(name), value));
+}
 
 void Shader::SetUniform1iv(const std::string& name, int count, int* value)
 {
@@ -55,6 +68,56 @@ void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
     GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
 }
 
+void Shader::SetUniform1i(UniformHandle uniform, int value)
+{
+    GLCall(glUniform1i(GetUniformLocation(uniform), value));
+}
+
+void Shader::SetUniform1f(UniformHandle uniform, float value)
+{
+    GLCall(glUniform1f(GetUniformLocation(uniform), value));
+}
+
+void Shader::SetUniform1iv(UniformHandle uniform, int count, const int* value)
+{
+    GLCall(glUniform1iv(GetUniformLocation(uniform), count, value));
+}
+
+void Shader::SetUniform4f(UniformHandle uniform, float v0, float v1, float v2, float v3)
+{
+    GLCall(glUniform4f(GetUniformLocation(uniform), v0, v1, v2, v3));
+}
+
+void Shader::SetUniform4f(UniformHandle uniform, const glm::vec4& value)
+{
+    GLCall(glUniform4f(GetUniformLocation(uniform), value.x, value.y, value.z, value.w));
+}
+
+void Shader::SetUniformMat4f(UniformHandle uniform, const glm::mat4& matrix)
+{
+    GLCall(glUniformMatrix4fv(GetUniformLocation(uniform), 1, GL_FALSE, &matrix[0][0]));
+}
+
+void Shader::BindUniformBlock(const std::string& name, unsigned int binding)
+{
+    unsigned int index;
+    GLCall(index = glGetUniformBlockIndex(m_RendererID, name.c_str()));
+    if (index == GL_INVALID_INDEX) {
+        std::cout << "Warning: uniform block '" << name << "' doesn't exist" << std::endl;
+    }
+    else {
+        GLCall(glUniformBlockBinding(m_RendererID, index, binding));
+    }
+
+    for (auto& block : m_UniformBlocks) {
+        if (block.first == name) {
+            block.second = binding;
+            return;
+        }
+    }
+    m_UniformBlocks.emplace_back(name, binding);
+}
+
 ShaderProgramSource Shader::ParseShader(const std::string& filepath)
 {
     std::ifstream stream(filepath); /* 这里没判断文件是否能正常打开 is_open */
@@ -124,8 +187,17 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
  */
 unsigned int Shader::CreateShader(const std::string& vertexShader, const std::string& fragmentShader)
 {
-    unsigned int program;
+    /* 同样的源码之前编译过, 直接用缓存的二进制 */
+    unsigned int program = ShaderCache::Load(vertexShader, fragmentShader);
+    if (program)
+        return program;
+
     GLCall(program = glCreateProgram()); /* 创建程序 */
+    bool cacheable = ShaderCache::IsSupported();
+    if (cacheable) /* 链接前声明之后要取二进制 */
+    {
+        GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
     unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
     unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
 
@@ -139,23 +211,97 @@ unsigned int Shader::CreateShader(const std::string& vertexShader, const std::st
     GLCall(glDeleteShader(vs));
     GLCall(glDeleteShader(fs));
 
+    /* 链接错误处理, 只有成功的程序才写入缓存 */
+    int linked;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    if (linked == GL_FALSE) {
+        int length;
+        GLCall(glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length));
+        std::string msg(length > 0 ? length : 1, '\0');
+        GLCall(glGetProgramInfoLog(program, length, &length, &msg[0]));
+        std::cout << "Failed to link shader program " << m_FilePath << std::endl;
+        std::cout << msg << std::endl;
+        return program;
+    }
+
+    if (cacheable)
+        ShaderCache::Store(program, vertexShader, fragmentShader);
+
     return program;
 }
 
 
 int Shader::GetUniformLocation(const std::string& name) const
 {
-    if (m_UniformlocationCache.find(name) != m_UniformlocationCache.end()) {
-        return m_UniformlocationCache[name];
+    return GetUniformLocation(GetUniformHandle(name));
+}
+
+UniformHandle Shader::GetUniformHandle(const std::string& name) const
+{
+    auto it = m_UniformIndices.find(name);
+    if (it != m_UniformIndices.end()) {
+        return { it->second };
+    }
+
+    /* 反射时没有这个名字: 照样分配一个句柄 (位置是-1, 设置时GL会忽略), 热重载后出现了还能用上 */
+    std::cout << "Warning: uniform '" << name << "' doesn't exist" << std::endl;
+    UniformInfo info;
+    info.Name = name;
+    m_Uniforms.push_back(info);
+    m_UniformIndices[name] = (int)m_Uniforms.size() - 1;
+    return { (int)m_Uniforms.size() - 1 };
+}
+
+void Shader::Reflect()
+{
+    for (UniformInfo& uniform : m_Uniforms)
+        uniform.Location = -1;
+
+    int count = 0, maxLength = 0;
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &count));
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+    std::string buffer(maxLength > 0 ? maxLength : 1, '\0');
+
+    for (int i = 0; i < count; i++) {
+        int length = 0, size = 0, blockIndex = -1;
+        unsigned int type = 0, index = (unsigned int)i;
+        GLCall(glGetActiveUniform(m_RendererID, index, maxLength, &length, &size, &type, &buffer[0]));
+        GLCall(glGetActiveUniformsiv(m_RendererID, 1, &index, GL_UNIFORM_BLOCK_INDEX, &blockIndex));
+        if (blockIndex != -1) /* uniform block 的成员没有位置, 通过 UniformBuffer 设置 */
+            continue;
+
+        std::string name(buffer.c_str(), length);
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+            name.resize(name.size() - 3);
+
+        auto it = m_UniformIndices.find(name);
+        if (it == m_UniformIndices.end()) {
+            m_Uniforms.emplace_back();
+            it = m_UniformIndices.emplace(name, (int)m_Uniforms.size() - 1).first;
+        }
+        UniformInfo& uniform = m_Uniforms[it->second];
+        uniform.Name = name;
+        uniform.Type = type;
+        uniform.Size = size;
+        GLCall(uniform.Location = glGetUniformLocation(m_RendererID, name.c_str()));
     }
-    int location;
-    GLCall(location = glGetUniformLocation(m_RendererID, name.c_str()));
-    if (location == -1) {
-        std::cout << "Warning: uniform '" << name << "' doesn't exist" << std::endl;
+
+    /* block 的绑定点是 program 的状态, 换了 program 要重新设置 */
+    for (const auto& block : m_UniformBlocks) {
+        unsigned int index;
+        GLCall(index = glGetUniformBlockIndex(m_RendererID, block.first.c_str()));
+        if (index != GL_INVALID_INDEX) {
+            GLCall(glUniformBlockBinding(m_RendererID, index, block.second));
+        }
     }
+}
 
-    m_UniformlocationCache[name] = location;
-    return location;
+void Shader::ReplaceProgram(unsigned int program)
+{
+    GLState::OnProgramDeleted(m_RendererID);
+    GLCall(glDeleteProgram(m_RendererID));
+    m_RendererID = program;
+    Reflect();
 }
 
 
@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include <glm/glm.hpp>
 
 struct ShaderProgramSource
@@ -9,12 +11,39 @@ struct ShaderProgramSource
 	std::string FragmentSource;
 };
 
+/**
+ * 预先解析好的 uniform: GetUniformHandle 时查一次名字, 之后 SetUniform 直接按下标取位置, 不再构造字符串和哈希。
+ * 本质是 Shader 内部 uniform 表的下标, 热重载换 program 后同一个句柄仍然有效。
+ */
+struct UniformHandle
+{
+	int Index = -1;
+
+	inline bool IsValid() const { return Index >= 0; }
+};
+
 class Shader
 {
+	friend class ShaderHotReload;
+
+public:
+	// 链接后通过 glGetActiveUniform 反射出来的 uniform (不包括 uniform block 里的成员)
+	struct UniformInfo
+	{
+		std::string Name; // 数组去掉了 "[0]" 后缀
+		int Location = -1; // -1 表示当前 program 里没有 (被优化掉了或者名字写错了)
+		unsigned int Type = 0;
+		int Size = 0; // 数组长度, 不是数组时为 1
+	};
+
 private:
 	unsigned int m_RendererID;
 	std::string m_FilePath;
-	mutable std::unordered_map<std::string, int> m_UniformlocationCache;
+	// 下标就是 UniformHandle::Index, 只增不减
+	mutable std::vector<UniformInfo> m_Uniforms;
+	mutable std::unordered_map<std::string, int> m_UniformIndices;
+	// BindUniformBlock 设置过的 block 绑定点, 热重载后要重新设置
+	std::vector<std::pair<std::string, unsigned int>> m_UniformBlocks;
 
 public:
 	Shader(const std::string& filepath);
@@ -23,13 +52,37 @@ public:
 	void Bind() const;
 	void Unbind() const;
 	void SetUniform1i(const std::string& name, int value); // texture插槽
-	// void SetUniform1f(const std::string& name, float value);
+	void SetUniform1f(const std::string& name, float value);
 	void SetUniform1iv(const std::string& name, int count, int* value);
 	void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
 	void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
+
+	// 热循环里用句柄版本, 句柄在初始化时用 GetUniformHandle 取一次
+	UniformHandle GetUniformHandle(const std::string& name) const;
+	void SetUniform1i(UniformHandle uniform, int value);
+	void SetUniform1f(UniformHandle uniform, float value);
+	void SetUniform1iv(UniformHandle uniform, int count, const int* value);
+	void SetUniform4f(UniformHandle uniform, float v0, float v1, float v2, float v3);
+	void SetUniform4f(UniformHandle uniform, const glm::vec4& value);
+	void SetUniformMat4f(UniformHandle uniform, const glm::mat4& matrix);
+
+	// 把名为 name 的 uniform block 连到 binding 号绑定点 (见 UniformBuffer)
+	void BindUniformBlock(const std::string& name, unsigned int binding);
+
+	inline const std::vector<UniformInfo>& GetUniforms() const { return m_Uniforms; }
+
+	inline const std::string& GetFilePath() const { return m_FilePath; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+
+	// 把 .shader 文件按 #shader vertex / #shader fragment 拆成两段源码
+	static ShaderProgramSource ParseShader(const std::string& filepath);
 private:
-	ShaderProgramSource ParseShader(const std::string& filepath);
 	unsigned int CompileShader(unsigned int type, const std::string& source);
 	unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
 	int GetUniformLocation(const std::string& name) const;
+	inline int GetUniformLocation(UniformHandle uniform) const { return uniform.IsValid() ? m_Uniforms[uniform.Index].Location : -1; }
+	// 链接后反射所有 active uniform, 已有的句柄按名字更新位置, 并重新设置 uniform block 的绑定点
+	void Reflect();
+	// 热重载: 换成新链接好的 program, 删除旧的, 再重新反射
+	void ReplaceProgram(unsigned int program);
 };
\ No newline at end of file
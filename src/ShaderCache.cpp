@@ -0,0 +1,174 @@
+#include "ShaderCache.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "Render.h"
+
+static const uint32_t ShaderCacheMagic = 0x4e494253; // "SBIN"
+
+struct ShaderCacheHeader
+{
+    uint32_t Magic;
+    uint32_t Format; // glGetProgramBinary 返回的 binaryFormat
+    uint64_t Key;    // 完整的 key, 防止文件名哈希碰撞
+    uint32_t Length;
+    uint32_t Reserved;
+};
+
+static std::string s_Directory = ".shadercache";
+static bool s_Enabled = true;
+
+// 64 位 FNV-1a
+static uint64_t Hash(uint64_t hash, const char* data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint64_t ComputeKey(const std::string& vertexSource, const std::string& fragmentSource)
+{
+    uint64_t hash = 14695981039346656037ull;
+    // '\0' 作为分隔, 避免 "ab"+"c" 和 "a"+"bc" 得到同一个 key
+    hash = Hash(hash, vertexSource.c_str(), vertexSource.size() + 1);
+    hash = Hash(hash, fragmentSource.c_str(), fragmentSource.size() + 1);
+
+    const GLenum driverStrings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    for (GLenum name : driverStrings)
+    {
+        const char* value = (const char*)glGetString(name);
+        if (value)
+            hash = Hash(hash, value, strlen(value) + 1);
+    }
+    return hash;
+}
+
+static std::string GetCachePath(uint64_t key)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return s_Directory + "/" + name;
+}
+
+// 驱动是否接受这种二进制格式, 不在列表里的格式传给 glProgramBinary 会产生 GL 错误
+static bool IsFormatSupported(GLenum format)
+{
+    GLint count = 0;
+    GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count));
+    if (count <= 0)
+        return false;
+    std::vector<GLint> formats(count);
+    GLCall(glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data()));
+    for (GLint f : formats)
+    {
+        if ((GLenum)f == format)
+            return true;
+    }
+    return false;
+}
+
+void ShaderCache::SetDirectory(const std::string& directory)
+{
+    s_Directory = directory;
+}
+
+void ShaderCache::SetEnabled(bool enabled)
+{
+    s_Enabled = enabled;
+}
+
+bool ShaderCache::IsSupported()
+{
+    if (!s_Enabled || !(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary))
+        return false;
+    // 有的驱动支持扩展但一个格式都不提供
+    GLint count = 0;
+    GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count));
+    return count > 0;
+}
+
+unsigned int ShaderCache::Load(const std::string& vertexSource, const std::string& fragmentSource)
+{
+    if (!IsSupported())
+        return 0;
+
+    uint64_t key = ComputeKey(vertexSource, fragmentSource);
+    std::string path = GetCachePath(key);
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream.is_open())
+        return 0;
+
+    std::vector<char> file((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    stream.close();
+
+    ShaderCacheHeader header;
+    if (file.size() < sizeof(header))
+        return 0;
+    memcpy(&header, file.data(), sizeof(header));
+    if (header.Magic != ShaderCacheMagic || header.Key != key || sizeof(header) + header.Length > file.size()
+        || !IsFormatSupported(header.Format))
+    {
+        std::filesystem::remove(path);
+        return 0;
+    }
+
+    unsigned int program;
+    GLCall(program = glCreateProgram());
+    GLCall(glProgramBinary(program, header.Format, file.data() + sizeof(header), (GLsizei)header.Length));
+
+    // 驱动可以拒绝二进制 (比如驱动内部版本变了), 这时链接状态为失败
+    int linked = GL_FALSE;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    if (linked == GL_FALSE)
+    {
+        GLCall(glDeleteProgram(program));
+        std::filesystem::remove(path);
+        return 0;
+    }
+    return program;
+}
+
+void ShaderCache::Store(unsigned int program, const std::string& vertexSource, const std::string& fragmentSource)
+{
+    if (!IsSupported())
+        return;
+
+    GLint length = 0;
+    GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLCall(glGetProgramBinary(program, length, &length, &format, binary.data()));
+
+    std::error_code error;
+    std::filesystem::create_directories(s_Directory, error);
+
+    ShaderCacheHeader header = {};
+    header.Magic = ShaderCacheMagic;
+    header.Format = format;
+    header.Key = ComputeKey(vertexSource, fragmentSource);
+    header.Length = (uint32_t)length;
+
+    // 先写临时文件再改名, 进程中途退出也不会留下半个文件
+    std::string path = GetCachePath(header.Key);
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open())
+            return;
+        stream.write((const char*)&header, sizeof(header));
+        stream.write(binary.data(), length);
+    }
+    std::filesystem::rename(temp, path, error);
+}
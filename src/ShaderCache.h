@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+/**
+ * 着色器程序二进制缓存 (ARB_get_program_binary):
+ *      第一次链接成功后用 glGetProgramBinary 取出驱动编译好的二进制存到磁盘,
+ *      下次同样的源码直接 glProgramBinary 加载, 跳过编译和链接。
+ *      缓存的 key = 源码哈希 + 驱动的 GL_VENDOR / GL_RENDERER / GL_VERSION,
+ *      换了显卡或驱动升级后 key 不同, 自然会重新编译。
+ *      驱动拒绝旧的二进制时 (链接状态为失败) 删掉缓存文件, 退回正常编译。
+ */
+class ShaderCache
+{
+public:
+	// 缓存目录, 默认是工作目录下的 .shadercache
+	static void SetDirectory(const std::string& directory);
+	static void SetEnabled(bool enabled);
+	static bool IsSupported();
+
+	// 命中时返回已经链接好的 program, 否则返回 0
+	static unsigned int Load(const std::string& vertexSource, const std::string& fragmentSource);
+	// program 必须已经链接成功, 并且链接前设置了 GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+	static void Store(unsigned int program, const std::string& vertexSource, const std::string& fragmentSource);
+};
@@ -0,0 +1,350 @@
+#include "ShaderHotReload.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "Render.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "ShaderCache.h"
+
+ShaderHotReload* ShaderHotReload::s_Instance = nullptr;
+
+// uniform 类型 -> 分量个数, 矩阵是 4/9/16 个 float; 返回 0 表示不支持拷贝的类型
+static int GetFloatComponents(unsigned int type)
+{
+    switch (type)
+    {
+    case GL_FLOAT:      return 1;
+    case GL_FLOAT_VEC2: return 2;
+    case GL_FLOAT_VEC3: return 3;
+    case GL_FLOAT_VEC4: return 4;
+    case GL_FLOAT_MAT2: return 4;
+    case GL_FLOAT_MAT3: return 9;
+    case GL_FLOAT_MAT4: return 16;
+    }
+    return 0;
+}
+
+static int GetIntComponents(unsigned int type)
+{
+    switch (type)
+    {
+    case GL_INT: case GL_BOOL:
+    case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE: case GL_SAMPLER_2D_ARRAY:
+        return 1;
+    case GL_INT_VEC2: case GL_BOOL_VEC2: return 2;
+    case GL_INT_VEC3: case GL_BOOL_VEC3: return 3;
+    case GL_INT_VEC4: case GL_BOOL_VEC4: return 4;
+    }
+    return 0;
+}
+
+static void SetFloatUniform(unsigned int type, int location, const float* value)
+{
+    switch (type)
+    {
+    case GL_FLOAT:      GLCall(glUniform1fv(location, 1, value)); break;
+    case GL_FLOAT_VEC2: GLCall(glUniform2fv(location, 1, value)); break;
+    case GL_FLOAT_VEC3: GLCall(glUniform3fv(location, 1, value)); break;
+    case GL_FLOAT_VEC4: GLCall(glUniform4fv(location, 1, value)); break;
+    case GL_FLOAT_MAT2: GLCall(glUniformMatrix2fv(location, 1, GL_FALSE, value)); break;
+    case GL_FLOAT_MAT3: GLCall(glUniformMatrix3fv(location, 1, GL_FALSE, value)); break;
+    case GL_FLOAT_MAT4: GLCall(glUniformMatrix4fv(location, 1, GL_FALSE, value)); break;
+    }
+}
+
+static void SetIntUniform(int components, int location, const int* value)
+{
+    switch (components)
+    {
+    case 1: GLCall(glUniform1iv(location, 1, value)); break;
+    case 2: GLCall(glUniform2iv(location, 1, value)); break;
+    case 3: GLCall(glUniform3iv(location, 1, value)); break;
+    case 4: GLCall(glUniform4iv(location, 1, value)); break;
+    }
+}
+
+/*
+ * 把旧 program 里 uniform 的当前值拷贝到新 program, 这样替换之后不用等使用者重新设置
+ * (比如只在初始化时设置一次的采样器插槽)。
+ * 名字和类型都相同的才拷贝, uniform block 里的成员存在缓冲里, 不用拷贝。
+ */
+static void CopyUniformValues(unsigned int from, unsigned int to)
+{
+    int count = 0, maxLength = 0;
+    GLCall(glGetProgramiv(to, GL_ACTIVE_UNIFORMS, &count));
+    GLCall(glGetProgramiv(to, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+    std::string buffer(maxLength > 0 ? maxLength : 1, '\0');
+
+    std::unordered_map<std::string, unsigned int> targetTypes;
+    for (int i = 0; i < count; i++)
+    {
+        int length = 0, size = 0;
+        unsigned int type = 0;
+        GLCall(glGetActiveUniform(to, i, maxLength, &length, &size, &type, &buffer[0]));
+        targetTypes[std::string(buffer.c_str(), length)] = type;
+    }
+
+    GLCall(glGetProgramiv(from, GL_ACTIVE_UNIFORMS, &count));
+    GLCall(glGetProgramiv(from, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+    buffer.assign(maxLength > 0 ? maxLength : 1, '\0');
+
+    GLState::UseProgram(to);
+    for (int i = 0; i < count; i++)
+    {
+        int length = 0, size = 0, blockIndex = -1;
+        unsigned int type = 0, index = (unsigned int)i;
+        GLCall(glGetActiveUniform(from, index, maxLength, &length, &size, &type, &buffer[0]));
+        GLCall(glGetActiveUniformsiv(from, 1, &index, GL_UNIFORM_BLOCK_INDEX, &blockIndex));
+        std::string name(buffer.c_str(), length);
+
+        auto target = targetTypes.find(name);
+        if (blockIndex != -1 || target == targetTypes.end() || target->second != type)
+            continue;
+
+        int floatComponents = GetFloatComponents(type);
+        int intComponents = GetIntComponents(type);
+        if (floatComponents == 0 && intComponents == 0)
+            continue;
+
+        // 数组 uniform 的名字是 "u_Textures[0]", 每个元素单独查位置
+        std::string base = name;
+        if (size > 1 && base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0)
+            base.resize(base.size() - 3);
+        for (int element = 0; element < size; element++)
+        {
+            std::string elementName = size > 1 ? base + "[" + std::to_string(element) + "]" : name;
+            int src, dst;
+            GLCall(src = glGetUniformLocation(from, elementName.c_str()));
+            GLCall(dst = glGetUniformLocation(to, elementName.c_str()));
+            if (src == -1 || dst == -1)
+                continue;
+
+            if (floatComponents)
+            {
+                float value[16];
+                GLCall(glGetUniformfv(from, src, value));
+                SetFloatUniform(type, dst, value);
+            }
+            else
+            {
+                int value[4];
+                GLCall(glGetUniformiv(from, src, value));
+                SetIntUniform(intComponents, dst, value);
+            }
+        }
+    }
+}
+
+static bool CheckShader(unsigned int shader, const std::string& filePath, const char* stage)
+{
+    int compiled;
+    GLCall(glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled));
+    if (compiled == GL_TRUE)
+        return true;
+
+    int length;
+    GLCall(glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length));
+    std::string msg(length > 0 ? length : 1, '\0');
+    GLCall(glGetShaderInfoLog(shader, length, &length, &msg[0]));
+    std::cout << "Hot reload: failed to compile " << stage << " shader in " << filePath << std::endl;
+    std::cout << msg << std::endl;
+    return false;
+}
+
+ShaderHotReload::ShaderHotReload()
+    : m_ParallelCompile(false), m_ReloadCount(0), m_FailureCount(0),
+    m_Watcher([this](const std::string& path) { OnFileChanged(path); })
+{
+    // 让驱动自己决定编译线程数
+    if (GLEW_ARB_parallel_shader_compile)
+    {
+        GLCall(glMaxShaderCompilerThreadsARB(0xFFFFFFFF));
+        m_ParallelCompile = true;
+    }
+    else if (GLEW_KHR_parallel_shader_compile)
+    {
+        GLCall(glMaxShaderCompilerThreadsKHR(0xFFFFFFFF));
+        m_ParallelCompile = true;
+    }
+    s_Instance = this;
+}
+
+ShaderHotReload::~ShaderHotReload()
+{
+    for (PendingProgram& pending : m_Compiling)
+    {
+        GLCall(glDeleteShader(pending.VertexShader));
+        GLCall(glDeleteShader(pending.FragmentShader));
+        GLCall(glDeleteProgram(pending.Program));
+    }
+
+    if (s_Instance == this)
+        s_Instance = nullptr;
+}
+
+void ShaderHotReload::Register(Shader* shader)
+{
+    if (!s_Instance)
+        return;
+    std::vector<Shader*>& shaders = s_Instance->m_Shaders[shader->GetFilePath()];
+    if (shaders.empty())
+        s_Instance->m_Watcher.Watch(shader->GetFilePath());
+    shaders.push_back(shader);
+}
+
+void ShaderHotReload::Unregister(Shader* shader)
+{
+    if (!s_Instance)
+        return;
+    auto it = s_Instance->m_Shaders.find(shader->GetFilePath());
+    if (it == s_Instance->m_Shaders.end())
+        return;
+    std::vector<Shader*>& shaders = it->second;
+    shaders.erase(std::remove(shaders.begin(), shaders.end(), shader), shaders.end());
+    if (shaders.empty())
+    {
+        s_Instance->m_Watcher.Unwatch(it->first);
+        s_Instance->m_Shaders.erase(it);
+    }
+}
+
+void ShaderHotReload::OnFileChanged(const std::string& path)
+{
+    ShaderProgramSource source = Shader::ParseShader(path);
+    // 编辑器保存到一半或者文件被删掉, 下一次写入还会再通知
+    if (source.VertexSource.empty() || source.FragmentSource.empty())
+        return;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (ParsedSource& parsed : m_Parsed)
+    {
+        if (parsed.FilePath == path) /* 渲染线程还没取走, 直接换成最新的 */
+        {
+            parsed.Source = std::move(source);
+            return;
+        }
+    }
+    m_Parsed.push_back({ path, std::move(source) });
+}
+
+void ShaderHotReload::Update()
+{
+    PROFILE_SCOPE("ShaderHotReload::Update");
+    std::vector<ParsedSource> parsed;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        parsed.swap(m_Parsed);
+    }
+    for (ParsedSource& source : parsed)
+        BeginCompile(source);
+
+    for (size_t i = 0; i < m_Compiling.size(); )
+    {
+        if (!IsCompileFinished(m_Compiling[i]))
+        {
+            i++;
+            continue;
+        }
+        FinishCompile(m_Compiling[i]);
+        m_Compiling.erase(m_Compiling.begin() + i);
+    }
+}
+
+void ShaderHotReload::BeginCompile(ParsedSource& parsed)
+{
+    // 同一个文件还有没编译完的旧版本, 直接作废
+    for (size_t i = 0; i < m_Compiling.size(); i++)
+    {
+        PendingProgram& old = m_Compiling[i];
+        if (old.FilePath != parsed.FilePath)
+            continue;
+        GLCall(glDeleteShader(old.VertexShader));
+        GLCall(glDeleteShader(old.FragmentShader));
+        GLCall(glDeleteProgram(old.Program));
+        m_Compiling.erase(m_Compiling.begin() + i);
+        break;
+    }
+
+    PendingProgram pending;
+    pending.FilePath = parsed.FilePath;
+    pending.Source = std::move(parsed.Source);
+
+    /* 只提交编译和链接, 不查询状态: 支持并行编译时查询前不会阻塞 */
+    GLCall(pending.Program = glCreateProgram());
+    if (ShaderCache::IsSupported())
+    {
+        GLCall(glProgramParameteri(pending.Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+    const char* vertexSource = pending.Source.VertexSource.c_str();
+    const char* fragmentSource = pending.Source.FragmentSource.c_str();
+    GLCall(pending.VertexShader = glCreateShader(GL_VERTEX_SHADER));
+    GLCall(glShaderSource(pending.VertexShader, 1, &vertexSource, nullptr));
+    GLCall(glCompileShader(pending.VertexShader));
+    GLCall(pending.FragmentShader = glCreateShader(GL_FRAGMENT_SHADER));
+    GLCall(glShaderSource(pending.FragmentShader, 1, &fragmentSource, nullptr));
+    GLCall(glCompileShader(pending.FragmentShader));
+    GLCall(glAttachShader(pending.Program, pending.VertexShader));
+    GLCall(glAttachShader(pending.Program, pending.FragmentShader));
+    GLCall(glLinkProgram(pending.Program));
+
+    m_Compiling.push_back(std::move(pending));
+}
+
+bool ShaderHotReload::IsCompileFinished(const PendingProgram& pending) const
+{
+    // 不支持并行编译时, 查询链接状态本来就会等编译完成
+    if (!m_ParallelCompile)
+        return true;
+    int completed = GL_FALSE;
+    GLCall(glGetProgramiv(pending.Program, GL_COMPLETION_STATUS_ARB, &completed));
+    return completed == GL_TRUE;
+}
+
+void ShaderHotReload::FinishCompile(PendingProgram& pending)
+{
+    bool compiled = CheckShader(pending.VertexShader, pending.FilePath, "vertex");
+    compiled &= CheckShader(pending.FragmentShader, pending.FilePath, "fragment");
+    GLCall(glDeleteShader(pending.VertexShader));
+    GLCall(glDeleteShader(pending.FragmentShader));
+
+    int linked = GL_FALSE;
+    GLCall(glGetProgramiv(pending.Program, GL_LINK_STATUS, &linked));
+    if (compiled && linked == GL_FALSE)
+    {
+        int length;
+        GLCall(glGetProgramiv(pending.Program, GL_INFO_LOG_LENGTH, &length));
+        std::string msg(length > 0 ? length : 1, '\0');
+        GLCall(glGetProgramInfoLog(pending.Program, length, &length, &msg[0]));
+        std::cout << "Hot reload: failed to link " << pending.FilePath << std::endl;
+        std::cout << msg << std::endl;
+    }
+
+    auto it = m_Shaders.find(pending.FilePath);
+    if (!compiled || linked == GL_FALSE || it == m_Shaders.end())
+    {
+        GLCall(glDeleteProgram(pending.Program));
+        m_FailureCount++;
+        return;
+    }
+
+    if (ShaderCache::IsSupported())
+        ShaderCache::Store(pending.Program, pending.Source.VertexSource, pending.Source.FragmentSource);
+
+    // 第一个 Shader 直接用新链接的 program, 同一个文件的其他 Shader 各自要一份 (uniform 值各不相同)
+    std::vector<Shader*>& shaders = it->second;
+    for (size_t i = 0; i < shaders.size(); i++)
+    {
+        unsigned int program = pending.Program;
+        if (i > 0)
+            program = ShaderCache::Load(pending.Source.VertexSource, pending.Source.FragmentSource);
+        if (!program)
+            program = shaders[i]->CreateShader(pending.Source.VertexSource, pending.Source.FragmentSource);
+        CopyUniformValues(shaders[i]->m_RendererID, program);
+        shaders[i]->ReplaceProgram(program);
+    }
+
+    m_ReloadCount++;
+    std::cout << "Hot reload: reloaded " << pending.FilePath << std::endl;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "FileWatcher.h"
+#include "Shader.h"
+
+/**
+ * 着色器热重载:
+ *      每个 Shader 构造时登记到这里, FileWatcher 发现 .shader 文件被改写后,
+ *      在监视线程里重新读取和拆分源码 (文件IO不占渲染线程),
+ *      渲染线程 Update 时提交编译和链接; 驱动支持 ARB/KHR_parallel_shader_compile 时编译在驱动的线程里进行,
+ *      之后每帧用 GL_COMPLETION_STATUS_ARB 查询, 完成之前不会阻塞渲染。
+ *      只有编译和链接都成功才替换 Shader 里的 program (同时拷贝旧 program 的 uniform 值并重建 uniform 缓存),
+ *      失败时打印日志, 继续用旧的 program, 改好再保存一次即可。
+ * 构造/析构/Update 都必须在渲染线程调用, 并且要在所有 Shader 创建之前创建、销毁之后析构。
+ */
+class ShaderHotReload
+{
+private:
+	struct ParsedSource
+	{
+		std::string FilePath;
+		ShaderProgramSource Source;
+	};
+
+	struct PendingProgram
+	{
+		std::string FilePath;
+		ShaderProgramSource Source;
+		unsigned int Program = 0;
+		unsigned int VertexShader = 0;
+		unsigned int FragmentShader = 0;
+	};
+
+	std::mutex m_Mutex; // 保护 m_Parsed, 监视线程写, 渲染线程读
+	std::vector<ParsedSource> m_Parsed;
+
+	// 下面的只在渲染线程访问
+	std::vector<PendingProgram> m_Compiling;
+	std::unordered_map<std::string, std::vector<Shader*>> m_Shaders; // 文件路径 -> 用这个文件的 Shader
+	bool m_ParallelCompile;
+	unsigned int m_ReloadCount;
+	unsigned int m_FailureCount;
+
+	// 最后构造、最先析构: 监视线程的回调会访问上面的成员
+	FileWatcher m_Watcher;
+
+	static ShaderHotReload* s_Instance;
+
+public:
+	ShaderHotReload();
+	~ShaderHotReload();
+
+	// 没有 ShaderHotReload 实例时什么都不做
+	static void Register(Shader* shader);
+	static void Unregister(Shader* shader);
+
+	// 每帧调用一次: 提交新读到的源码去编译, 检查之前提交的是否完成
+	void Update();
+
+	inline unsigned int GetReloadCount() const { return m_ReloadCount; }
+	inline unsigned int GetFailureCount() const { return m_FailureCount; }
+	inline unsigned int GetPendingCount() const { return (unsigned int)m_Compiling.size(); }
+
+private:
+	void OnFileChanged(const std::string& path); // 监视线程
+	void BeginCompile(ParsedSource& parsed);
+	bool IsCompileFinished(const PendingProgram& pending) const;
+	void FinishCompile(PendingProgram& pending);
+};
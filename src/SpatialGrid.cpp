@@ -0,0 +1,213 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Profiler.h"
+
+// 格子坐标要能转成 int, 并且 x <= MaxX 的循环里 x++ 不会溢出; 超出这个范围的按 "太大的物体" 处理
+static const float s_MaxCellCoordinate = (float)(1 << 30);
+
+static bool IsCellRangeInBounds(float minX, float minY, float maxX, float maxY)
+{
+    // 有 NaN 时比较全是 false, 同样不通过
+    return minX >= -s_MaxCellCoordinate && minY >= -s_MaxCellCoordinate
+        && maxX <= s_MaxCellCoordinate && maxY <= s_MaxCellCoordinate;
+}
+
+SpatialGrid::SpatialGrid(float cellSize)
+    : m_CellSize(std::max(cellSize, 1e-3f)), m_ObjectCount(0), m_QueryStamp(0)
+{
+}
+
+SpatialGrid::CellRange SpatialGrid::ComputeCells(const AABB& bounds) const
+{
+    CellRange cells;
+    float minX = std::floor(bounds.Min.x / m_CellSize), minY = std::floor(bounds.Min.y / m_CellSize);
+    float maxX = std::floor(bounds.Max.x / m_CellSize), maxY = std::floor(bounds.Max.y / m_CellSize);
+    // 太大的 (或者坐标不是有限值、超出 int 范围的) 物体不进格子
+    if (!IsCellRangeInBounds(minX, minY, maxX, maxY)
+        || (maxX - minX + 1.0f) * (maxY - minY + 1.0f) > (float)MaxCellsPerObject)
+        return cells;
+
+    cells.MinX = (int)minX;
+    cells.MinY = (int)minY;
+    cells.MaxX = (int)maxX;
+    cells.MaxY = (int)maxY;
+    return cells;
+}
+
+void SpatialGrid::AddToCells(unsigned int handle, const CellRange& cells)
+{
+    if (cells.MaxX < cells.MinX)
+    {
+        m_LargeObjects.push_back(handle);
+        return;
+    }
+    for (int y = cells.MinY; y <= cells.MaxY; y++)
+    {
+        for (int x = cells.MinX; x <= cells.MaxX; x++)
+            m_Cells[CellKey(x, y)].push_back(handle);
+    }
+}
+
+static void RemoveHandle(std::vector<unsigned int>& handles, unsigned int handle)
+{
+    // 格子里的顺序无所谓, 和最后一个交换后删掉
+    auto it = std::find(handles.begin(), handles.end(), handle);
+    if (it != handles.end())
+    {
+        *it = handles.back();
+        handles.pop_back();
+    }
+}
+
+void SpatialGrid::RemoveFromCells(unsigned int handle, const CellRange& cells)
+{
+    if (cells.MaxX < cells.MinX)
+    {
+        RemoveHandle(m_LargeObjects, handle);
+        return;
+    }
+    for (int y = cells.MinY; y <= cells.MaxY; y++)
+    {
+        for (int x = cells.MinX; x <= cells.MaxX; x++)
+        {
+            auto it = m_Cells.find(CellKey(x, y));
+            if (it == m_Cells.end())
+                continue;
+            RemoveHandle(it->second, handle);
+            // 空格子删掉, 否则物体一直移动时哈希表会越来越大
+            if (it->second.empty())
+                m_Cells.erase(it);
+        }
+    }
+}
+
+unsigned int SpatialGrid::Insert(const AABB& bounds, unsigned int userData)
+{
+    unsigned int handle;
+    if (!m_FreeHandles.empty())
+    {
+        handle = m_FreeHandles.back();
+        m_FreeHandles.pop_back();
+    }
+    else
+    {
+        handle = (unsigned int)m_Objects.size();
+        m_Objects.emplace_back();
+    }
+
+    Object& object = m_Objects[handle];
+    object.Bounds = bounds;
+    object.UserData = userData;
+    object.Cells = ComputeCells(bounds);
+    object.QueryStamp = m_QueryStamp;
+    object.Alive = true;
+    AddToCells(handle, object.Cells);
+    m_ObjectCount++;
+    return handle;
+}
+
+void SpatialGrid::Update(unsigned int handle, const AABB& bounds)
+{
+    if (handle >= m_Objects.size() || !m_Objects[handle].Alive)
+        return;
+
+    Object& object = m_Objects[handle];
+    object.Bounds = bounds;
+    CellRange cells = ComputeCells(bounds);
+    if (cells == object.Cells)
+        return;
+    RemoveFromCells(handle, object.Cells);
+    AddToCells(handle, cells);
+    object.Cells = cells;
+}
+
+void SpatialGrid::Remove(unsigned int handle)
+{
+    if (handle >= m_Objects.size() || !m_Objects[handle].Alive)
+        return;
+
+    Object& object = m_Objects[handle];
+    RemoveFromCells(handle, object.Cells);
+    object.Alive = false;
+    m_FreeHandles.push_back(handle);
+    m_ObjectCount--;
+}
+
+void SpatialGrid::Clear()
+{
+    m_Objects.clear();
+    m_FreeHandles.clear();
+    m_Cells.clear();
+    m_LargeObjects.clear();
+    m_ObjectCount = 0;
+}
+
+void SpatialGrid::Collect(unsigned int handle)
+{
+    Object& object = m_Objects[handle];
+    if (object.QueryStamp == m_QueryStamp)
+        return;
+    object.QueryStamp = m_QueryStamp;
+    m_Candidates.push_back(handle);
+    m_CandidateBounds.Push(object.Bounds);
+}
+
+void SpatialGrid::Query(const Frustum& frustum, std::vector<unsigned int>& result)
+{
+    PROFILE_FUNCTION();
+    m_QueryStamp++;
+    m_Candidates.clear();
+    m_CandidateBounds.Clear();
+    m_Stats.CellsVisited = 0;
+
+    // 视锥体覆盖的格子比现有的格子还多时 (比如透视投影的远平面很远), 或者格子坐标超出 int 范围时, 直接遍历所有格子
+    const AABB& bounds = frustum.GetBounds();
+    float minX = std::floor(bounds.Min.x / m_CellSize), minY = std::floor(bounds.Min.y / m_CellSize);
+    float maxX = std::floor(bounds.Max.x / m_CellSize), maxY = std::floor(bounds.Max.y / m_CellSize);
+    double area = ((double)maxX - minX + 1.0) * ((double)maxY - minY + 1.0);
+    if (IsCellRangeInBounds(minX, minY, maxX, maxY) && area <= (double)m_Cells.size())
+    {
+        for (int y = (int)minY; y <= (int)maxY; y++)
+        {
+            for (int x = (int)minX; x <= (int)maxX; x++)
+            {
+                m_Stats.CellsVisited++;
+                auto it = m_Cells.find(CellKey(x, y));
+                if (it == m_Cells.end())
+                    continue;
+                for (unsigned int handle : it->second)
+                    Collect(handle);
+            }
+        }
+    }
+    else
+    {
+        for (auto& [key, handles] : m_Cells)
+        {
+            m_Stats.CellsVisited++;
+            for (unsigned int handle : handles)
+                Collect(handle);
+        }
+    }
+    for (unsigned int handle : m_LargeObjects)
+        Collect(handle);
+
+    m_CandidateVisible.resize(m_Candidates.size());
+    frustum.Intersects(m_CandidateBounds, m_CandidateVisible.data());
+
+    unsigned int visible = 0;
+    for (size_t i = 0; i < m_Candidates.size(); i++)
+    {
+        if (m_CandidateVisible[i])
+        {
+            result.push_back(m_Objects[m_Candidates[i]].UserData);
+            visible++;
+        }
+    }
+
+    m_Stats.Candidates = (unsigned int)m_Candidates.size();
+    m_Stats.Visible = visible;
+}
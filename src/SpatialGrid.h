@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Frustum.h"
+
+/**
+ * 空间索引 (散列的均匀网格):
+ *      XY 平面按 cellSize 划成格子, 只有放了东西的格子才存在 (哈希表), 所以世界可以无限大。
+ *      每个物体登记在它的包围盒覆盖的所有格子里, 查询时只看和视锥体包围盒重叠的格子,
+ *      收集到的候选物体再用 Frustum::Intersects 做精确 (SIMD) 检查。
+ *      Update 只在物体跨过格子边界时才改动格子, 运动的物体每帧更新代价很小。
+ *      太大的物体 (覆盖超过 MaxCellsPerObject 个格子, 或者格子坐标超出 ±2^30) 不进格子, 每次查询都直接检查。
+ * 用法:
+ *      unsigned int id = grid.Insert(box, userData);
+ *      grid.Update(id, newBox); // 物体移动了
+ *      grid.Query(Frustum(proj * view), visibleUserData);
+ */
+class SpatialGrid
+{
+public:
+	static const unsigned int InvalidHandle = 0xFFFFFFFF;
+	static const int MaxCellsPerObject = 64;
+
+	// 上一次查询的统计
+	struct Statistics
+	{
+		unsigned int CellsVisited = 0; // 看了几个格子
+		unsigned int Candidates = 0;   // 做了精确检查的物体数
+		unsigned int Visible = 0;      // 返回的物体数
+	};
+
+private:
+	struct CellRange
+	{
+		int MinX = 0, MinY = 0, MaxX = -1, MaxY = -1; // 闭区间, MaxX < MinX 表示不在格子里 (大物体)
+
+		inline bool operator==(const CellRange& other) const
+		{
+			return MinX == other.MinX && MinY == other.MinY && MaxX == other.MaxX && MaxY == other.MaxY;
+		}
+	};
+
+	struct Object
+	{
+		AABB Bounds;
+		unsigned int UserData = 0;
+		CellRange Cells;
+		uint32_t QueryStamp = 0; // 一个物体可能在多个格子里, 同一次查询只收集一次
+		bool Alive = false;
+	};
+
+	float m_CellSize;
+	std::vector<Object> m_Objects; // 下标就是句柄
+	std::vector<unsigned int> m_FreeHandles;
+	std::unordered_map<uint64_t, std::vector<unsigned int>> m_Cells;
+	std::vector<unsigned int> m_LargeObjects;
+	unsigned int m_ObjectCount;
+	uint32_t m_QueryStamp;
+
+	// 查询时重用的临时数组
+	AABBList m_CandidateBounds;
+	std::vector<unsigned int> m_Candidates;
+	std::vector<unsigned char> m_CandidateVisible;
+
+	Statistics m_Stats;
+
+public:
+	SpatialGrid(float cellSize = 256.0f);
+
+	// 返回句柄, userData 由调用者决定 (一般是自己数组里的下标), 查询结果返回的就是它
+	unsigned int Insert(const AABB& bounds, unsigned int userData);
+	void Update(unsigned int handle, const AABB& bounds);
+	void Remove(unsigned int handle);
+	void Clear();
+
+	// 把和视锥体相交的物体的 userData 追加到 result 里 (顺序不固定)
+	void Query(const Frustum& frustum, std::vector<unsigned int>& result);
+
+	inline float GetCellSize() const { return m_CellSize; }
+	inline unsigned int GetObjectCount() const { return m_ObjectCount; }
+	// 非空的格子数
+	inline unsigned int GetCellCount() const { return (unsigned int)m_Cells.size(); }
+	inline const Statistics& GetStats() const { return m_Stats; }
+
+private:
+	CellRange ComputeCells(const AABB& bounds) const;
+	void AddToCells(unsigned int handle, const CellRange& cells);
+	void RemoveFromCells(unsigned int handle, const CellRange& cells);
+	void Collect(unsigned int handle);
+
+	static inline uint64_t CellKey(int x, int y)
+	{
+		return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+	}
+};
@@ -0,0 +1,417 @@
+#include "SpriteBatch.h"
+
+#include <cmath>
+#include <cstddef>
+
+#include "Profiler.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define SPRITE_KERNELS_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+    // SSE2 在 x64 上总是有, 32 位时看编译选项
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define SPRITE_KERNELS_SSE2
+    #endif
+    // GCC/Clang 要给用到 AVX2 指令的函数单独打开目标特性, MSVC 不需要
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define SPRITE_TARGET_AVX2
+    #else
+        #define SPRITE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
+#endif
+
+// 内核直接按偏移写顶点, 布局变了要一起改
+// (x, y, z, RGBA8) 正好 16 字节, 后面是 (uv, texIndex) 8 字节
+static_assert(sizeof(QuadVertex) == 24, "SpriteKernels assume QuadVertex is 24 bytes");
+static_assert(offsetof(QuadVertex, Color) == 12 && offsetof(QuadVertex, TexCoord) == 16
+    && offsetof(QuadVertex, TexIndex) == 20, "Unexpected QuadVertex layout");
+
+void SpriteBatch::Clear()
+{
+    X.clear(); Y.clear(); Z.clear();
+    Width.clear(); Height.clear(); Rotation.clear();
+    U0.clear(); V0.clear(); U1.clear(); V1.clear();
+    R.clear(); G.clear(); B.clear(); A.clear();
+    Textures.clear();
+}
+
+void SpriteBatch::Reserve(size_t count)
+{
+    X.reserve(count); Y.reserve(count); Z.reserve(count);
+    Width.reserve(count); Height.reserve(count); Rotation.reserve(count);
+    U0.reserve(count); V0.reserve(count); U1.reserve(count); V1.reserve(count);
+    R.reserve(count); G.reserve(count); B.reserve(count); A.reserve(count);
+    Textures.reserve(count);
+}
+
+size_t SpriteBatch::Add(const SpriteDesc& sprite)
+{
+    X.push_back(sprite.Position.x); Y.push_back(sprite.Position.y); Z.push_back(sprite.Position.z);
+    Width.push_back(sprite.Size.x); Height.push_back(sprite.Size.y); Rotation.push_back(sprite.Rotation);
+    U0.push_back(sprite.UVMin.x); V0.push_back(sprite.UVMin.y); U1.push_back(sprite.UVMax.x); V1.push_back(sprite.UVMax.y);
+    R.push_back(sprite.Color.x); G.push_back(sprite.Color.y); B.push_back(sprite.Color.z); A.push_back(sprite.Color.w);
+    Textures.push_back(sprite.Tex);
+    return X.size() - 1;
+}
+
+// ---------------- sin/cos ----------------
+// 先按 pi/2 取模, 剩下 [-pi/4, pi/4] 上的值用多项式算 (Cephes 的系数), 再按象限交换/取反。
+// 三个内核用同一套算法, 保证画出来的结果一致。
+
+static const float s_TwoOverPi = 0.636619772367581f;
+// pi/2 拆成三段, 减的时候误差小
+static const float s_PiOver2A = 1.5703125f;
+static const float s_PiOver2B = 4.837512969970703125e-4f;
+static const float s_PiOver2C = 7.54978995489188216e-8f;
+
+static const float s_SinC0 = -1.9515295891e-4f, s_SinC1 = 8.3321608736e-3f, s_SinC2 = -1.6666654611e-1f;
+static const float s_CosC0 = 2.443315711809948e-5f, s_CosC1 = -1.388731625493765e-3f, s_CosC2 = 4.166664568298827e-2f;
+
+static inline void SinCos(float x, float& sinOut, float& cosOut)
+{
+    int quadrant = (int)std::lrint(x * s_TwoOverPi);
+    float y = x - quadrant * s_PiOver2A - quadrant * s_PiOver2B - quadrant * s_PiOver2C;
+    float z = y * y;
+    float s = y + y * z * (s_SinC2 + z * (s_SinC1 + z * s_SinC0));
+    float c = 1.0f - 0.5f * z + z * z * (s_CosC2 + z * (s_CosC1 + z * s_CosC0));
+
+    bool swap = (quadrant & 1) != 0;
+    sinOut = swap ? c : s;
+    cosOut = swap ? s : c;
+    if (quadrant & 2)
+        sinOut = -sinOut;
+    if ((quadrant + 1) & 2)
+        cosOut = -cosOut;
+}
+
+// ---------------- Scalar ----------------
+
+static void GenerateScalar(const SpriteBatch& sprites, size_t first, size_t count, const uint32_t* texSlots, QuadVertex* out)
+{
+    for (size_t n = 0; n < count; n++)
+    {
+        size_t i = first + n;
+        float s, c;
+        SinCos(sprites.Rotation[i], s, c);
+        // 中心加减两个半轴: (ax, ay) 是旋转后的 x 半轴, (-bx, by) 是旋转后的 y 半轴
+        float hw = sprites.Width[i] * 0.5f, hh = sprites.Height[i] * 0.5f;
+        float ax = c * hw, ay = s * hw;
+        float bx = s * hh, by = c * hh;
+        float x = sprites.X[i], y = sprites.Y[i], z = sprites.Z[i];
+
+        const float cornerX[4] = { x - ax + bx, x + ax + bx, x + ax - bx, x - ax - bx };
+        const float cornerY[4] = { y - ay - by, y + ay - by, y + ay + by, y - ay + by };
+        const float u[4] = { sprites.U0[i], sprites.U1[i], sprites.U1[i], sprites.U0[i] };
+        const float v[4] = { sprites.V0[i], sprites.V0[i], sprites.V1[i], sprites.V1[i] };
+        Unorm8x4 color = Unorm8x4::Pack(glm::vec4(sprites.R[i], sprites.G[i], sprites.B[i], sprites.A[i]));
+        for (int k = 0; k < 4; k++)
+        {
+            QuadVertex& vertex = out[n * 4 + k];
+            vertex.Position = glm::vec3(cornerX[k], cornerY[k], z);
+            vertex.Color = color;
+            vertex.TexCoord = Unorm16x2::Pack(glm::vec2(u[k], v[k]));
+            vertex.TexIndex = texSlots[n];
+        }
+    }
+}
+
+#ifdef SPRITE_KERNELS_X86
+
+// ---------------- SSE2 ----------------
+
+// 和 VertexFormats::PackUnorm 一样: 截断到 [0,1], 缩放, 加 0.5 截尾
+static inline __m128i PackUnorm4(__m128 value, float scale)
+{
+    value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(scale)), _mm_set1_ps(0.5f)));
+}
+
+// 4 个 sprite 的颜色打包成 RGBA8, 每个通道一个
+static inline __m128i PackColors4(__m128 r, __m128 g, __m128 b, __m128 a)
+{
+    __m128i rg = _mm_or_si128(PackUnorm4(r, 255.0f), _mm_slli_epi32(PackUnorm4(g, 255.0f), 8));
+    __m128i ba = _mm_or_si128(_mm_slli_epi32(PackUnorm4(b, 255.0f), 16), _mm_slli_epi32(PackUnorm4(a, 255.0f), 24));
+    return _mm_or_si128(rg, ba);
+}
+
+// 4 个 sprite 的角已经算好 (cornerX[k] 是 4 个 sprite 第 k 个角的 x), 转置成交错的顶点写出去。
+// color / texCoord[k] / tex 是打包好的整数, 每个通道一个 sprite。
+// 只用 SSE 指令, AVX2 内核把 8 个 sprite 拆成两半也调用它 (内联进 AVX2 函数后编译器会用 VEX 编码)
+static inline void StoreQuads4(QuadVertex* out, const __m128 cornerX[4], const __m128 cornerY[4], __m128 z,
+    __m128i color, const __m128i texCoord[4], __m128i tex)
+{
+    for (int k = 0; k < 4; k++)
+    {
+        // 转置之后 p0..p3 分别是第 0..3 个 sprite 的 (x, y, z, RGBA8)
+        __m128 p0 = cornerX[k], p1 = cornerY[k], p2 = z, p3 = _mm_castsi128_ps(color);
+        _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+        // (uv, texIndex) 两两交错, 每个 64 位是一个 sprite 的
+        __m128i t01 = _mm_unpacklo_epi32(texCoord[k], tex);
+        __m128i t23 = _mm_unpackhi_epi32(texCoord[k], tex);
+        const __m128 positions[4] = { p0, p1, p2, p3 };
+        const __m128i texData[4] = { t01, _mm_unpackhi_epi64(t01, t01), t23, _mm_unpackhi_epi64(t23, t23) };
+
+        for (int i = 0; i < 4; i++)
+        {
+            char* vertex = (char*)&out[i * 4 + k];
+            _mm_storeu_ps((float*)vertex, positions[i]);
+            // 只剩 8 字节, 整个写 16 字节会写到下一个顶点 (甚至缓冲区外面)
+            _mm_storel_epi64((__m128i*)(vertex + 16), texData[i]);
+        }
+    }
+}
+
+#ifdef SPRITE_KERNELS_SSE2
+static inline void SinCos4(__m128 x, __m128& sinOut, __m128& cosOut)
+{
+    __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(s_TwoOverPi)));
+    __m128 q = _mm_cvtepi32_ps(quadrant);
+    __m128 y = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(s_PiOver2A)));
+    y = _mm_sub_ps(y, _mm_mul_ps(q, _mm_set1_ps(s_PiOver2B)));
+    y = _mm_sub_ps(y, _mm_mul_ps(q, _mm_set1_ps(s_PiOver2C)));
+    __m128 z = _mm_mul_ps(y, y);
+
+    __m128 s = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(s_SinC0)), _mm_set1_ps(s_SinC1));
+    s = _mm_add_ps(_mm_mul_ps(z, s), _mm_set1_ps(s_SinC2));
+    s = _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(y, z), s));
+    __m128 c = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(s_CosC0)), _mm_set1_ps(s_CosC1));
+    c = _mm_add_ps(_mm_mul_ps(z, c), _mm_set1_ps(s_CosC2));
+    c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_mul_ps(_mm_mul_ps(z, z), c));
+
+    const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+    __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+    __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+    sinOut = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s)), sinSign);
+    cosOut = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c)), cosSign);
+}
+
+static void GenerateSSE2(const SpriteBatch& sprites, size_t first, size_t count, const uint32_t* texSlots, QuadVertex* out)
+{
+    const __m128 half = _mm_set1_ps(0.5f);
+    size_t n = 0;
+    for (; n + 4 <= count; n += 4)
+    {
+        size_t i = first + n;
+        __m128 s, c;
+        SinCos4(_mm_loadu_ps(&sprites.Rotation[i]), s, c);
+        __m128 hw = _mm_mul_ps(_mm_loadu_ps(&sprites.Width[i]), half);
+        __m128 hh = _mm_mul_ps(_mm_loadu_ps(&sprites.Height[i]), half);
+        __m128 ax = _mm_mul_ps(c, hw), ay = _mm_mul_ps(s, hw);
+        __m128 bx = _mm_mul_ps(s, hh), by = _mm_mul_ps(c, hh);
+        __m128 x = _mm_loadu_ps(&sprites.X[i]), y = _mm_loadu_ps(&sprites.Y[i]);
+
+        // 四个角的顺序和标量版一样
+        const __m128 cornerX[4] = {
+            _mm_add_ps(_mm_sub_ps(x, ax), bx), _mm_add_ps(_mm_add_ps(x, ax), bx),
+            _mm_sub_ps(_mm_add_ps(x, ax), bx), _mm_sub_ps(_mm_sub_ps(x, ax), bx)
+        };
+        const __m128 cornerY[4] = {
+            _mm_sub_ps(_mm_sub_ps(y, ay), by), _mm_sub_ps(_mm_add_ps(y, ay), by),
+            _mm_add_ps(_mm_add_ps(y, ay), by), _mm_add_ps(_mm_sub_ps(y, ay), by)
+        };
+
+        __m128i color = PackColors4(_mm_loadu_ps(&sprites.R[i]), _mm_loadu_ps(&sprites.G[i]), _mm_loadu_ps(&sprites.B[i]), _mm_loadu_ps(&sprites.A[i]));
+        __m128i u0 = PackUnorm4(_mm_loadu_ps(&sprites.U0[i]), 65535.0f), u1 = PackUnorm4(_mm_loadu_ps(&sprites.U1[i]), 65535.0f);
+        __m128i v0 = _mm_slli_epi32(PackUnorm4(_mm_loadu_ps(&sprites.V0[i]), 65535.0f), 16);
+        __m128i v1 = _mm_slli_epi32(PackUnorm4(_mm_loadu_ps(&sprites.V1[i]), 65535.0f), 16);
+        const __m128i texCoord[4] = { _mm_or_si128(u0, v0), _mm_or_si128(u1, v0), _mm_or_si128(u1, v1), _mm_or_si128(u0, v1) };
+        StoreQuads4(out + n * 4, cornerX, cornerY, _mm_loadu_ps(&sprites.Z[i]), color, texCoord,
+            _mm_loadu_si128((const __m128i*)(texSlots + n)));
+    }
+    // 不足 4 个的尾巴
+    GenerateScalar(sprites, first + n, count - n, texSlots + n, out + n * 4);
+}
+#endif
+
+// ---------------- AVX2 + FMA ----------------
+
+SPRITE_TARGET_AVX2
+static inline void SinCos8(__m256 x, __m256& sinOut, __m256& cosOut)
+{
+    __m256i quadrant = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(s_TwoOverPi)));
+    __m256 q = _mm256_cvtepi32_ps(quadrant);
+    __m256 y = _mm256_fnmadd_ps(q, _mm256_set1_ps(s_PiOver2A), x);
+    y = _mm256_fnmadd_ps(q, _mm256_set1_ps(s_PiOver2B), y);
+    y = _mm256_fnmadd_ps(q, _mm256_set1_ps(s_PiOver2C), y);
+    __m256 z = _mm256_mul_ps(y, y);
+
+    __m256 s = _mm256_fmadd_ps(z, _mm256_set1_ps(s_SinC0), _mm256_set1_ps(s_SinC1));
+    s = _mm256_fmadd_ps(z, s, _mm256_set1_ps(s_SinC2));
+    s = _mm256_fmadd_ps(_mm256_mul_ps(y, z), s, y);
+    __m256 c = _mm256_fmadd_ps(z, _mm256_set1_ps(s_CosC0), _mm256_set1_ps(s_CosC1));
+    c = _mm256_fmadd_ps(z, c, _mm256_set1_ps(s_CosC2));
+    c = _mm256_fmadd_ps(_mm256_mul_ps(z, z), c, _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, _mm256_set1_ps(1.0f)));
+
+    const __m256i one = _mm256_set1_epi32(1), two = _mm256_set1_epi32(2);
+    __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, one), one));
+    __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, two), 30));
+    __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, one), two), 30));
+    sinOut = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sinSign);
+    cosOut = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosSign);
+}
+
+SPRITE_TARGET_AVX2
+static inline __m256i PackUnorm8(__m256 value, float scale)
+{
+    value = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+    return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(value, _mm256_set1_ps(scale)), _mm256_set1_ps(0.5f)));
+}
+
+SPRITE_TARGET_AVX2
+static void GenerateAVX2(const SpriteBatch& sprites, size_t first, size_t count, const uint32_t* texSlots, QuadVertex* out)
+{
+    const __m256 half = _mm256_set1_ps(0.5f);
+    size_t n = 0;
+    for (; n + 8 <= count; n += 8)
+    {
+        size_t i = first + n;
+        __m256 s, c;
+        SinCos8(_mm256_loadu_ps(&sprites.Rotation[i]), s, c);
+        __m256 hw = _mm256_mul_ps(_mm256_loadu_ps(&sprites.Width[i]), half);
+        __m256 hh = _mm256_mul_ps(_mm256_loadu_ps(&sprites.Height[i]), half);
+        __m256 ax = _mm256_mul_ps(c, hw), ay = _mm256_mul_ps(s, hw);
+        __m256 bx = _mm256_mul_ps(s, hh), by = _mm256_mul_ps(c, hh);
+        __m256 x = _mm256_loadu_ps(&sprites.X[i]), y = _mm256_loadu_ps(&sprites.Y[i]);
+
+        const __m256 cornerX[4] = {
+            _mm256_add_ps(_mm256_sub_ps(x, ax), bx), _mm256_add_ps(_mm256_add_ps(x, ax), bx),
+            _mm256_sub_ps(_mm256_add_ps(x, ax), bx), _mm256_sub_ps(_mm256_sub_ps(x, ax), bx)
+        };
+        const __m256 cornerY[4] = {
+            _mm256_sub_ps(_mm256_sub_ps(y, ay), by), _mm256_sub_ps(_mm256_add_ps(y, ay), by),
+            _mm256_add_ps(_mm256_add_ps(y, ay), by), _mm256_add_ps(_mm256_sub_ps(y, ay), by)
+        };
+
+        __m256i color = _mm256_or_si256(
+            _mm256_or_si256(PackUnorm8(_mm256_loadu_ps(&sprites.R[i]), 255.0f), _mm256_slli_epi32(PackUnorm8(_mm256_loadu_ps(&sprites.G[i]), 255.0f), 8)),
+            _mm256_or_si256(_mm256_slli_epi32(PackUnorm8(_mm256_loadu_ps(&sprites.B[i]), 255.0f), 16), _mm256_slli_epi32(PackUnorm8(_mm256_loadu_ps(&sprites.A[i]), 255.0f), 24)));
+        __m256i u0 = PackUnorm8(_mm256_loadu_ps(&sprites.U0[i]), 65535.0f), u1 = PackUnorm8(_mm256_loadu_ps(&sprites.U1[i]), 65535.0f);
+        __m256i v0 = _mm256_slli_epi32(PackUnorm8(_mm256_loadu_ps(&sprites.V0[i]), 65535.0f), 16);
+        __m256i v1 = _mm256_slli_epi32(PackUnorm8(_mm256_loadu_ps(&sprites.V1[i]), 65535.0f), 16);
+        const __m256i texCoord[4] = { _mm256_or_si256(u0, v0), _mm256_or_si256(u1, v0), _mm256_or_si256(u1, v1), _mm256_or_si256(u0, v1) };
+
+        // 写顶点要转置, 跨 128 位通道的转置很麻烦, 拆成前后各 4 个交给 SSE 的写法
+        for (int part = 0; part < 2; part++)
+        {
+            size_t j = i + part * 4;
+            __m128 partX[4], partY[4];
+            __m128i partTexCoord[4];
+            for (int k = 0; k < 4; k++)
+            {
+                partX[k] = part ? _mm256_extractf128_ps(cornerX[k], 1) : _mm256_castps256_ps128(cornerX[k]);
+                partY[k] = part ? _mm256_extractf128_ps(cornerY[k], 1) : _mm256_castps256_ps128(cornerY[k]);
+                partTexCoord[k] = part ? _mm256_extracti128_si256(texCoord[k], 1) : _mm256_castsi256_si128(texCoord[k]);
+            }
+            __m128i partColor = part ? _mm256_extracti128_si256(color, 1) : _mm256_castsi256_si128(color);
+            StoreQuads4(out + (n + part * 4) * 4, partX, partY, _mm_loadu_ps(&sprites.Z[j]), partColor, partTexCoord,
+                _mm_loadu_si128((const __m128i*)(texSlots + n + part * 4)));
+        }
+    }
+    GenerateScalar(sprites, first + n, count - n, texSlots + n, out + n * 4);
+}
+
+// AVX2 要 CPU 支持, 还要操作系统在切换线程时保存 YMM 寄存器 (OSXSAVE + XCR0)
+static bool DetectAVX2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    bool fma = (info[2] & (1 << 12)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!fma || !osxsave || !avx)
+        return false;
+    if ((_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+#endif // SPRITE_KERNELS_X86
+
+// ---------------- 分派 ----------------
+
+static SpriteKernels::Kernel s_Kernel = SpriteKernels::GetBestKernel();
+
+void SpriteKernels::GenerateVertices(const SpriteBatch& sprites, size_t first, size_t count, const uint32_t* texSlots, QuadVertex* out)
+{
+    PROFILE_FUNCTION();
+    switch (s_Kernel)
+    {
+#ifdef SPRITE_KERNELS_X86
+    case Kernel::AVX2:
+        GenerateAVX2(sprites, first, count, texSlots, out);
+        return;
+#endif
+#ifdef SPRITE_KERNELS_SSE2
+    case Kernel::SSE2:
+        GenerateSSE2(sprites, first, count, texSlots, out);
+        return;
+#endif
+    default:
+        GenerateScalar(sprites, first, count, texSlots, out);
+        return;
+    }
+}
+
+bool SpriteKernels::IsSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef SPRITE_KERNELS_X86
+    case Kernel::AVX2:
+    {
+        static const bool supported = DetectAVX2();
+        return supported;
+    }
+#endif
+#ifdef SPRITE_KERNELS_SSE2
+    case Kernel::SSE2:
+        return true;
+#endif
+    case Kernel::Scalar:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void SpriteKernels::SetKernel(Kernel kernel)
+{
+    s_Kernel = IsSupported(kernel) ? kernel : GetBestKernel();
+}
+
+SpriteKernels::Kernel SpriteKernels::GetKernel()
+{
+    return s_Kernel;
+}
+
+SpriteKernels::Kernel SpriteKernels::GetBestKernel()
+{
+    if (IsSupported(Kernel::AVX2))
+        return Kernel::AVX2;
+    if (IsSupported(Kernel::SSE2))
+        return Kernel::SSE2;
+    return Kernel::Scalar;
+}
+
+const char* SpriteKernels::GetName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::AVX2: return "AVX2";
+    case Kernel::SSE2: return "SSE2";
+    default: return "Scalar";
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "BatchRenderer2D.h"
+
+class Texture;
+
+// 加一个 sprite 时用的参数, 存进 SpriteBatch 之后按分量拆开
+struct SpriteDesc
+{
+	glm::vec3 Position = glm::vec3(0.0f); // 中心
+	glm::vec2 Size = glm::vec2(1.0f);
+	float Rotation = 0.0f;                 // 弧度, 绕中心逆时针
+	glm::vec2 UVMin = glm::vec2(0.0f);
+	glm::vec2 UVMax = glm::vec2(1.0f);
+	glm::vec4 Color = glm::vec4(1.0f);
+	const Texture* Tex = nullptr;          // 为空时是纯色
+};
+
+/**
+ * 按分量分开存的一组 sprite (SoA):
+ *      每个属性一个连续数组, 生成顶点的 SIMD 内核可以一次读 4 个 (SSE) 或 8 个 (AVX2) sprite 的同一个属性。
+ *      调用者可以直接改数组 (比如每帧只更新 X / Y / Rotation), 所有数组的长度必须保持一致。
+ *      交给 BatchRenderer2D::DrawSprites 画。
+ */
+class SpriteBatch
+{
+public:
+	std::vector<float> X, Y, Z;
+	std::vector<float> Width, Height;
+	std::vector<float> Rotation;
+	std::vector<float> U0, V0, U1, V1;
+	std::vector<float> R, G, B, A;
+	std::vector<const Texture*> Textures;
+
+public:
+	void Clear();
+	void Reserve(size_t count);
+	// 返回新 sprite 的下标
+	size_t Add(const SpriteDesc& sprite);
+
+	inline size_t Size() const { return X.size(); }
+};
+
+/**
+ * 生成批渲染顶点的内核:
+ *      把 SpriteBatch 里的一段 sprite 变换成 4 个 QuadVertex 一组的交错顶点流。
+ *      有 Scalar / SSE2 / AVX2 (+FMA) 三个版本, 第一次使用时按 CPU 支持的指令集自动选最快的,
+ *      AVX2 版本用函数级的 target 属性编译, 不需要给整个工程加 -mavx2, 在老 CPU 上也能运行。
+ *      三个版本用同样的多项式算 sin/cos, 结果只在 FMA 的舍入上有差别。
+ */
+class SpriteKernels
+{
+public:
+	enum class Kernel
+	{
+		Scalar, SSE2, AVX2
+	};
+
+	// texSlots[i] 是第 first + i 个 sprite 的纹理插槽, out 要能放下 count * 4 个顶点
+	static void GenerateVertices(const SpriteBatch& sprites, size_t first, size_t count, const uint32_t* texSlots, QuadVertex* out);
+
+	static bool IsSupported(Kernel kernel);
+	// 不支持的内核会退回到支持的最快的那个
+	static void SetKernel(Kernel kernel);
+	static Kernel GetKernel();
+	// CPU 支持的最快的内核
+	static Kernel GetBestKernel();
+	static const char* GetName(Kernel kernel);
+};
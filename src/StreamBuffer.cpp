@@ -0,0 +1,138 @@
+#include "StreamBuffer.h"
+
+#include <cstring>
+
+#include "Render.h"
+#include "GLState.h"
+
+StreamBuffer::StreamBuffer(unsigned int target, unsigned int capacity, Mode mode)
+    : m_RendererID(0), m_Target(target), m_Capacity(capacity), m_Mode(mode),
+    m_MappedPtr(nullptr), m_Fences{}, m_Segment(0), m_SegmentOffset(0)
+{
+    if (m_Mode == Mode::Persistent && !GLEW_ARB_buffer_storage)
+    {
+        std::cout << "Warning: ARB_buffer_storage not supported, falling back to buffer orphaning" << std::endl;
+        m_Mode = Mode::Orphan;
+    }
+
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLState::BindBuffer(m_Target, m_RendererID);
+
+    if (m_Mode == Mode::Persistent)
+    {
+        // 不可变存储, 映射一次一直用到析构; COHERENT 保证写入对GPU可见, 不需要手动 flush
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLCall(glBufferStorage(m_Target, (GLsizeiptr)m_Capacity * SegmentCount, nullptr, flags));
+        void* ptr;
+        GLCall(ptr = glMapBufferRange(m_Target, 0, (GLsizeiptr)m_Capacity * SegmentCount, flags));
+        m_MappedPtr = (unsigned char*)ptr;
+    }
+    else
+    {
+        GLCall(glBufferData(m_Target, m_Capacity, nullptr, m_Mode == Mode::Orphan ? GL_STREAM_DRAW : GL_DYNAMIC_DRAW));
+    }
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    for (unsigned int i = 0; i < SegmentCount; i++)
+    {
+        if (m_Fences[i])
+        {
+            GLCall(glDeleteSync((GLsync)m_Fences[i]));
+        }
+    }
+
+    if (m_MappedPtr)
+    {
+        GLState::BindBuffer(m_Target, m_RendererID);
+        GLCall(glUnmapBuffer(m_Target));
+    }
+    GLState::OnBufferDeleted(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void StreamBuffer::Bind() const
+{
+    GLState::BindBuffer(m_Target, m_RendererID);
+}
+
+void StreamBuffer::Unbind() const
+{
+    GLState::BindBuffer(m_Target, 0);
+}
+
+unsigned int StreamBuffer::SetData(const void* data, unsigned int size)
+{
+    ASSERT(size <= m_Capacity);
+
+    switch (m_Mode)
+    {
+        case Mode::SubData:
+        {
+            GLState::BindBuffer(m_Target, m_RendererID);
+            GLCall(glBufferSubData(m_Target, 0, size, data));
+            return 0;
+        }
+        case Mode::Orphan:
+        {
+            // 先孤立旧存储再写, 这样不用等GPU读完上一批
+            GLState::BindBuffer(m_Target, m_RendererID);
+            GLCall(glBufferData(m_Target, m_Capacity, nullptr, GL_STREAM_DRAW));
+            GLCall(glBufferSubData(m_Target, 0, size, data));
+            return 0;
+        }
+        case Mode::Persistent:
+        {
+            // 当前段放不下就换下一段
+            if (m_SegmentOffset + size > m_Capacity)
+                NextSegment();
+
+            unsigned int offset = m_Segment * m_Capacity + m_SegmentOffset;
+            memcpy(m_MappedPtr + offset, data, size);
+            m_SegmentOffset += size;
+            return offset;
+        }
+    }
+    return 0;
+}
+
+void StreamBuffer::SubData(const void* data, unsigned int size, unsigned int offset)
+{
+    if (m_Mode == Mode::Persistent)
+    {
+        ASSERT(offset + size <= m_Capacity * SegmentCount);
+        memcpy(m_MappedPtr + offset, data, size);
+        return;
+    }
+
+    ASSERT(offset + size <= m_Capacity);
+    GLState::BindBuffer(m_Target, m_RendererID);
+    GLCall(glBufferSubData(m_Target, offset, size, data));
+}
+
+void StreamBuffer::NextSegment()
+{
+    // 当前段之前的所有 draw call 都已经发出, 插一个 fence 标记 "GPU读完这一段"
+    GLsync fence;
+    GLCall(fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    m_Fences[m_Segment] = fence;
+
+    m_Segment = (m_Segment + 1) % SegmentCount;
+    m_SegmentOffset = 0;
+
+    // 下一段如果GPU还没用完就等它 (三重缓冲下通常已经 signaled, 不会真正等待)
+    if (m_Fences[m_Segment])
+    {
+        GLsync next = (GLsync)m_Fences[m_Segment];
+        while (true)
+        {
+            GLenum result;
+            GLCall(result = glClientWaitSync(next, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000)); // 1ms
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+                break;
+        }
+        GLCall(glDeleteSync(next));
+        m_Fences[m_Segment] = nullptr;
+    }
+}
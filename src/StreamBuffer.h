@@ -0,0 +1,57 @@
+#pragma once
+
+/**
+ * 每帧都要更新内容的缓冲区 (DynamicVertexBuffer / DynamicIndexBuffer 的公共实现)。
+ * 三种更新方式:
+ *      SubData:    直接 glBufferSubData, 如果GPU还在读旧数据, 驱动会隐式同步 (CPU等GPU)。
+ *      Orphan:     每次写之前先 glBufferData(nullptr) "孤立" 旧存储, 驱动给一块新内存, 旧的等GPU用完再回收。
+ *      Persistent: ARB_buffer_storage 持久映射, 缓冲区分成 SegmentCount 段循环使用,
+ *                  每段用完后插入 fence, 再次轮到这段时先等 fence, 正常情况下GPU早就用完了, CPU不会卡住。
+ *                  驱动不支持 ARB_buffer_storage 时自动退回 Orphan。
+ * 注意: Persistent 模式下数据不一定从0开始, 画的时候要用 SetData 返回的偏移
+ *      (顶点用 glDrawElementsBaseVertex, 索引用 glDrawElements 的 indices 参数)。
+ */
+class StreamBuffer
+{
+public:
+	enum class Mode
+	{
+		SubData, Orphan, Persistent
+	};
+
+	static const unsigned int SegmentCount = 3; // 三重缓冲
+
+private:
+	unsigned int m_RendererID;
+	unsigned int m_Target;   // GL_ARRAY_BUFFER / GL_ELEMENT_ARRAY_BUFFER
+	unsigned int m_Capacity; // 一段的大小 (字节), 非持久模式下就是整个缓冲区大小
+	Mode m_Mode;
+
+	// 持久映射相关
+	unsigned char* m_MappedPtr;
+	void* m_Fences[SegmentCount]; // GLsync
+	unsigned int m_Segment;       // 当前写入的段
+	unsigned int m_SegmentOffset; // 当前段已经写了多少字节
+
+public:
+	StreamBuffer(unsigned int target, unsigned int capacity, Mode mode = Mode::Persistent);
+	~StreamBuffer();
+
+	StreamBuffer(const StreamBuffer&) = delete;
+	StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+	void Bind() const;
+	void Unbind() const;
+
+	// 写入一块新数据, 返回这块数据在缓冲区中的字节偏移 (非持久模式下总是0)
+	unsigned int SetData(const void* data, unsigned int size);
+	// 在绝对偏移 offset 处修改部分数据, 调用者保证GPU不再读这块 (一般紧跟在 SetData 之后, 用它返回的偏移)
+	void SubData(const void* data, unsigned int size, unsigned int offset);
+
+	inline Mode GetMode() const { return m_Mode; }
+	inline unsigned int GetCapacity() const { return m_Capacity; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+
+private:
+	void NextSegment();
+};
@@ -1,47 +1,270 @@
 #include "Texture.h"
+
+#include <vector>
+
+#include "GLState.h"
+#include "Profiler.h"
+#include "CompressedImage.h"
+#include "AssetPack.h"
 #include "vendor/stb_image/stb_image.h"
 
-Texture::Texture(const std::string& path)
-	:m_RendererID(0), m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0)
+Texture::Texture(const std::string& path, const TextureSpec& spec)
+	:m_RendererID(0), m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0), m_IsLoaded(true),
+	m_Spec(spec), m_InternalFormat(GL_RGBA8), m_LevelCount(1)
 {
-    // 用 stb库加载图片为buffer
-	stbi_set_flip_vertically_on_load(1);
-	m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
-
+	PROFILE_SCOPE("Texture::Texture");
     // 创建texture对象，opengl绑定对象
 	GLCall(glGenTextures(1, &m_RendererID));
-	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+	GLState::BindTexture(m_RendererID);
 
-    // 设置纹理参数
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+	if (!LoadFromPack(path))
+	{
+		if (IsCompressedImagePath(path))
+			LoadCompressed(path);
+		else
+			LoadImage(path);
+	}
 
-    // 图片上传到gpu
-	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
+    // 设置纹理参数
+	ApplyParameters();
 
     // 解绑
-	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+	GLState::BindTexture(0);
+}
+
+Texture::Texture(int width, int height, const TextureSpec& spec)
+	:m_RendererID(0), m_LocalBuffer(nullptr), m_Width(width), m_Height(height), m_BPP(4), m_IsLoaded(true),
+	m_Spec(spec), m_InternalFormat(GL_RGBA8), m_LevelCount(1)
+{
+	GLCall(glGenTextures(1, &m_RendererID));
+	GLState::BindTexture(m_RendererID);
+
+	// 只分配存储, 不上传数据
+	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+	GenerateMips();
+	ApplyParameters();
+	GLState::BindTexture(0);
+}
+
+Texture::~Texture()
+{
+	GLState::OnTextureDeleted(m_RendererID);
+	GLCall(glDeleteTextures(1, &m_RendererID));
+}
+
+bool Texture::LoadFromPack(const std::string& path)
+{
+	AssetPack* pack = AssetPack::GetMounted();
+	PackedTexture packed;
+	if (!pack || !pack->GetTexture(path, packed))
+		return false;
+
+	m_Width = packed.Width;
+	m_Height = packed.Height;
+	if (packed.IsCompressed)
+		UploadCompressed(packed.Compressed);
+	else if (m_Spec.KeepChannels || packed.Channels == 4)
+		UploadPixels(packed.Channels, packed.Pixels); // 直接从映射的内存上传
+	else
+	{
+		// 和 LoadImage 一样, 没有要求保留通道数时统一成 RGBA
+		std::vector<unsigned char> rgba((size_t)m_Width * m_Height * 4);
+		ExpandToRGBA(packed, rgba.data());
+		UploadPixels(4, rgba.data());
+	}
+	return true;
+}
+
+void Texture::LoadImage(const std::string& path)
+{
+    // 用 stb库加载图片为buffer, KeepChannels 时保留原始通道数
+	stbi_set_flip_vertically_on_load(1);
+	int desiredChannels = m_Spec.KeepChannels ? 0 : 4;
+	m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, desiredChannels);
+	if (!m_LocalBuffer)
+	{
+		std::cout << "Warning: failed to load texture '" << path << "'" << std::endl;
+		m_Width = m_Height = 0;
+	}
+
+	UploadPixels(m_Spec.KeepChannels ? m_BPP : 4, m_LocalBuffer);
 
 	if (m_LocalBuffer) {
 		stbi_image_free(m_LocalBuffer);
+		m_LocalBuffer = nullptr;
 	}
 }
 
-Texture::~Texture()
+void Texture::UploadPixels(int channels, const unsigned char* pixels)
 {
-	GLCall(glDeleteTextures(1, &m_RendererID));
+	GLenum format = GL_RGBA;
+	switch (channels)
+	{
+		case 1: m_InternalFormat = GL_R8;    format = GL_RED;  break;
+		case 2: m_InternalFormat = GL_RG8;   format = GL_RG;   break;
+		case 3: m_InternalFormat = GL_RGB8;  format = GL_RGB;  break;
+		default: m_InternalFormat = GL_RGBA8; format = GL_RGBA; break;
+	}
+	m_BPP = channels;
+
+	// 少于4通道时每行不一定是4字节对齐的
+	if (channels != 4)
+	{
+		GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+	}
+
+    // 图片上传到gpu
+	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, m_InternalFormat, m_Width, m_Height, 0, format, GL_UNSIGNED_BYTE, pixels));
+
+	if (channels != 4)
+	{
+		GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+	}
+
+	// 灰度图在着色器里要像普通图片一样采样: R -> RGB, (G 作为 alpha)
+	if (channels == 1)
+	{
+		GLint swizzle[] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+		GLCall(glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle));
+	}
+	else if (channels == 2)
+	{
+		GLint swizzle[] = { GL_RED, GL_RED, GL_RED, GL_GREEN };
+		GLCall(glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle));
+	}
+
+	GenerateMips();
+}
+
+void Texture::LoadCompressed(const std::string& path)
+{
+	CompressedImage image;
+	if (!LoadCompressedImage(path, image))
+		image.Levels.clear(); // 解析失败时不上传半成品, 走 UploadCompressed 里的品红色占位
+	UploadCompressed(image);
+}
+
+void Texture::UploadCompressed(const CompressedImage& image)
+{
+	if (image.Levels.empty() || !IsCompressedFormatSupported(image.InternalFormat))
+	{
+		// 用一个 1x1 的品红色纹理顶替, 一眼就能看出来
+		std::cout << "Warning: cannot use compressed texture '" << m_FilePath << "'" << std::endl;
+		unsigned int magenta = 0xffff00ff;
+		m_Width = m_Height = 1;
+		GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &magenta));
+		return;
+	}
+
+	m_Width = image.Width;
+	m_Height = image.Height;
+	m_BPP = 0; // 压缩格式没有"每像素字节数"
+	m_InternalFormat = image.InternalFormat;
+	m_LevelCount = (unsigned int)image.Levels.size();
+
+	for (unsigned int i = 0; i < m_LevelCount; i++)
+	{
+		const CompressedImage::Level& level = image.Levels[i];
+		GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, i, m_InternalFormat, level.Width, level.Height, 0, level.Size, level.Data));
+	}
+	// 告诉GL只有这么多级, 否则缺级的纹理是不完整的, 采样结果全黑
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_LevelCount - 1));
+}
+
+void Texture::GenerateMips()
+{
+	if (!m_Spec.GenerateMips || m_Width <= 0 || m_Height <= 0)
+		return;
+
+	GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+	unsigned int levels = 1;
+	for (int size = m_Width > m_Height ? m_Width : m_Height; size > 1; size >>= 1)
+		levels++;
+	m_LevelCount = levels;
+}
+
+void Texture::ApplyParameters()
+{
+	bool nearest = m_Spec.Filter == TextureFilter::Nearest;
+	GLint minFilter = nearest ? GL_NEAREST : GL_LINEAR;
+	if (m_LevelCount > 1)
+		minFilter = nearest ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR;
+	GLint wrap = m_Spec.Wrap == TextureWrap::Repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, nearest ? GL_NEAREST : GL_LINEAR));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap));
+	GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap));
+
+	if (m_Spec.Anisotropy > 1.0f && (GLEW_EXT_texture_filter_anisotropic || GLEW_ARB_texture_filter_anisotropic))
+	{
+		float maxAnisotropy = 1.0f;
+		GLCall(glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy));
+		float anisotropy = m_Spec.Anisotropy < maxAnisotropy ? m_Spec.Anisotropy : maxAnisotropy;
+		GLCall(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy));
+	}
 }
 
 // slot 偏移量，有很多纹理插槽，绑定哪个
 void Texture::Bind(unsigned int slot) const
 {
-	GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-	GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+	GLState::BindTexture(slot, m_RendererID);
 }
 
 void Texture::Unbind()
 {
-	GLCall(glBindTexture(GL_TEXTURE_2D, 0));
-}
\ No newline at end of file
+	GLState::BindTexture(0);
+}
+
+size_t Texture::GetMemorySize() const
+{
+	unsigned int blockSize = GetCompressedBlockSize(m_InternalFormat);
+	unsigned int pixelSize = 4;
+	switch (m_InternalFormat)
+	{
+		case GL_R8:   pixelSize = 1; break;
+		case GL_RG8:  pixelSize = 2; break;
+		case GL_RGB8: pixelSize = 3; break;
+	}
+
+	size_t total = 0;
+	int width = m_Width, height = m_Height;
+	for (unsigned int level = 0; level < m_LevelCount; level++)
+	{
+		if (blockSize)
+			total += (size_t)((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+		else
+			total += (size_t)width * height * pixelSize;
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+	return total;
+}
+
+void Texture::SetData(const void* data, unsigned int size)
+{
+	ASSERT(size == (unsigned int)(m_Width * m_Height * 4));
+	GLState::BindTexture(m_RendererID);
+	GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, data));
+	GenerateMips();
+}
+
+void Texture::SetSubData(int x, int y, int width, int height, const void* data)
+{
+	ASSERT(x >= 0 && y >= 0 && x + width <= m_Width && y + height <= m_Height);
+	GLState::BindTexture(m_RendererID);
+	GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data));
+	GenerateMips();
+}
+
+void Texture::SetImage(int width, int height, const void* data)
+{
+	m_Width = width;
+	m_Height = height;
+	m_InternalFormat = GL_RGBA8;
+	m_LevelCount = 1;
+	GLState::BindTexture(m_RendererID);
+	GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data));
+	GenerateMips();
+	ApplyParameters();
+}
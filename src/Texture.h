@@ -2,6 +2,28 @@
 
 #include "Render.h"
 
+struct CompressedImage;
+
+enum class TextureFilter
+{
+	Nearest, Linear
+};
+
+enum class TextureWrap
+{
+	ClampToEdge, Repeat
+};
+
+// 创建纹理时的参数
+struct TextureSpec
+{
+	TextureFilter Filter = TextureFilter::Linear;
+	TextureWrap Wrap = TextureWrap::ClampToEdge;
+	bool GenerateMips = false; // 生成 mipmap, 缩小时用三线性过滤 (压缩纹理用文件里自带的 mipmap)
+	float Anisotropy = 1.0f;   // > 1 时开启各向异性过滤, 会被限制在驱动支持的最大值以内
+	bool KeepChannels = true;  // 按图片本身的通道数选内部格式 (灰度图用 GL_R8 而不是 GL_RGBA8)
+};
+
 class Texture
 {
 private:
@@ -9,13 +31,49 @@ private:
 	std::string m_FilePath; // 图片路径
 	unsigned char* m_LocalBuffer; // 图片在内存中的buffer
 	int m_Width, m_Height, m_BPP; // 宽度，高度，每像素字节数
+	bool m_IsLoaded; // 异步加载时, 图片上传之前是 false (显示的是占位纹理)
+	TextureSpec m_Spec;
+	unsigned int m_InternalFormat; // GL_RGBA8 / GL_R8 / GL_COMPRESSED_* ...
+	unsigned int m_LevelCount;     // mipmap 级数, 1 表示没有 mipmap
+
+	friend class TextureLoader;
 public:
-	Texture(const std::string& path);
+	// 挂载了资源包并且包里有这个路径时直接从包里上传;
+	// 否则 .dds / .ktx 按预压缩格式加载, 其他格式用 stb_image 解码
+	Texture(const std::string& path, const TextureSpec& spec = TextureSpec());
+	// 创建一张空的 RGBA8 纹理, 之后用 SetData 填充 (例如批渲染用的 1x1 白色纹理)
+	Texture(int width, int height, const TextureSpec& spec = TextureSpec());
 	~Texture();
 
 	void Bind(unsigned int slot = 0) const;
 	void Unbind();
 
+	// 下面几个只用于 RGBA8 纹理
+	// data 必须是 width * height 个 RGBA8 像素
+	void SetData(const void* data, unsigned int size);
+	// 只更新 (x, y) 开始的 width x height 区域, data 是紧密排列的 RGBA8 像素
+	void SetSubData(int x, int y, int width, int height, const void* data);
+	// 重新分配存储并上传 (尺寸可以变), 绑定了 GL_PIXEL_UNPACK_BUFFER 时 data 是PBO里的偏移
+	void SetImage(int width, int height, const void* data);
+
 	inline int GetWidth() const { return m_Width; }
 	inline int GetHeight() const { return m_Height; }
-};
\ No newline at end of file
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+	inline const std::string& GetFilePath() const { return m_FilePath; }
+	inline bool IsLoaded() const { return m_IsLoaded; }
+	inline unsigned int GetInternalFormat() const { return m_InternalFormat; }
+	inline unsigned int GetLevelCount() const { return m_LevelCount; }
+	// 按内部格式和 mipmap 级数估算的显存占用 (字节), 驱动实际分配的可能有对齐
+	size_t GetMemorySize() const;
+
+private:
+	bool LoadFromPack(const std::string& path);
+	void LoadImage(const std::string& path);
+	void LoadCompressed(const std::string& path);
+	// 上传 channels 个 8bit 通道的像素 (已经翻转好), 按通道数选内部格式
+	void UploadPixels(int channels, const unsigned char* pixels);
+	void UploadCompressed(const CompressedImage& image);
+	// 按 m_Spec 设置过滤/环绕/各向异性参数, 纹理必须已经绑定
+	void ApplyParameters();
+	void GenerateMips();
+};
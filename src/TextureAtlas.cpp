@@ -0,0 +1,142 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+
+
+#include "vendor/stb_image/stb_image.h"
+
+// imgui_draw.cpp 里的实现是 static 的, 这里再编译一份自己用
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "vendor/imgui/imstb_rectpack.h"
+
+struct AtlasPage
+{
+    std::unique_ptr<Texture> PageTexture;
+    stbrp_context Context;
+    std::vector<stbrp_node> Nodes; // Context 里保存了指向它的指针, 所以 AtlasPage 不能被移动
+};
+
+TextureAtlas::TextureAtlas(int pageSize, int padding)
+    : m_PageSize(pageSize), m_Padding(padding)
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+}
+
+AtlasPage& TextureAtlas::CreatePage()
+{
+    auto page = std::make_unique<AtlasPage>();
+    page->PageTexture = std::make_unique<Texture>(m_PageSize, m_PageSize);
+
+    // 新页先清成透明, 装箱剩下的空隙里不会有垃圾数据
+    std::vector<unsigned char> clear((size_t)m_PageSize * m_PageSize * 4, 0);
+    page->PageTexture->SetData(clear.data(), (unsigned int)clear.size());
+
+    // 节点数 >= 宽度时 stbrp 保证不会因为节点不够而失败
+    page->Nodes.resize(m_PageSize);
+    stbrp_init_target(&page->Context, m_PageSize, m_PageSize, page->Nodes.data(), (int)page->Nodes.size());
+
+    m_Pages.push_back(std::move(page));
+    return *m_Pages.back();
+}
+
+AtlasRegion TextureAtlas::Add(const std::string& path)
+{
+    if (const AtlasRegion* region = Find(path))
+        return *region;
+
+    int width, height, bpp;
+    stbi_set_flip_vertically_on_load(1);
+    unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &bpp, 4);
+    if (!pixels)
+    {
+        std::cout << "Warning: failed to load atlas image '" << path << "'" << std::endl;
+        return AtlasRegion();
+    }
+
+    AtlasRegion region = Add(path, width, height, pixels);
+    stbi_image_free(pixels);
+    return region;
+}
+
+AtlasRegion TextureAtlas::Add(const std::string& name, int width, int height, const unsigned char* pixels)
+{
+    if (const AtlasRegion* region = Find(name))
+        return *region;
+
+    int paddedWidth = width + m_Padding * 2;
+    int paddedHeight = height + m_Padding * 2;
+    if (paddedWidth > m_PageSize || paddedHeight > m_PageSize)
+    {
+        std::cout << "Warning: image '" << name << "' (" << width << "x" << height
+            << ") does not fit into a " << m_PageSize << " atlas page" << std::endl;
+        return AtlasRegion();
+    }
+
+    stbrp_rect rect = {};
+    rect.w = (stbrp_coord)paddedWidth;
+    rect.h = (stbrp_coord)paddedHeight;
+
+    // 先试已有的页, 都放不下再开新页
+    AtlasPage* target = nullptr;
+    for (auto& page : m_Pages)
+    {
+        if (stbrp_pack_rects(&page->Context, &rect, 1) && rect.was_packed)
+        {
+            target = page.get();
+            break;
+        }
+    }
+    if (!target)
+    {
+        target = &CreatePage();
+        stbrp_pack_rects(&target->Context, &rect, 1);
+        ASSERT(rect.was_packed);
+    }
+
+    // 把图片连同向外复制的边缘一起拷进带 padding 的临时缓冲
+    std::vector<unsigned char> padded((size_t)paddedWidth * paddedHeight * 4);
+    for (int y = 0; y < paddedHeight; y++)
+    {
+        int srcY = std::min(std::max(y - m_Padding, 0), height - 1);
+        for (int x = 0; x < paddedWidth; x++)
+        {
+            int srcX = std::min(std::max(x - m_Padding, 0), width - 1);
+            const unsigned char* src = pixels + ((size_t)srcY * width + srcX) * 4;
+            unsigned char* dst = padded.data() + ((size_t)y * paddedWidth + x) * 4;
+            dst[0] = src[0]; dst[1] = src[1]; dst[2] = src[2]; dst[3] = src[3];
+        }
+    }
+    target->PageTexture->SetSubData(rect.x, rect.y, paddedWidth, paddedHeight, padded.data());
+
+    AtlasRegion region;
+    region.Page = target->PageTexture.get();
+    region.Width = width;
+    region.Height = height;
+    region.UVMin = glm::vec2((float)(rect.x + m_Padding) / m_PageSize, (float)(rect.y + m_Padding) / m_PageSize);
+    region.UVMax = glm::vec2((float)(rect.x + m_Padding + width) / m_PageSize, (float)(rect.y + m_Padding + height) / m_PageSize);
+
+    m_Regions[name] = region;
+    return region;
+}
+
+const AtlasRegion* TextureAtlas::Find(const std::string& name) const
+{
+    auto it = m_Regions.find(name);
+    if (it == m_Regions.end())
+        return nullptr;
+    return &it->second;
+}
+
+unsigned int TextureAtlas::GetPageCount() const
+{
+    return (unsigned int)m_Pages.size();
+}
+
+const Texture& TextureAtlas::GetPage(unsigned int index) const
+{
+    return *m_Pages[index]->PageTexture;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Texture.h"
+
+// 图集里的一张小图: 在哪一页, 以及在那一页上的UV范围
+struct AtlasRegion
+{
+	const Texture* Page = nullptr;
+	glm::vec2 UVMin = glm::vec2(0.0f);
+	glm::vec2 UVMax = glm::vec2(1.0f);
+	int Width = 0, Height = 0; // 原图尺寸 (像素)
+
+	inline bool IsValid() const { return Page != nullptr; }
+};
+
+struct AtlasPage; // 每一页的 stb_rect_pack 状态, 定义在 TextureAtlas.cpp 里
+
+/**
+ * 纹理图集:
+ *      把很多小图打包进一张 (或几张) 大纹理, 画不同的图时不用切换纹理, 批渲染一批能画更多quad。
+ *      用 ImGui 自带的 imstb_rectpack 做矩形装箱, 支持随时往里加新图 (增量装箱),
+ *      当前所有页都放不下时自动开新的一页。
+ *      每张图四周留 padding 个像素, 并把边缘像素向外复制, 避免线性过滤时采样到相邻的图。
+ */
+class TextureAtlas
+{
+private:
+	int m_PageSize;
+	int m_Padding;
+	std::vector<std::unique_ptr<AtlasPage>> m_Pages;
+	std::unordered_map<std::string, AtlasRegion> m_Regions;
+
+public:
+	TextureAtlas(int pageSize = 2048, int padding = 1);
+	~TextureAtlas();
+
+	TextureAtlas(const TextureAtlas&) = delete;
+	TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+	// 用 stb_image 加载图片并放进图集, 同一个路径只会加一次; 失败时返回无效的 region
+	AtlasRegion Add(const std::string& path);
+	// 直接放入 RGBA8 像素, name 用来去重和查找
+	AtlasRegion Add(const std::string& name, int width, int height, const unsigned char* pixels);
+
+	// 没有时返回 nullptr
+	const AtlasRegion* Find(const std::string& name) const;
+
+	unsigned int GetPageCount() const;
+	const Texture& GetPage(unsigned int index) const;
+	inline unsigned int GetRegionCount() const { return (unsigned int)m_Regions.size(); }
+
+private:
+	AtlasPage& CreatePage();
+};
@@ -0,0 +1,152 @@
+#include "TextureLoader.h"
+
+#include <cstring>
+
+#include "Render.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "AssetPack.h"
+#include "vendor/stb_image/stb_image.h"
+
+TextureLoader* TextureLoader::s_Instance = nullptr;
+
+TextureLoader::TextureLoader(unsigned int workerCount, unsigned int uploadBudget)
+    : m_Decoded(QueueCapacity), m_Workers(workerCount), m_PixelBuffers{}, m_NextPixelBuffer(0),
+    m_UploadBudget(uploadBudget), m_Pending(0)
+{
+    GLCall(glGenBuffers(PixelBufferCount, m_PixelBuffers));
+    s_Instance = this;
+}
+
+TextureLoader::~TextureLoader()
+{
+    // 工作线程可能正卡在队列满的地方, 一边等一边把结果丢掉
+    DecodedImage image;
+    while (m_Pending.load() > 0)
+    {
+        if (m_Decoded.TryPop(image))
+        {
+            stbi_image_free(image.Pixels);
+            m_Pending--;
+        }
+        else
+            std::this_thread::yield();
+    }
+
+    for (unsigned int i = 0; i < PixelBufferCount; i++)
+        GLState::OnBufferDeleted(m_PixelBuffers[i]);
+    GLCall(glDeleteBuffers(PixelBufferCount, m_PixelBuffers));
+
+    if (s_Instance == this)
+        s_Instance = nullptr;
+}
+
+TextureLoader& TextureLoader::Get()
+{
+    ASSERT(s_Instance);
+    return *s_Instance;
+}
+
+std::shared_ptr<Texture> TextureLoader::Load(const std::string& path)
+{
+    // 占位纹理: 1x1 灰色
+    auto texture = std::make_shared<Texture>(1, 1);
+    unsigned int gray = 0xff808080;
+    texture->SetData(&gray, sizeof(unsigned int));
+    texture->m_FilePath = path;
+    texture->m_IsLoaded = false;
+
+    m_Pending++;
+    std::weak_ptr<Texture> target = texture;
+    m_Workers.Submit([this, path, target]() {
+        DecodedImage image;
+        image.Target = target;
+        // 纹理在解码前就被释放了就不用解码了, 但还是要放一个空结果进队列, 让 m_Pending 能减回去
+        if (!target.expired())
+        {
+            // 资源包里的图已经是可以直接上传的格式, 不用解码, 交给渲染线程
+            AssetPack* pack = AssetPack::GetMounted();
+            PackedTexture packed;
+            image.InPack = pack && pack->GetTexture(path, packed);
+        }
+        if (!target.expired() && !image.InPack)
+        {
+            PROFILE_SCOPE("TextureLoader::Decode");
+            int bpp = 0;
+            stbi_set_flip_vertically_on_load_thread(1); // 全局版本不是线程安全的
+            image.Pixels = stbi_load(path.c_str(), &image.Width, &image.Height, &bpp, 4);
+            if (!image.Pixels)
+                std::cout << "Warning: failed to load texture '" << path << "': " << stbi_failure_reason() << std::endl;
+        }
+
+        while (!m_Decoded.TryPush(image))
+            std::this_thread::yield();
+    });
+
+    return texture;
+}
+
+void TextureLoader::Update()
+{
+    PROFILE_GPU_SCOPE("TextureLoader::Update");
+    unsigned int uploaded = 0;
+    DecodedImage image;
+    while (uploaded < m_UploadBudget && m_Decoded.TryPop(image))
+    {
+        m_Pending--;
+
+        std::shared_ptr<Texture> texture = image.Target.lock();
+        if (texture && image.InPack)
+        {
+            UploadFromPack(*texture);
+            uploaded += (unsigned int)texture->GetMemorySize();
+        }
+        else if (texture && image.Pixels)
+        {
+            Upload(*texture, image);
+            uploaded += (unsigned int)(image.Width * image.Height * 4);
+        }
+        stbi_image_free(image.Pixels);
+        image = DecodedImage();
+    }
+}
+
+void TextureLoader::Upload(Texture& texture, const DecodedImage& image)
+{
+    unsigned int size = (unsigned int)(image.Width * image.Height * 4);
+    unsigned int pbo = m_PixelBuffers[m_NextPixelBuffer];
+    m_NextPixelBuffer = (m_NextPixelBuffer + 1) % PixelBufferCount;
+
+    // 先孤立PBO旧的存储 (上次的上传可能还没完成), 映射后拷贝, glTexImage2D 从PBO异步读取, 不阻塞CPU
+    GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    GLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+    void* ptr;
+    GLCall(ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    if (ptr)
+    {
+        memcpy(ptr, image.Pixels, size);
+        GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+        texture.SetImage(image.Width, image.Height, nullptr); // 绑定了PBO, nullptr 表示偏移0
+    }
+    else
+    {
+        // 映射失败就直接从内存上传
+        GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        texture.SetImage(image.Width, image.Height, image.Pixels);
+    }
+    // 一定要解绑, 否则之后所有 glTexImage2D 的指针都会被当成PBO偏移
+    GLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    texture.m_IsLoaded = true;
+}
+
+void TextureLoader::UploadFromPack(Texture& texture)
+{
+    // 和 Texture 构造时一样从资源包上传 (包括预压缩格式), 数据已经在映射的内存里, 不需要经过PBO
+    GLState::BindTexture(texture.m_RendererID);
+    if (texture.LoadFromPack(texture.m_FilePath))
+    {
+        texture.ApplyParameters();
+        texture.m_IsLoaded = true;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "LockFreeQueue.h"
+#include "ThreadPool.h"
+#include "Texture.h"
+
+/**
+ * 异步纹理加载:
+ *      Load 立刻返回一个可用的 Texture (1x1 的灰色占位纹理), 图片在工作线程里用 stb_image 解码,
+ *      (挂载了资源包并且包里有这张图时不用解码, 渲染线程 Update 时直接从映射的内存上传),
+ *      解码好的像素通过无锁队列交给渲染线程, Update 时经过 PBO 上传到同一个 Texture 对象里,
+ *      所以拿到的 shared_ptr 一直有效, 加载完成后自动变成真正的图片 (IsLoaded() 变为 true)。
+ *      每帧上传的字节数有上限, 一次加载很多大图也不会卡住一帧。
+ * 所有 GL 相关的函数 (构造/析构/Load/Update) 都必须在渲染线程 (拥有GL上下文的线程) 调用。
+ */
+class TextureLoader
+{
+private:
+	struct DecodedImage
+	{
+		std::weak_ptr<Texture> Target;
+		unsigned char* Pixels = nullptr; // stbi_load 分配, 渲染线程上传后释放
+		int Width = 0, Height = 0;
+		bool InPack = false; // 在资源包里, 没有 Pixels
+	};
+
+	static const unsigned int PixelBufferCount = 4;
+	static const unsigned int QueueCapacity = 256;
+
+	// 队列要比线程池后析构, 工作线程退出前还可能往里写
+	LockFreeQueue<DecodedImage> m_Decoded;
+	ThreadPool m_Workers;
+
+	unsigned int m_PixelBuffers[PixelBufferCount]; // 轮流使用的 GL_PIXEL_UNPACK_BUFFER
+	unsigned int m_NextPixelBuffer;
+	unsigned int m_UploadBudget; // 每帧最多上传的字节数 (至少上传一张)
+	std::atomic<unsigned int> m_Pending; // 已请求但还没上传的图片数
+
+	static TextureLoader* s_Instance;
+
+public:
+	TextureLoader(unsigned int workerCount = 0, unsigned int uploadBudget = 16 * 1024 * 1024);
+	~TextureLoader();
+
+	// main 里创建的那个实例
+	static TextureLoader& Get();
+
+	std::shared_ptr<Texture> Load(const std::string& path);
+	// 每帧调用一次, 把解码好的图片上传到GPU
+	void Update();
+
+	inline unsigned int GetPendingCount() const { return m_Pending.load(); }
+
+private:
+	void Upload(Texture& texture, const DecodedImage& image);
+	void UploadFromPack(Texture& texture);
+};
@@ -0,0 +1,67 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : m_Busy(0), m_Stop(false)
+{
+    if (threadCount == 0)
+    {
+        unsigned int cores = std::thread::hardware_concurrency();
+        threadCount = cores > 1 ? cores - 1 : 1; // 留一个核给渲染线程
+    }
+
+    for (unsigned int i = 0; i < threadCount; i++)
+        m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_JobAvailable.notify_all();
+    for (auto& worker : m_Workers)
+        worker.join();
+}
+
+void ThreadPool::Submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Jobs.push(std::move(job));
+    }
+    m_JobAvailable.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Idle.wait(lock, [this]() { return m_Jobs.empty() && m_Busy == 0; });
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_JobAvailable.wait(lock, [this]() { return m_Stop || !m_Jobs.empty(); });
+            // 析构时先把剩下的任务做完再退出
+            if (m_Stop && m_Jobs.empty())
+                return;
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop();
+            m_Busy++;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Busy--;
+            if (m_Jobs.empty() && m_Busy == 0)
+                m_Idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// 固定数量的工作线程, Submit 进来的任务按顺序被空闲线程取走执行
+class ThreadPool
+{
+private:
+	std::vector<std::thread> m_Workers;
+	std::queue<std::function<void()>> m_Jobs;
+	std::mutex m_Mutex;
+	std::condition_variable m_JobAvailable;
+	std::condition_variable m_Idle;
+	unsigned int m_Busy; // 正在执行任务的线程数
+	bool m_Stop;
+
+public:
+	// threadCount 为 0 时用 (CPU核数 - 1), 至少1个
+	ThreadPool(unsigned int threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void Submit(std::function<void()> job);
+	// 阻塞直到队列为空且所有任务执行完
+	void Wait();
+
+	inline unsigned int GetThreadCount() const { return (unsigned int)m_Workers.size(); }
+
+private:
+	void WorkerLoop();
+};
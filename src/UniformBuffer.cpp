@@ -0,0 +1,34 @@
+#include "UniformBuffer.h"
+
+#include "Render.h"
+#include "GLState.h"
+
+UniformBuffer::UniformBuffer(unsigned int size, unsigned int binding)
+    : m_RendererID(0), m_Size(size), m_Binding(binding)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    GLState::OnBufferDeleted(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void UniformBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+    ASSERT(offset + size <= m_Size);
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    if (offset == 0 && size == m_Size)
+    {
+        GLCall(glBufferData(GL_UNIFORM_BUFFER, m_Size, nullptr, GL_DYNAMIC_DRAW));
+    }
+    GLCall(glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data));
+}
+
+void UniformBuffer::Bind() const
+{
+    GLState::BindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_RendererID);
+}
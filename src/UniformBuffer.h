@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// 相机 uniform block, 和着色器里的 layout(std140) uniform Camera 一一对应
+// std140 下 mat4 就是 4 个 vec4, 没有额外的填充; 以后加成员时要按 std140 的对齐规则补齐
+struct CameraUniforms
+{
+	glm::mat4 ViewProjection;
+};
+
+/**
+ * Uniform 缓冲 (UBO):
+ *      一组 uniform (比如相机的 view-projection 矩阵) 放在一块缓冲里, 绑定到固定的绑定点,
+ *      所有 BindUniformBlock 到这个绑定点的着色器都从当时绑在那里的缓冲读, 切换着色器不用再分别 glUniform。
+ *      相机缓冲不是全局共享的: BatchRenderer2D 和各个 Test 各自持有一块, 每个场景 SetData 一次,
+ *      draw 之前 Bind 到 CameraBinding, 所以同一个绑定点上生效的是最后一次 Bind 的那块。
+ */
+class UniformBuffer
+{
+public:
+	// 各个 uniform block 固定使用的绑定点
+	static const unsigned int CameraBinding = 0;
+
+private:
+	unsigned int m_RendererID;
+	unsigned int m_Size;
+	unsigned int m_Binding;
+
+public:
+	UniformBuffer(unsigned int size, unsigned int binding);
+	~UniformBuffer();
+
+	// 整块更新时先孤立旧的存储, 上一帧还在用它的 draw call 不会让CPU等待
+	void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+	// 绑定到构造时指定的绑定点
+	void Bind() const;
+
+	inline unsigned int GetBinding() const { return m_Binding; }
+	inline unsigned int GetSize() const { return m_Size; }
+};
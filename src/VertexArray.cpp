@@ -1,41 +1,79 @@
 #include "VertexArray.h"
 #include "VertexBufferLayout.h"
 #include "Render.h"
+#include "GLState.h"
 
 VertexArray::VertexArray()
+	: m_AttribCount(0)
 {
 	GLCall(glGenVertexArrays(1, &m_RendererID)); /* 生成顶点数组 */
 }
 
 VertexArray::~VertexArray()
 {
+	GLState::OnVertexArrayDeleted(m_RendererID);
 	GLCall(glDeleteVertexArrays(1, &m_RendererID));
 }
 
 void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
+{
+	AddBuffer(vb, layout.GetView());
+}
+
+void VertexArray::AddBuffer(const DynamicVertexBuffer& vb, const VertexBufferLayout& layout)
+{
+	AddBuffer(vb, layout.GetView());
+}
+
+void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexLayoutView& layout)
 {
 	Bind();
 	vb.Bind();
-	const auto& elements = layout.GetElements();
-	unsigned int offset = 0;
-	for (unsigned int i = 0; i < elements.size(); i++)
+	SetLayout(layout);
+}
+
+void VertexArray::AddBuffer(const DynamicVertexBuffer& vb, const VertexLayoutView& layout)
+{
+	Bind();
+	vb.Bind();
+	SetLayout(layout);
+}
+
+void VertexArray::SetLayout(const VertexLayoutView& layout)
+{
+	for (unsigned int i = 0; i < layout.Count; i++)
 	{
-		const auto& element = elements[i];
+		const VertexBufferElement& element = layout.Elements[i];
+		// 矩阵每一列占一个属性位置, 偏移依次加一列的大小
+		for (unsigned int column = 0; column < element.locations; column++)
+		{
+			unsigned int index = m_AttribCount++;
+			unsigned int offset = element.offset + column * element.GetLocationSize();
 
-		GLCall(glEnableVertexAttribArray(i)); /* 启用指定索引i的常规顶点属性 */
-		// void* 是通用指针，它可以指向任何类型的数据，但你不能直接解引用它，因为编译器不知道它指向的数据是什么类型。需要强转回来才能用
-		GLCall(glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(), (const void*)(uintptr_t)offset));
-		offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+			GLCall(glEnableVertexAttribArray(index)); /* 启用指定索引的常规顶点属性 */
+			// void* 是通用指针，它可以指向任何类型的数据，但你不能直接解引用它，因为编译器不知道它指向的数据是什么类型。需要强转回来才能用
+			if (element.integer) /* 整数属性不转换成 float */
+			{
+				GLCall(glVertexAttribIPointer(index, element.count, element.type, layout.Stride, (const void*)(uintptr_t)offset));
+			}
+			else
+			{
+				GLCall(glVertexAttribPointer(index, element.count, element.type, element.normalized, layout.Stride, (const void*)(uintptr_t)offset));
+			}
+			if (layout.Divisor != 0) /* 逐实例的属性 */
+			{
+				GLCall(glVertexAttribDivisor(index, layout.Divisor));
+			}
+		}
 	}
-
 }
 
 void VertexArray::Bind() const
 {
-	GLCall(glBindVertexArray(m_RendererID));
+	GLState::BindVertexArray(m_RendererID);
 }
 
 void VertexArray::Unbind() const
 {
-	GLCall(glBindVertexArray(0));
+	GLState::BindVertexArray(0);
 }
\ No newline at end of file
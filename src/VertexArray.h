@@ -1,7 +1,8 @@
 #pragma once
 
 #include "VertexBuffer.h"
-// #include "VertexBufferLayout.h"
+#include "DynamicVertexBuffer.h"
+#include "VertexLayout.h"
 
 class VertexBufferLayout;
 
@@ -9,13 +10,32 @@ class VertexArray
 {
 private:
 	unsigned int m_RendererID;
+	unsigned int m_AttribCount; // 已经用掉的属性位置, 下一个 AddBuffer 从这里接着编号
 
 public:
 	VertexArray();
 	~VertexArray();
 
+	// 可以多次调用: 比如先加逐顶点的缓冲, 再加逐实例的缓冲, 属性位置依次往后排
 	void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+	void AddBuffer(const DynamicVertexBuffer& vb, const VertexBufferLayout& layout);
+	void AddBuffer(const VertexBuffer& vb, const VertexLayoutView& layout);
+	void AddBuffer(const DynamicVertexBuffer& vb, const VertexLayoutView& layout);
+
+	// 布局由顶点结构体的 GetLayout() 在编译期给出 (见 VertexBufferLayout.h), 不分配内存
+	template<typename Vertex, typename Buffer>
+	void AddBuffer(const Buffer& vb, unsigned int divisor = 0)
+	{
+		AddBuffer(vb, GetVertexLayout<Vertex>(divisor));
+	}
 
 	void Bind() const;
 	void Unbind() const;
+
+	inline unsigned int GetAttribCount() const { return m_AttribCount; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
+
+private:
+	// 按layout设置当前绑定的 GL_ARRAY_BUFFER 的顶点属性
+	void SetLayout(const VertexLayoutView& layout);
 };
\ No newline at end of file
@@ -1,25 +1,40 @@
 #include "VertexBuffer.h"
 #include "Render.h"
+#include "GLState.h"
 
 
 VertexBuffer::VertexBuffer(const void* data, unsigned int size)
 {
     GLCall(glGenBuffers(1, &m_rendered_id));
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_rendered_id));
+    GLState::BindBuffer(GL_ARRAY_BUFFER, m_rendered_id);
     GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
 }
 
+VertexBuffer::VertexBuffer(unsigned int size)
+{
+    GLCall(glGenBuffers(1, &m_rendered_id));
+    GLState::BindBuffer(GL_ARRAY_BUFFER, m_rendered_id);
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+}
+
 VertexBuffer::~VertexBuffer()
 {
+    GLState::OnBufferDeleted(m_rendered_id);
     GLCall(glDeleteBuffers(1, &m_rendered_id););
 }
 
 void VertexBuffer::Bind() const
 {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_rendered_id));
+    GLState::BindBuffer(GL_ARRAY_BUFFER, m_rendered_id);
 }
 
 void VertexBuffer::UnBind() const
 {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void VertexBuffer::SetData(const void* data, unsigned int size, unsigned int offset)
+{
+    GLState::BindBuffer(GL_ARRAY_BUFFER, m_rendered_id);
+    GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
 }
\ No newline at end of file
@@ -6,8 +6,13 @@ private:
     unsigned int m_rendered_id;
 public:
     VertexBuffer(const void* data, unsigned int size);
+    // 只分配size字节的显存, 不上传数据 (GL_DYNAMIC_DRAW), 之后用SetData每帧更新
+    VertexBuffer(unsigned int size);
     ~VertexBuffer();
 
     void Bind() const;
     void UnBind() const;
-};
\ No newline at end of file
+
+    // 从缓冲区 offset 字节处开始覆盖写入size字节
+    void SetData(const void* data, unsigned int size, unsigned int offset = 0);
+};
@@ -2,7 +2,9 @@
 
 #include <vector>
 #include <GL/glew.h>
+#include <glm/glm.hpp>
 #include "Render.h"
+#include "VertexLayout.h"
 
 // (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
 // glVertexAttribPointer()的参数
@@ -27,69 +29,175 @@
     layout.Push<unsigned char>(4); // 颜色: 4个unsigned char
     m_stride = 24
     这样 OpenGL 就知道：每个顶点大小 24 字节，前 12 字节是位置，接下来 8 字节是纹理坐标，最后 4 字节是颜色。
- **/
 
-struct VertexBufferElement
-{
-	unsigned int type; // 
-	unsigned int count;
-	unsigned char normalized;
+    实例化渲染时, 每个实例一份的数据放在另一个缓冲里, 构造时传 divisor:
+    VertexBufferLayout instanceLayout(1); // 每画完 1 个实例前进一格
+    instanceLayout.Push<glm::mat4>(1);    // 模型矩阵: 占 4 个连续的属性位置, 每个是一列 vec4
+    instanceLayout.Push<float>(4);        // 颜色
 
-	static unsigned int GetSizeOfType(unsigned int type)
-	{
-		switch (type)
-		{
-            case GL_FLOAT: return 4;
-            case GL_UNSIGNED_INT: return 4;
-            case GL_UNSIGNED_BYTE: return 1;
-		}
-		ASSERT(false);
-		return 0;
-	}
-};
+    压缩格式 (见 VertexFormats.h), 同样的顶点可以小很多:
+    layout.Push<float>(3);        // 位置
+    layout.Push<Unorm16x2>(1);    // 纹理坐标: 2 个 16 位归一化整数, 4 字节
+    layout.Push<Unorm8x4>(1);     // 颜色: 4 字节
+    layout.PushInteger<unsigned int>(1); // 着色器里是 uint/int 的属性, 不转换成 float (glVertexAttribIPointer)
+    别的组合直接写 GL 类型: layout.Push(GL_SHORT, 2, true);
+
+    上面都是运行时一个个 Push 出来的 (要分配内存)。顶点本来就是一个结构体的话, 用 VertexLayout.h 里编译期的布局更好。
+ **/
 
 class VertexBufferLayout
 {
 private:
 	std::vector<VertexBufferElement> m_Elements;
 	unsigned int m_Stride;
+	unsigned int m_Divisor;
 public:
-	VertexBufferLayout(): m_Stride(0) {}
+	// divisor 为 0 是普通的逐顶点数据, 大于 0 时这个缓冲里的所有属性都是逐实例的
+	VertexBufferLayout(unsigned int divisor = 0): m_Stride(0), m_Divisor(divisor) {}
 
     // 模板声明
-    // 但这里故意写了 static_assert(false)，意思是：
+    // 这里故意写了 static_assert，意思是：
     // 如果用户用未定义的类型调用 Push，比如 Push<double>()，直接编译报错！
+    // (条件要依赖 T, 写成 static_assert(false) 的话有的编译器在模板定义时就会报错)
 	template<typename T>
 	void Push(unsigned int count) 
     // 向 m_Elements 添加一个元素，类型是 GL_FLOAT，数量是 count，比如 Push<float>(3) 就表示顶点的某一部分有 3 个 float（比如位置 x,y,z）。
     // 更新 m_Stride，把这部分占的字节数加上。
 	{
-		static_assert(false);
+		static_assert(sizeof(T) == 0, "unsupported vertex attribute type");
 	}
 
-    // 模板特化
-    // 有时候，你想 针对某个具体类型，写不同的实现。就会走 特化版本，而不是普通版本。
-	template<>
-	void Push<float>(unsigned int count)
+	// 直接给 GL 类型, 着色器里读到的是 float (normalized 时整数映射到 [0,1] 或 [-1,1])
+	// 打包类型 (GL_INT_2_10_10_10_REV 等) 的 count 必须是 4
+	void Push(unsigned int type, unsigned int count, bool normalized)
 	{
-		m_Elements.push_back({ GL_FLOAT, count, GL_FALSE });
-		m_Stride += VertexBufferElement::GetSizeOfType(GL_FLOAT) * count;
+		ASSERT(VertexBufferElement::GetSizeOfType(type) != 0);
+		ASSERT(!VertexBufferElement::IsPackedType(type) || count == 4);
+		m_Elements.push_back({ type, count, (unsigned char)(normalized ? GL_TRUE : GL_FALSE), false, m_Stride, 1 });
+		m_Stride += m_Elements.back().GetSize();
 	}
 
-	template<>
-	void Push<unsigned int>(unsigned int count)
+	// 整数属性: 着色器里声明成 int/uint/ivecN/uvecN, 值原样传过去
+	template<typename T>
+	void PushInteger(unsigned int count)
 	{
-		m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
-		m_Stride += VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT) * count;
+		static_assert(sizeof(T) == 0, "unsupported integer vertex attribute type");
 	}
 
-	template<>
-	void Push<unsigned char>(unsigned int count)
+	inline const std::vector<VertexBufferElement>& GetElements() const { return m_Elements; }
+	inline unsigned int GetStride() const { return m_Stride; }
+	inline unsigned int GetDivisor() const { return m_Divisor; }
+	inline VertexLayoutView GetView() const { return { m_Elements.data(), (unsigned int)m_Elements.size(), m_Stride, m_Divisor }; }
+
+private:
+	void PushInteger(unsigned int type, unsigned int count)
 	{
-		m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
-		m_Stride += VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE) * count;
+		ASSERT(VertexBufferElement::GetSizeOfType(type) != 0);
+		m_Elements.push_back({ type, count, GL_FALSE, true, m_Stride, 1 });
+		m_Stride += m_Elements.back().GetSize();
 	}
+};
 
-	inline const std::vector<VertexBufferElement> GetElements() const { return m_Elements; }
-	inline unsigned int GetStride() const { return m_Stride; }
-};
\ No newline at end of file
+// 模板特化
+// 有时候，你想 针对某个具体类型，写不同的实现。就会走 特化版本，而不是普通版本。
+// 显式特化要写在类外面 (命名空间作用域), 类内的写法只有 MSVC 接受
+template<>
+inline void VertexBufferLayout::Push<float>(unsigned int count)
+{
+	Push(GL_FLOAT, count, false);
+}
+
+// 整数类型按 float 读: unsigned int 保持原来的值, 其余的归一化
+template<>
+inline void VertexBufferLayout::Push<unsigned int>(unsigned int count)
+{
+	Push(GL_UNSIGNED_INT, count, false);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned char>(unsigned int count)
+{
+	Push(GL_UNSIGNED_BYTE, count, true);
+}
+
+template<>
+inline void VertexBufferLayout::Push<short>(unsigned int count)
+{
+	Push(GL_SHORT, count, true);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned short>(unsigned int count)
+{
+	Push(GL_UNSIGNED_SHORT, count, true);
+}
+
+// VertexFormats.h 里的压缩格式, count 是有几个这样的值
+template<>
+inline void VertexBufferLayout::Push<Half>(unsigned int count)
+{
+	Push(GL_HALF_FLOAT, count, false);
+}
+
+// 4 个分量已经占满一个属性, 每个 Unorm8x4 一个属性位置
+template<>
+inline void VertexBufferLayout::Push<Unorm8x4>(unsigned int count)
+{
+	for (unsigned int i = 0; i < count; i++)
+		Push(GL_UNSIGNED_BYTE, 4, true);
+}
+
+template<>
+inline void VertexBufferLayout::Push<Unorm16x2>(unsigned int count)
+{
+	Push(GL_UNSIGNED_SHORT, 2 * count, true);
+}
+
+// 每个 Snorm1010102 单独占一个属性位置 (一个打包的属性只能有 4 个分量)
+template<>
+inline void VertexBufferLayout::Push<Snorm1010102>(unsigned int count)
+{
+	for (unsigned int i = 0; i < count; i++)
+		Push(GL_INT_2_10_10_10_REV, 4, true);
+}
+
+// 矩阵属性: 一个 mat4 在着色器里占 4 个属性位置, 按列拆成 4 个 vec4
+template<>
+inline void VertexBufferLayout::Push<glm::mat4>(unsigned int count)
+{
+	for (unsigned int i = 0; i < count; i++)
+	{
+		m_Elements.push_back({ GL_FLOAT, 4, GL_FALSE, false, m_Stride, 4 });
+		m_Stride += m_Elements.back().GetSize();
+	}
+}
+
+template<>
+inline void VertexBufferLayout::PushInteger<int>(unsigned int count)
+{
+	PushInteger(GL_INT, count);
+}
+
+template<>
+inline void VertexBufferLayout::PushInteger<unsigned int>(unsigned int count)
+{
+	PushInteger(GL_UNSIGNED_INT, count);
+}
+
+template<>
+inline void VertexBufferLayout::PushInteger<short>(unsigned int count)
+{
+	PushInteger(GL_SHORT, count);
+}
+
+template<>
+inline void VertexBufferLayout::PushInteger<unsigned short>(unsigned int count)
+{
+	PushInteger(GL_UNSIGNED_SHORT, count);
+}
+
+template<>
+inline void VertexBufferLayout::PushInteger<unsigned char>(unsigned int count)
+{
+	PushInteger(GL_UNSIGNED_BYTE, count);
+}
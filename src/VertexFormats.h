@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <glm/glm.hpp>
+
+/**
+ * 压缩的顶点分量格式:
+ *      顶点数据每帧都要上传的话, 顶点越小带宽越省。这些类型在 CPU 端就是打包好的整数,
+ *      用 VertexBufferLayout::Push<类型> 描述, GPU 读取时自动解包成 float, 着色器不用改。
+ *      Unorm8x4     颜色, 4 个 8 位 [0,1]                 (4 字节, 原来 16)
+ *      Unorm16x2    [0,1] 范围的纹理坐标, 精度 1/65535    (4 字节, 原来 8)
+ *      Half         半精度浮点, 11 位有效数字, 适合范围小的数据 (比如模型空间的坐标)
+ *      Snorm1010102 法线/切线, xyz 各 10 位 [-1,1], w 2 位 (4 字节, 原来 16)
+ *      打包时超出范围的值会被截断到范围内。
+ */
+namespace VertexFormats
+{
+	// 转换都是 截断 -> 缩放 -> 加 0.5 截尾, SpriteKernels 的 SIMD 版本做的是同样的运算
+	inline uint32_t PackUnorm(float value, float scale)
+	{
+		value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+		return (uint32_t)(value * scale + 0.5f);
+	}
+
+	inline int32_t PackSnorm(float value, float scale)
+	{
+		value = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+		return (int32_t)std::floor(value * scale + 0.5f);
+	}
+
+	// float -> half, 向最近的偶数舍入, 太大的数变成无穷, 太小的变成非规格化数或 0
+	inline uint16_t FloatToHalf(float value)
+	{
+		uint32_t f;
+		std::memcpy(&f, &value, sizeof(f));
+		uint32_t sign = (f >> 16) & 0x8000;
+		f &= 0x7FFFFFFF;
+
+		uint32_t h;
+		if (f >= 0x7F800000) // inf / nan
+			h = f > 0x7F800000 ? 0x7E00 : 0x7C00;
+		else if (f >= 0x477FF000) // 舍入后超过 65504
+			h = 0x7C00;
+		else if (f < 0x38800000) // 比最小的规格化 half 还小: 借 float 的加法做非规格化的舍入
+		{
+			float magic;
+			uint32_t magicBits = 126u << 23; // 0.5f
+			std::memcpy(&magic, &magicBits, sizeof(magic));
+			float abs;
+			std::memcpy(&abs, &f, sizeof(abs));
+			abs += magic;
+			std::memcpy(&h, &abs, sizeof(h));
+			h -= magicBits;
+		}
+		else
+		{
+			uint32_t mantissaOdd = (f >> 13) & 1;
+			f += ((uint32_t)(15 - 127) << 23) + 0xFFF + mantissaOdd;
+			h = f >> 13;
+		}
+		return (uint16_t)(sign | h);
+	}
+
+	inline float HalfToFloat(uint16_t value)
+	{
+		uint32_t exponent = (value >> 10) & 0x1F;
+		uint32_t mantissa = value & 0x3FF;
+
+		float result;
+		if (exponent == 0) // 0 或非规格化数
+			result = (float)mantissa * (1.0f / 16777216.0f); // 2^-24
+		else
+		{
+			uint32_t bits = exponent == 31 ? (0x7F800000 | (mantissa << 13)) : (((exponent + 127 - 15) << 23) | (mantissa << 13));
+			std::memcpy(&result, &bits, sizeof(result));
+		}
+		return (value & 0x8000) ? -result : result;
+	}
+}
+
+struct Unorm8x4
+{
+	uint32_t Bits; // 小端: 第 0 个字节是 x
+
+	static inline Unorm8x4 Pack(const glm::vec4& value)
+	{
+		using namespace VertexFormats;
+		return { PackUnorm(value.x, 255.0f) | (PackUnorm(value.y, 255.0f) << 8)
+			| (PackUnorm(value.z, 255.0f) << 16) | (PackUnorm(value.w, 255.0f) << 24) };
+	}
+
+	inline glm::vec4 Unpack() const
+	{
+		return glm::vec4((float)(Bits & 0xFF), (float)((Bits >> 8) & 0xFF), (float)((Bits >> 16) & 0xFF), (float)(Bits >> 24)) * (1.0f / 255.0f);
+	}
+};
+
+struct Unorm16x2
+{
+	uint32_t Bits; // 低 16 位是 x
+
+	static inline Unorm16x2 Pack(const glm::vec2& value)
+	{
+		using namespace VertexFormats;
+		return { PackUnorm(value.x, 65535.0f) | (PackUnorm(value.y, 65535.0f) << 16) };
+	}
+
+	inline glm::vec2 Unpack() const
+	{
+		return glm::vec2((float)(Bits & 0xFFFF), (float)(Bits >> 16)) * (1.0f / 65535.0f);
+	}
+};
+
+struct Half
+{
+	uint16_t Bits;
+
+	static inline Half Pack(float value) { return { VertexFormats::FloatToHalf(value) }; }
+	inline float Unpack() const { return VertexFormats::HalfToFloat(Bits); }
+};
+
+// 对应 GL_INT_2_10_10_10_REV: 从低位开始依次是 x, y, z (各 10 位), w (2 位), 都是有符号的
+struct Snorm1010102
+{
+	uint32_t Bits;
+
+	static inline Snorm1010102 Pack(const glm::vec4& value)
+	{
+		using namespace VertexFormats;
+		return { ((uint32_t)PackSnorm(value.x, 511.0f) & 0x3FF) | (((uint32_t)PackSnorm(value.y, 511.0f) & 0x3FF) << 10)
+			| (((uint32_t)PackSnorm(value.z, 511.0f) & 0x3FF) << 20) | (((uint32_t)PackSnorm(value.w, 1.0f) & 0x3) << 30) };
+	}
+};
+
+static_assert(sizeof(Unorm8x4) == 4 && sizeof(Unorm16x2) == 4 && sizeof(Half) == 2 && sizeof(Snorm1010102) == 4,
+	"packed vertex formats must not have padding");
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "VertexFormats.h"
+
+/**
+    顶点属性的描述, VertexBufferLayout (运行时) 和顶点结构体的编译期布局共用。
+    这个头文件不依赖 Render.h, VertexArray.h 可以直接包含它。
+
+    VertexBufferLayout 是运行时一个个 Push 出来的 (要分配内存)。顶点本来就是一个结构体的话,
+    可以让结构体自己描述布局, 偏移用 offsetof 取, 整个布局在编译期就算好了, 不会和结构体对不上:
+    struct Vertex {
+        glm::vec3 Position;
+        Unorm8x4 Color;
+        static constexpr auto GetLayout()
+        {
+            return std::array{ VERTEX_ATTRIBUTE(Vertex, Position), VERTEX_ATTRIBUTE(Vertex, Color) };
+        }
+    };
+    vao.AddBuffer<Vertex>(vb);          // 不分配内存
+    vao.AddBuffer<InstanceData>(ib, 1); // 逐实例的缓冲
+    成员类型到属性格式的对应见下面的 VertexAttributeFormat, 整数成员 (uint32_t 等) 按整数属性传给着色器。
+ **/
+
+struct VertexBufferElement
+{
+	unsigned int type; // 
+	unsigned int count;
+	unsigned char normalized;
+	bool integer;           // 着色器里是整数属性, 用 glVertexAttribIPointer, normalized 无效
+	unsigned int offset;    // 在顶点里的字节偏移
+	unsigned int locations; // 占几个属性位置: 矩阵每一列一个, 每列都是 count 个分量
+
+	static constexpr unsigned int GetSizeOfType(unsigned int type)
+	{
+		switch (type)
+		{
+            case GL_FLOAT: return 4;
+            case GL_HALF_FLOAT: return 2;
+            case GL_INT: return 4;
+            case GL_UNSIGNED_INT: return 4;
+            case GL_SHORT: return 2;
+            case GL_UNSIGNED_SHORT: return 2;
+            case GL_BYTE: return 1;
+            case GL_UNSIGNED_BYTE: return 1;
+            // 打包格式: 4 个分量一共 4 字节
+            case GL_INT_2_10_10_10_REV: return 4;
+            case GL_UNSIGNED_INT_2_10_10_10_REV: return 4;
+		}
+		return 0; // 不支持的类型, VertexBufferLayout::Push 会断言, 编译期布局会 static_assert
+	}
+
+	static constexpr bool IsPackedType(unsigned int type)
+	{
+		return type == GL_INT_2_10_10_10_REV || type == GL_UNSIGNED_INT_2_10_10_10_REV;
+	}
+
+	// 一个属性位置 (矩阵的一列) 占的字节数
+	constexpr unsigned int GetLocationSize() const
+	{
+		return IsPackedType(type) ? GetSizeOfType(type) : count * GetSizeOfType(type);
+	}
+
+	// 这个属性在顶点里占的字节数
+	constexpr unsigned int GetSize() const
+	{
+		return locations * GetLocationSize();
+	}
+};
+
+// 一组属性 + 步长, 不拥有内存: VertexBufferLayout 和结构体的编译期布局都转成它交给 VertexArray
+struct VertexLayoutView
+{
+	const VertexBufferElement* Elements;
+	unsigned int Count;
+	unsigned int Stride;
+	unsigned int Divisor; // 0: 每个顶点一份; n: 每 n 个实例一份 (glVertexAttribDivisor)
+};
+
+// ---------------- 编译期布局 ----------------
+
+// 顶点结构体的成员类型对应的属性格式, 没有特化的类型编译报错
+template<typename T>
+struct VertexAttributeFormat
+{
+	static_assert(sizeof(T) == 0, "unsupported vertex member type");
+};
+
+template<unsigned int Type, unsigned int Count, bool Normalized, bool Integer, unsigned int Locations = 1>
+struct VertexAttributeFormatOf
+{
+	static constexpr unsigned int type = Type;
+	static constexpr unsigned int count = Count;
+	static constexpr bool normalized = Normalized;
+	static constexpr bool integer = Integer;
+	static constexpr unsigned int locations = Locations;
+};
+
+template<> struct VertexAttributeFormat<float> : VertexAttributeFormatOf<GL_FLOAT, 1, false, false> {};
+template<> struct VertexAttributeFormat<glm::vec2> : VertexAttributeFormatOf<GL_FLOAT, 2, false, false> {};
+template<> struct VertexAttributeFormat<glm::vec3> : VertexAttributeFormatOf<GL_FLOAT, 3, false, false> {};
+template<> struct VertexAttributeFormat<glm::vec4> : VertexAttributeFormatOf<GL_FLOAT, 4, false, false> {};
+template<> struct VertexAttributeFormat<glm::mat4> : VertexAttributeFormatOf<GL_FLOAT, 4, false, false, 4> {};
+template<> struct VertexAttributeFormat<Half> : VertexAttributeFormatOf<GL_HALF_FLOAT, 1, false, false> {};
+template<> struct VertexAttributeFormat<Unorm8x4> : VertexAttributeFormatOf<GL_UNSIGNED_BYTE, 4, true, false> {};
+template<> struct VertexAttributeFormat<Unorm16x2> : VertexAttributeFormatOf<GL_UNSIGNED_SHORT, 2, true, false> {};
+template<> struct VertexAttributeFormat<Snorm1010102> : VertexAttributeFormatOf<GL_INT_2_10_10_10_REV, 4, true, false> {};
+// 整数成员按整数属性传, 想要归一化的 float 就用上面的压缩格式
+template<> struct VertexAttributeFormat<int32_t> : VertexAttributeFormatOf<GL_INT, 1, false, true> {};
+template<> struct VertexAttributeFormat<uint32_t> : VertexAttributeFormatOf<GL_UNSIGNED_INT, 1, false, true> {};
+template<> struct VertexAttributeFormat<int16_t> : VertexAttributeFormatOf<GL_SHORT, 1, false, true> {};
+template<> struct VertexAttributeFormat<uint16_t> : VertexAttributeFormatOf<GL_UNSIGNED_SHORT, 1, false, true> {};
+template<> struct VertexAttributeFormat<uint8_t> : VertexAttributeFormatOf<GL_UNSIGNED_BYTE, 1, false, true> {};
+
+// 数组成员是一个多分量的属性, 比如 Half TexCoord[2]
+template<typename T, size_t N>
+struct VertexAttributeFormat<T[N]> : VertexAttributeFormatOf<VertexAttributeFormat<T>::type, VertexAttributeFormat<T>::count * (unsigned int)N,
+	VertexAttributeFormat<T>::normalized, VertexAttributeFormat<T>::integer>
+{
+	static_assert(VertexAttributeFormat<T>::locations == 1 && !VertexBufferElement::IsPackedType(VertexAttributeFormat<T>::type)
+		&& VertexAttributeFormat<T>::count * N <= 4, "array vertex members must fit in one attribute of up to 4 components");
+};
+
+template<typename T>
+constexpr VertexBufferElement MakeVertexAttribute(unsigned int offset)
+{
+	using Format = VertexAttributeFormat<T>;
+	return { Format::type, Format::count, (unsigned char)(Format::normalized ? GL_TRUE : GL_FALSE), Format::integer, offset, Format::locations };
+}
+
+// 结构体的一个成员, 用在结构体的 GetLayout() 里 (函数体里结构体已经完整, 可以用 offsetof)
+#define VERTEX_ATTRIBUTE(Vertex, Member) MakeVertexAttribute<decltype(Vertex::Member)>((unsigned int)offsetof(Vertex, Member))
+
+// 每个顶点类型一份, 编译期算好放在只读数据里
+template<typename Vertex>
+struct VertexLayoutStorage
+{
+	static constexpr auto Elements = Vertex::GetLayout();
+};
+
+// 属性按偏移从小到大排列, 互不重叠, 也不超出结构体
+template<typename Vertex>
+constexpr bool IsValidVertexLayout()
+{
+	unsigned int end = 0;
+	for (const VertexBufferElement& element : VertexLayoutStorage<Vertex>::Elements)
+	{
+		if (element.offset < end || element.GetLocationSize() == 0)
+			return false;
+		end = element.offset + element.GetSize();
+	}
+	return end <= sizeof(Vertex);
+}
+
+template<typename Vertex>
+constexpr VertexLayoutView GetVertexLayout(unsigned int divisor = 0)
+{
+	static_assert(IsValidVertexLayout<Vertex>(), "vertex attributes overlap or exceed the vertex struct");
+	return { VertexLayoutStorage<Vertex>::Elements.data(), (unsigned int)VertexLayoutStorage<Vertex>::Elements.size(), (unsigned int)sizeof(Vertex), divisor };
+}
@@ -19,4 +19,22 @@ namespace test
 			}
 		}
 	}
+
+	Test* TestMenu::CreateTest(const std::string& name) const
+	{
+		for (auto &test : m_Tests)
+		{
+			if (test.first == name)
+				return test.second();
+		}
+		return nullptr;
+	}
+
+	std::vector<std::string> TestMenu::GetTestNames() const
+	{
+		std::vector<std::string> names;
+		for (auto &test : m_Tests)
+			names.push_back(test.first);
+		return names;
+	}
 }
@@ -17,6 +17,10 @@ namespace test
 			virtual ~Test() {}
 
 			virtual void OnUpdate(float deltaTime) {}
+			// 固定步长模式下代替 OnUpdate, 每次前进 fixedDeltaTime 秒; 可能在模拟线程里调用, 不能调用GL/ImGui
+			virtual void OnFixedUpdate(float fixedDeltaTime) { OnUpdate(fixedDeltaTime); }
+			// 固定步长模式下渲染前调用, alpha (0~1) 是当前时刻在上一步和最新一步之间的位置, 用来插值出渲染用的状态
+			virtual void OnInterpolate(float alpha) {}
 			virtual void OnRender() {}
 			virtual void OnImGuiRender() {}
 	};
@@ -37,6 +41,10 @@ namespace test
 			TestMenu(Test*& currentTestPtr);
 			void OnImGuiRender() override;
 
+			// 按注册时的名字创建 Test (命令行 --test 用), 没有这个名字时返回 nullptr
+			Test* CreateTest(const std::string& name) const;
+			std::vector<std::string> GetTestNames() const;
+
 			// 模板函数 vs 普通函数
 			// 普通函数在编译时就确定了函数体，编译器可以在 .cpp 里编译好。
 			// 模板函数直到实例化（用某个具体类型替换 T）时才真正生成代码。
@@ -44,7 +52,8 @@ namespace test
 			template<typename T>
 			void RegisterTest(const std::string& name)
 			{
-				std::cout << "Register test: " << name << std::endl;
+				// 日志写到 stderr: stdout 留给 --list-tests 这类要被脚本读取的输出
+				std::clog << "Register test: " << name << std::endl;
 
 				// 是一个无捕获的 lambda，无参数，调用时在堆上 new 出一个 T 的实例并返回其指针（类型为 T*）。
 				// [capture list] (parm list) -> return type {body};
@@ -0,0 +1,68 @@
+#include "TestAsyncTexture.h"
+
+#include "Render.h"
+#include "GLState.h"
+#include "TextureLoader.h"
+#include "vendor/imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test
+{
+	TestAsyncTexture::TestAsyncTexture()
+        :m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)), m_TextureCount(32)
+	{
+        GLState::SetBlend(true);
+        GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_Renderer = std::make_unique<BatchRenderer2D>();
+        RequestTextures();
+	}
+
+	TestAsyncTexture::~TestAsyncTexture()
+	{
+	}
+
+	void TestAsyncTexture::RequestTextures()
+	{
+        // 同一个文件也会被解码多次, 这里只是为了制造加载压力
+        m_Textures.clear();
+        const char* paths[] = { "res/logo.png", "res/profile.jpg" };
+        for (int i = 0; i < m_TextureCount; i++)
+            m_Textures.push_back(TextureLoader::Get().Load(paths[i % 2]));
+	}
+
+	void TestAsyncTexture::OnUpdate(float deltaTime)
+	{
+	}
+
+	void TestAsyncTexture::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        m_Renderer->BeginScene(m_Proj);
+        int columns = 8;
+        float cell = 960.0f / columns;
+        for (size_t i = 0; i < m_Textures.size(); i++)
+        {
+            glm::vec2 position((i % columns) * cell, 540.0f - (i / columns + 1) * cell);
+            m_Renderer->DrawQuad(position, glm::vec2(cell * 0.9f), *m_Textures[i]);
+        }
+        m_Renderer->EndScene();
+	}
+
+	void TestAsyncTexture::OnImGuiRender()
+	{
+        unsigned int loaded = 0;
+        for (auto& texture : m_Textures)
+            loaded += texture->IsLoaded() ? 1 : 0;
+
+        ImGui::SliderInt("Texture Count", &m_TextureCount, 1, 64);
+        if (ImGui::Button("Reload"))
+            RequestTextures();
+        ImGui::Text("Loaded: %u / %u (pending in loader: %u)", loaded, (unsigned int)m_Textures.size(), TextureLoader::Get().GetPendingCount());
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
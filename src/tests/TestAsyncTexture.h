@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Test.h"
+
+#include "BatchRenderer2D.h"
+#include "Texture.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	// 通过 TextureLoader 异步加载一批纹理, 加载过程中先显示占位纹理, 帧循环不会卡住
+	class TestAsyncTexture : public Test
+	{
+	private:
+		std::unique_ptr<BatchRenderer2D> m_Renderer;
+		std::vector<std::shared_ptr<Texture>> m_Textures;
+
+		glm::mat4 m_Proj;
+		int m_TextureCount;
+
+	public:
+		TestAsyncTexture();
+		~TestAsyncTexture();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void RequestTextures();
+	};
+}
@@ -1,6 +1,7 @@
 #include "TestBatchRender.h"
 
 #include "Render.h"
+#include "GLState.h"
 #include "vendor/imgui/imgui.h"
 
 #include "glm/glm.hpp"
@@ -9,58 +10,24 @@
 namespace test
 {
 	TestBatchRender::TestBatchRender()
-        :m_Proj(glm::ortho(0.0f, 640.0f, 0.0f, 480.0f, -1.0f, 1.0f)),
-        m_View(glm::translate(glm::mat4(1.0f), glm::vec3(-100, 0, 0))),
-        m_Translation(glm::vec3(0, 0, 0))
+        :m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_View(glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, 0))),
+        m_Translation(glm::vec3(0, 0, 0)), m_GridSize(100)
 	{
-        float positions[] = {
-            100.0f, 100.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f,
-            200.0f, 100.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f,
-            200.0f, 200.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f,
-            100.0f, 200.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+        GLState::SetBlend(true);
+        GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-            300.0f, 100.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f,
-            400.0f, 100.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f,
-            400.0f, 200.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-            300.0f, 200.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f,
+        m_Renderer = std::make_unique<BatchRenderer2D>();
 
-        };
-
-        unsigned int indices[] = {
-            0, 1, 2, 2, 3, 0,
-            4, 5, 6, 6, 7, 4
-        };
-
-        GLCall(glEnable(GL_BLEND));
-        GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
-
-        m_VAO = std::make_unique<VertexArray>();
-
-        m_VertexBuffer = std::make_unique<VertexBuffer>(positions, 11 * 8 * sizeof(float));
-        VertexBufferLayout layout;
-        layout.Push<float>(4); // 
-        layout.Push<float>(4); //
-        layout.Push<float>(2); // 
-        layout.Push<float>(1); //
-        m_VAO->AddBuffer(*m_VertexBuffer, layout);
-
-        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 12);
-
-        m_Shader = std::make_unique<Shader>("res/shaders/Batch.shader");
-        m_Shader->Bind();
-
-        m_Texture[0] = std::make_unique<Texture>("res/textures/ChernoLogo.png");
-        m_Texture[1] = std::make_unique<Texture>("res/textures/HazelLogo.png");
-        for (size_t i = 0; i < 2; i++)
-        {
-            m_Texture[i]->Bind(i);
-        }
-        int samplers[2] = { 0, 1 };
-        m_Shader->SetUniform1iv("u_Textures", 2, samplers);
+        // 和其它 Test 共用同一份纹理, 切换回来时直接命中缓存
+        m_Texture[0] = ResourceManager::Get().LoadTexture("res/logo.png");
+        m_Texture[1] = ResourceManager::Get().LoadTexture("res/profile.jpg");
 	}
 
 	TestBatchRender::~TestBatchRender()
 	{
+        ResourceManager::Get().Release(m_Texture[0]);
+        ResourceManager::Get().Release(m_Texture[1]);
 	}
 
 	void TestBatchRender::OnUpdate(float deltaTime)
@@ -72,17 +39,42 @@ namespace test
 		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
 		GLCall(glClear(GL_COLOR_BUFFER_BIT));
 
-        Renderer renderer; // ÿ֡���renderer��Ҫ��һ����
-        glm::mat4 mvp = m_Proj * m_View;
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), m_Translation);
+        glm::mat4 mvp = m_Proj * m_View * model;
+
+        const Texture* textures[2] = { ResourceManager::Get().GetTexture(m_Texture[0]), ResourceManager::Get().GetTexture(m_Texture[1]) };
 
-        m_Shader->Bind();
-        m_Shader->SetUniformMat4f("u_MVP", mvp);
+        m_Renderer->ResetStats();
+        m_Renderer->BeginScene(mvp);
+
+        // 纯色背景格子 + 交替的两张纹理, 一整帧只需要很少的 draw call
+        float cell = 960.0f / (float)m_GridSize;
+        for (int y = 0; y < m_GridSize; y++)
+        {
+            for (int x = 0; x < m_GridSize; x++)
+            {
+                glm::vec2 position(x * cell, y * cell);
+                glm::vec4 color((float)x / m_GridSize, 0.4f, (float)y / m_GridSize, 1.0f);
+                if ((x + y) % 3 == 0)
+                    m_Renderer->DrawQuad(position, glm::vec2(cell * 0.9f), *textures[(x + y) % 2], color);
+                else
+                    m_Renderer->DrawQuad(position, glm::vec2(cell * 0.9f), color);
+            }
+        }
 
-        renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader);
+        m_Renderer->EndScene();
+        m_LastStats = m_Renderer->GetStats();
 	}
 
 	void TestBatchRender::OnImGuiRender()
 	{
-         ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+        ImGui::SliderFloat3("m_Translation", &m_Translation.x, -960.0f, 960.0f);
+        ImGui::SliderInt("Grid Size", &m_GridSize, 1, 400);
+        ImGui::Text("Draw Calls: %u", m_LastStats.DrawCalls);
+        ImGui::Text("Quads: %u", m_LastStats.QuadCount);
+        ImGui::Text("Vertex Upload: %u bytes/vertex, %.1f KB/frame", (unsigned int)sizeof(QuadVertex),
+            m_LastStats.GetVertexCount() * sizeof(QuadVertex) / 1024.0f);
+        ImGui::Text("State Changes: %u issued, %u skipped", GLState::GetStats().Issued, GLState::GetStats().Skipped);
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
 	}
-}
\ No newline at end of file
+}
@@ -2,26 +2,24 @@
 
 #include "Test.h"
 
-#include "VertexBuffer.h"
-#include "VertexBufferLayout.h"
-#include "Texture.h"
+#include "BatchRenderer2D.h"
+#include "ResourceManager.h"
 
 #include <memory>
 
 namespace test
 {
-
+	// 用 BatchRenderer2D 画大量quad, 看 draw call 数能降到多少
 	class TestBatchRender : public Test
 	{
 	private:
-		std::unique_ptr<VertexArray> m_VAO;
-		std::unique_ptr<IndexBuffer> m_IndexBuffer;
-		std::unique_ptr<VertexBuffer> m_VertexBuffer;
-		std::unique_ptr<Shader> m_Shader;
-		std::unique_ptr<Texture> m_Texture[2];
+		std::unique_ptr<BatchRenderer2D> m_Renderer;
+		TextureHandle m_Texture[2];
 
 		glm::mat4 m_Proj, m_View;
 		glm::vec3 m_Translation;
+		int m_GridSize; // 画 m_GridSize * m_GridSize 个quad
+		BatchRenderer2D::Statistics m_LastStats;
 
 	public:
 		TestBatchRender();
@@ -31,4 +29,4 @@ namespace test
 		void OnRender() override;
 		void OnImGuiRender() override;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,255 @@
+#include "TestCulling.h"
+
+#include "Render.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "vendor/imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace test
+{
+	TestCulling::TestCulling()
+        :m_Grid(512.0f), m_CameraPosition(WorldSize * 0.5f), m_Zoom(1.0f), m_Time(0.0f), m_SpriteCount(200000), m_MovingRatio(0.1f),
+        m_Culling(true), m_AutoPan(true), m_DebugView(false), m_StreamStatic(false),
+        m_Submitted(0), m_StreamedQuads(0), m_StreamedDrawCalls(0), m_QueryTime(0.0f), m_RenderTime(0.0f)
+	{
+        GLState::SetBlend(true);
+        GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_Renderer = std::make_unique<BatchRenderer2D>();
+
+        m_StaticIndices = std::make_unique<DynamicIndexBuffer>(MaxStreamedQuads * 6);
+        m_StaticShader = ResourceManager::Get().LoadShader("res/shaders/Geometry.shader");
+        ResourceManager::Get().GetShader(m_StaticShader)->BindUniformBlock("Camera", UniformBuffer::CameraBinding);
+        m_CameraBuffer = std::make_unique<UniformBuffer>((unsigned int)sizeof(CameraUniforms), UniformBuffer::CameraBinding);
+        m_IndexScratch.reserve(MaxStreamedQuads * 6);
+
+        GenerateWorld();
+	}
+
+	TestCulling::~TestCulling()
+	{
+        ResourceManager::Get().Release(m_StaticShader);
+	}
+
+	void TestCulling::GenerateWorld()
+	{
+        PROFILE_FUNCTION();
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        m_Grid.Clear();
+        m_Sprites.resize(m_SpriteCount);
+        std::vector<StaticVertex> staticVertices;
+        for (size_t i = 0; i < m_Sprites.size(); i++)
+        {
+            WorldSprite& sprite = m_Sprites[i];
+            sprite.Size = glm::vec2(8.0f + unit(random) * 40.0f);
+            sprite.Position = glm::vec2(unit(random), unit(random)) * (WorldSize - sprite.Size.x);
+            sprite.Color = glm::vec4(0.3f + 0.7f * unit(random), 0.3f + 0.7f * unit(random), 0.3f + 0.7f * unit(random), 1.0f);
+            float angle = unit(random) * 6.2831853f;
+            sprite.Velocity = unit(random) < m_MovingRatio ? glm::vec2(std::cos(angle), std::sin(angle)) * (50.0f + unit(random) * 200.0f) : glm::vec2(0.0f);
+            sprite.Handle = m_Grid.Insert(AABB::FromQuad(sprite.Position, sprite.Size), (unsigned int)i);
+
+            sprite.StaticQuad = NoStaticQuad;
+            if (sprite.Velocity.x == 0.0f && sprite.Velocity.y == 0.0f)
+            {
+                sprite.StaticQuad = (unsigned int)(staticVertices.size() / 4);
+                Unorm8x4 color = Unorm8x4::Pack(sprite.Color);
+                glm::vec2 max = sprite.Position + sprite.Size;
+                staticVertices.push_back({ sprite.Position, color });
+                staticVertices.push_back({ glm::vec2(max.x, sprite.Position.y), color });
+                staticVertices.push_back({ max, color });
+                staticVertices.push_back({ glm::vec2(sprite.Position.x, max.y), color });
+            }
+        }
+
+        // 不动的 sprite 的顶点只上传这一次, 之后每帧只传索引
+        m_StaticVAO = std::make_unique<VertexArray>();
+        m_StaticVertices = std::make_unique<VertexBuffer>(staticVertices.data(), (unsigned int)(staticVertices.size() * sizeof(StaticVertex)));
+        m_StaticVAO->AddBuffer<StaticVertex>(*m_StaticVertices);
+	}
+
+	void TestCulling::AddStaticQuad(unsigned int quad)
+	{
+        unsigned int first = quad * 4;
+        unsigned int indices[6] = { first, first + 1, first + 2, first + 2, first + 3, first };
+        m_IndexScratch.insert(m_IndexScratch.end(), indices, indices + 6);
+        m_StreamedQuads++;
+        if (m_IndexScratch.size() == MaxStreamedQuads * 6)
+            FlushStaticQuads();
+	}
+
+	void TestCulling::FlushStaticQuads()
+	{
+        if (m_IndexScratch.empty())
+            return;
+
+        // 持久映射模式下索引写在环形缓冲中间, 画的时候要带上返回的偏移
+        unsigned int count = (unsigned int)m_IndexScratch.size();
+        unsigned int offset = m_StaticIndices->SetData(m_IndexScratch.data(), count);
+        Renderer renderer;
+        renderer.Draw(*m_StaticVAO, *m_StaticIndices, *ResourceManager::Get().GetShader(m_StaticShader), count, offset);
+        m_StreamedDrawCalls++;
+        m_IndexScratch.clear();
+	}
+
+	void TestCulling::DrawStaticSprites(const glm::mat4& viewProjection)
+	{
+        PROFILE_FUNCTION();
+        CameraUniforms camera = { viewProjection };
+        m_CameraBuffer->SetData(&camera, sizeof(CameraUniforms));
+        m_CameraBuffer->Bind();
+
+        m_IndexScratch.clear();
+        if (m_Culling)
+        {
+            for (unsigned int index : m_Visible)
+            {
+                if (m_Sprites[index].StaticQuad != NoStaticQuad)
+                    AddStaticQuad(m_Sprites[index].StaticQuad);
+            }
+        }
+        else
+        {
+            for (const WorldSprite& sprite : m_Sprites)
+            {
+                if (sprite.StaticQuad != NoStaticQuad)
+                    AddStaticQuad(sprite.StaticQuad);
+            }
+        }
+        FlushStaticQuads();
+	}
+
+	void TestCulling::OnUpdate(float deltaTime)
+	{
+        m_Time += deltaTime;
+        if (m_AutoPan)
+            m_CameraPosition = glm::vec2(WorldSize * 0.5f) + glm::vec2(std::cos(m_Time * 0.1f), std::sin(m_Time * 0.13f)) * (WorldSize * 0.4f);
+
+        // 运动的物体撞到世界边界就反弹, 每帧都要告诉索引新的包围盒 (大部分时候还在原来的格子里, 很便宜)
+        for (WorldSprite& sprite : m_Sprites)
+        {
+            if (sprite.Velocity.x == 0.0f && sprite.Velocity.y == 0.0f)
+                continue;
+            sprite.Position += sprite.Velocity * deltaTime;
+            for (int axis = 0; axis < 2; axis++)
+            {
+                if (sprite.Position[axis] < 0.0f || sprite.Position[axis] + sprite.Size[axis] > WorldSize)
+                {
+                    sprite.Velocity[axis] = -sprite.Velocity[axis];
+                    sprite.Position[axis] = glm::clamp(sprite.Position[axis], 0.0f, WorldSize - sprite.Size[axis]);
+                }
+            }
+            m_Grid.Update(sprite.Handle, AABB::FromQuad(sprite.Position, sprite.Size));
+        }
+	}
+
+	void TestCulling::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        // 相机看到的范围, 剔除总是按它来; 调试视图只是换一个看得更远的投影来画
+        glm::vec2 halfExtent = glm::vec2(480.0f, 270.0f) / m_Zoom;
+        glm::mat4 cameraViewProjection = glm::ortho(m_CameraPosition.x - halfExtent.x, m_CameraPosition.x + halfExtent.x,
+            m_CameraPosition.y - halfExtent.y, m_CameraPosition.y + halfExtent.y, -1.0f, 1.0f);
+        glm::mat4 viewProjection = cameraViewProjection;
+        if (m_DebugView)
+        {
+            glm::vec2 debugExtent = halfExtent * 4.0f;
+            viewProjection = glm::ortho(m_CameraPosition.x - debugExtent.x, m_CameraPosition.x + debugExtent.x,
+                m_CameraPosition.y - debugExtent.y, m_CameraPosition.y + debugExtent.y, -1.0f, 1.0f);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        m_Visible.clear();
+        if (m_Culling)
+            m_Grid.Query(Frustum(cameraViewProjection), m_Visible);
+        auto queried = std::chrono::steady_clock::now();
+
+        // 流式索引时不动的 sprite 先画, 运动的再由 BatchRenderer2D 叠在上面 (重叠处的前后顺序和只用 BatchRenderer2D 时不同)
+        m_StreamedQuads = 0;
+        m_StreamedDrawCalls = 0;
+        if (m_StreamStatic)
+            DrawStaticSprites(viewProjection);
+
+        m_Renderer->ResetStats();
+        m_Renderer->BeginScene(viewProjection);
+        if (m_Culling)
+        {
+            for (unsigned int index : m_Visible)
+            {
+                const WorldSprite& sprite = m_Sprites[index];
+                if (m_StreamStatic && sprite.StaticQuad != NoStaticQuad)
+                    continue;
+                m_Renderer->DrawQuad(sprite.Position, sprite.Size, sprite.Color);
+            }
+            m_Submitted = (unsigned int)m_Visible.size();
+        }
+        else
+        {
+            for (const WorldSprite& sprite : m_Sprites)
+            {
+                if (m_StreamStatic && sprite.StaticQuad != NoStaticQuad)
+                    continue;
+                m_Renderer->DrawQuad(sprite.Position, sprite.Size, sprite.Color);
+            }
+            m_Submitted = (unsigned int)m_Sprites.size();
+        }
+        if (m_DebugView)
+        {
+            // 相机范围的边框, 4 条细长的quad
+            float thickness = 4.0f / m_Zoom;
+            glm::vec2 min = m_CameraPosition - halfExtent, size = halfExtent * 2.0f;
+            glm::vec4 color(1.0f, 1.0f, 0.0f, 1.0f);
+            m_Renderer->DrawQuad(min, glm::vec2(size.x, thickness), color);
+            m_Renderer->DrawQuad(glm::vec2(min.x, min.y + size.y - thickness), glm::vec2(size.x, thickness), color);
+            m_Renderer->DrawQuad(min, glm::vec2(thickness, size.y), color);
+            m_Renderer->DrawQuad(glm::vec2(min.x + size.x - thickness, min.y), glm::vec2(thickness, size.y), color);
+        }
+        m_Renderer->EndScene();
+        m_LastStats = m_Renderer->GetStats();
+
+        auto end = std::chrono::steady_clock::now();
+        m_QueryTime = std::chrono::duration<float, std::milli>(queried - start).count();
+        m_RenderTime = std::chrono::duration<float, std::milli>(end - queried).count();
+	}
+
+	void TestCulling::OnImGuiRender()
+	{
+        ImGui::Checkbox("Frustum Culling", &m_Culling);
+        ImGui::Checkbox("Auto Pan", &m_AutoPan);
+        ImGui::SameLine();
+        ImGui::Checkbox("Debug View (zoomed out)", &m_DebugView);
+        ImGui::Checkbox("Static sprites: static vertices + streamed indices", &m_StreamStatic);
+        if (!m_AutoPan)
+            ImGui::SliderFloat2("Camera", &m_CameraPosition.x, 0.0f, WorldSize);
+        ImGui::SliderFloat("Zoom", &m_Zoom, 0.05f, 4.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
+
+        // 松开滑条才重新生成, 拖动过程中每帧重建几十万个物体太慢
+        ImGui::SliderInt("Sprites", &m_SpriteCount, 1000, 1000000, "%d", ImGuiSliderFlags_Logarithmic);
+        bool regenerate = ImGui::IsItemDeactivatedAfterEdit();
+        ImGui::SliderFloat("Moving", &m_MovingRatio, 0.0f, 1.0f);
+        regenerate |= ImGui::IsItemDeactivatedAfterEdit();
+        if (regenerate)
+            GenerateWorld();
+
+        const SpatialGrid::Statistics& stats = m_Grid.GetStats();
+        ImGui::Text("World: %.0f x %.0f, %u objects in %u cells of %.0f", WorldSize, WorldSize,
+            m_Grid.GetObjectCount(), m_Grid.GetCellCount(), m_Grid.GetCellSize());
+        if (m_Culling)
+            ImGui::Text("Query: %u cells visited, %u candidates tested, %u visible (%.3f ms)", stats.CellsVisited, stats.Candidates, stats.Visible, m_QueryTime);
+        ImGui::Text("Submitted: %u quads, %u draw calls (%.3f ms)", m_Submitted, m_LastStats.DrawCalls + m_StreamedDrawCalls, m_RenderTime);
+        if (m_StreamStatic)
+            ImGui::Text("Streamed indices: %u static quads in %u draw calls (%s)", m_StreamedQuads, m_StreamedDrawCalls,
+                m_StaticIndices->GetMode() == StreamBuffer::Mode::Persistent ? "persistent ring" : "orphaned");
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Test.h"
+
+#include "BatchRenderer2D.h"
+#include "SpatialGrid.h"
+#include "VertexArray.h"
+#include "DynamicIndexBuffer.h"
+#include "UniformBuffer.h"
+#include "ResourceManager.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	// 比视口大得多的世界里撒满 sprite, 用 SpatialGrid 按相机视锥体剔除后再交给 BatchRenderer2D
+	// 也可以把不动的 sprite 一次性放进静态顶点缓冲, 每帧只把剔除后可见的那些的索引流式上传 (DynamicIndexBuffer)
+	class TestCulling : public Test
+	{
+	private:
+		struct WorldSprite
+		{
+			glm::vec2 Position;
+			glm::vec2 Size;
+			glm::vec2 Velocity; // 为0的不动
+			glm::vec4 Color;
+			unsigned int Handle; // 在 m_Grid 里的句柄
+			unsigned int StaticQuad; // 在静态顶点缓冲里的第几个quad, 运动的 sprite 为 NoStaticQuad
+		};
+
+		// 和 Geometry.shader 的顶点属性对应
+		struct StaticVertex
+		{
+			glm::vec2 Position;
+			Unorm8x4 Color;
+
+			static constexpr auto GetLayout()
+			{
+				return std::array{ VERTEX_ATTRIBUTE(StaticVertex, Position), VERTEX_ATTRIBUTE(StaticVertex, Color) };
+			}
+		};
+
+		static constexpr float WorldSize = 40000.0f;
+		static const unsigned int NoStaticQuad = ~0u;
+		static const unsigned int MaxStreamedQuads = 16384; // 一次上传的索引最多覆盖这么多quad, 更多时分几次画
+
+		std::unique_ptr<BatchRenderer2D> m_Renderer;
+		SpatialGrid m_Grid;
+		std::vector<WorldSprite> m_Sprites;
+		std::vector<unsigned int> m_Visible; // 每帧查询的结果, m_Sprites 的下标
+
+		std::unique_ptr<VertexArray> m_StaticVAO;
+		std::unique_ptr<VertexBuffer> m_StaticVertices;
+		std::unique_ptr<DynamicIndexBuffer> m_StaticIndices;
+		std::unique_ptr<UniformBuffer> m_CameraBuffer;
+		ShaderHandle m_StaticShader;
+		std::vector<unsigned int> m_IndexScratch; // 攒满 MaxStreamedQuads 个quad的索引再上传
+
+		glm::vec2 m_CameraPosition; // 视口中心
+		float m_Zoom;
+		float m_Time;
+		int m_SpriteCount;
+		float m_MovingRatio;
+		bool m_Culling;
+		bool m_AutoPan;
+		bool m_DebugView; // 拉远了看, 相机的范围画成一个框
+		bool m_StreamStatic; // 不动的 sprite 走静态顶点 + 流式索引, 不经过 BatchRenderer2D
+
+		unsigned int m_Submitted;
+		unsigned int m_StreamedQuads, m_StreamedDrawCalls;
+		float m_QueryTime, m_RenderTime; // ms
+		BatchRenderer2D::Statistics m_LastStats;
+
+	public:
+		TestCulling();
+		~TestCulling();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void GenerateWorld();
+		// 把可见的不动 sprite 的索引写进 m_StaticIndices 画出来
+		void DrawStaticSprites(const glm::mat4& viewProjection);
+		void AddStaticQuad(unsigned int quad);
+		void FlushStaticQuads();
+	};
+}
@@ -0,0 +1,148 @@
+#include "TestFramebuffer.h"
+
+#include "Render.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "vendor/imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cstdio>
+#include <cmath>
+
+namespace test
+{
+	TestFramebuffer::TestFramebuffer()
+        :m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)), m_Time(0.0f), m_Samples(4), m_Scale(1.0f), m_Effect(0),
+        m_CaptureRequested(false), m_PendingCapture(0), m_CaptureFrames(0)
+	{
+        m_Renderer = std::make_unique<BatchRenderer2D>();
+
+        // 先按 960x540 建, 第一次 OnRender 时再按实际视口调整
+        FramebufferSpec spec;
+        spec.Width = 960;
+        spec.Height = 540;
+        spec.Samples = (unsigned int)m_Samples;
+        m_Framebuffer = std::make_unique<Framebuffer>(spec);
+        m_Samples = (int)m_Framebuffer->GetSamples();
+
+        m_Readback = std::make_unique<FramebufferReadback>();
+        m_EmptyVAO = std::make_unique<VertexArray>();
+
+        m_PostProcessShader = ResourceManager::Get().LoadShader("res/shaders/PostProcess.shader");
+        Shader* postProcess = ResourceManager::Get().GetShader(m_PostProcessShader);
+        postProcess->Bind();
+        postProcess->SetUniform1i("u_Scene", 0);
+	}
+
+	TestFramebuffer::~TestFramebuffer()
+	{
+        ResourceManager::Get().Release(m_PostProcessShader);
+	}
+
+	void TestFramebuffer::OnUpdate(float deltaTime)
+	{
+        m_Time += deltaTime;
+	}
+
+	void TestFramebuffer::DrawScene()
+	{
+        GLCall(glClearColor(0.1f, 0.1f, 0.15f, 1.0f));
+        GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        GLState::SetBlend(true);
+        GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        // 一圈旋转的细长矩形, 边缘是斜的, 开不开多重采样差别很明显
+        m_Renderer->BeginScene(m_Proj);
+        const int count = 24;
+        for (int i = 0; i < count; i++)
+        {
+            float angle = m_Time * 0.5f + i * 6.2831853f / count;
+            glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(480.0f, 270.0f, 0.0f));
+            transform = glm::rotate(transform, angle, glm::vec3(0.0f, 0.0f, 1.0f));
+            transform = glm::translate(transform, glm::vec3(140.0f, 0.0f, 0.0f));
+            transform = glm::scale(transform, glm::vec3(200.0f, 12.0f, 1.0f));
+            glm::vec4 color(0.5f + 0.5f * std::cos(angle), 0.5f + 0.5f * std::sin(angle), 0.8f, 1.0f);
+            m_Renderer->DrawQuad(transform, color);
+        }
+        m_Renderer->EndScene();
+	}
+
+	void TestFramebuffer::OnRender()
+	{
+        // 当前视口就是外面那个帧缓冲 (窗口或无窗口模式的 Framebuffer) 的大小
+        GLint viewport[4];
+        GLCall(glGetIntegerv(GL_VIEWPORT, viewport));
+        m_Framebuffer->Resize((int)(viewport[2] * m_Scale), (int)(viewport[3] * m_Scale));
+        m_Framebuffer->SetSamples((unsigned int)m_Samples);
+
+        m_Framebuffer->Bind();
+        DrawScene();
+        m_Framebuffer->Unbind();
+
+        // 后处理: 帧缓冲的颜色纹理铺满屏幕
+        {
+            PROFILE_SCOPE("PostProcess");
+            GLState::SetBlend(false);
+            Shader* postProcess = ResourceManager::Get().GetShader(m_PostProcessShader);
+            postProcess->Bind();
+            postProcess->SetUniform1i("u_Effect", m_Effect);
+            m_Framebuffer->BindColorAttachment(0);
+            m_EmptyVAO->Bind();
+            GLCall(glDrawArrays(GL_TRIANGLES, 0, 3));
+            GLState::SetBlend(true);
+        }
+
+        if (m_CaptureRequested)
+        {
+            m_CaptureRequested = false;
+            m_PendingCapture = m_Readback->Request(*m_Framebuffer);
+            m_CaptureFrames = 0;
+            m_CaptureStart = std::chrono::steady_clock::now();
+            if (!m_PendingCapture)
+                m_CaptureStatus = "All readback slots busy, try again";
+        }
+        PollCapture();
+	}
+
+	void TestFramebuffer::PollCapture()
+	{
+        if (!m_PendingCapture)
+            return;
+
+        CapturedImage image;
+        if (!m_Readback->Poll(image))
+        {
+            m_CaptureFrames++;
+            return;
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_CaptureStart).count();
+        const char* filepath = "framebuffer_capture.ppm";
+        bool written = FramebufferReadback::WritePPM(filepath, image);
+        char status[256];
+        std::snprintf(status, sizeof(status), "%s %dx%d to %s after %d frame(s), %.2f ms",
+            written ? "Wrote" : "Failed to write", image.Width, image.Height, filepath, m_CaptureFrames, ms);
+        m_CaptureStatus = status;
+        m_PendingCapture = 0;
+	}
+
+	void TestFramebuffer::OnImGuiRender()
+	{
+        ImGui::SliderInt("MSAA Samples", &m_Samples, 1, (int)m_Framebuffer->GetMaxSamples());
+        ImGui::SliderFloat("Resolution Scale", &m_Scale, 0.25f, 2.0f);
+        const char* effects[] = { "None", "Grayscale", "Invert", "Vignette" };
+        ImGui::Combo("Effect", &m_Effect, effects, IM_ARRAYSIZE(effects));
+
+        ImGui::Text("Framebuffer: %dx%d, %u samples%s", m_Framebuffer->GetWidth(), m_Framebuffer->GetHeight(),
+            m_Framebuffer->GetSamples(), m_Framebuffer->IsComplete() ? "" : " (incomplete!)");
+
+        if (ImGui::Button("Capture") && !m_PendingCapture)
+            m_CaptureRequested = true;
+        ImGui::SameLine();
+        ImGui::Text("%s", m_PendingCapture ? "waiting for GPU..." : m_CaptureStatus.c_str());
+
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Test.h"
+
+#include "BatchRenderer2D.h"
+#include "Framebuffer.h"
+#include "FramebufferReadback.h"
+#include "ResourceManager.h"
+#include "VertexArray.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace test
+{
+	// 场景先画到 (可多重采样的) Framebuffer 里, 再当纹理用一个全屏三角形做后处理画到屏幕上; 截图走异步PBO读回
+	class TestFramebuffer : public Test
+	{
+	private:
+		std::unique_ptr<BatchRenderer2D> m_Renderer;
+		std::unique_ptr<Framebuffer> m_Framebuffer;
+		std::unique_ptr<FramebufferReadback> m_Readback;
+		ShaderHandle m_PostProcessShader;
+		std::unique_ptr<VertexArray> m_EmptyVAO; // 核心模式下画东西必须绑定一个VAO, 哪怕不用顶点属性
+
+		glm::mat4 m_Proj;
+		float m_Time;
+		int m_Samples;
+		float m_Scale;  // 帧缓冲相对视口的分辨率
+		int m_Effect;   // 和 PostProcess.shader 里的 u_Effect 对应
+
+		// 截图
+		bool m_CaptureRequested;
+		uint64_t m_PendingCapture; // 0 表示没有在等的
+		int m_CaptureFrames;       // 请求之后过了几帧
+		std::chrono::steady_clock::time_point m_CaptureStart;
+		std::string m_CaptureStatus;
+
+	public:
+		TestFramebuffer();
+		~TestFramebuffer();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void DrawScene();
+		void PollCapture();
+	};
+}
@@ -0,0 +1,132 @@
+#include "TestInstancing.h"
+
+#include "Render.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "vendor/imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cmath>
+
+namespace test
+{
+	TestInstancing::TestInstancing()
+        :m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_InstanceCount(10000), m_Animate(true), m_Time(0.0f), m_PrevTime(0.0f), m_RenderTime(0.0f)
+	{
+        // 单位quad, 中心在原点, 方便绕中心旋转
+        float positions[] = {
+            -0.5f, -0.5f, 0.0f, 0.0f,
+             0.5f, -0.5f, 1.0f, 0.0f,
+             0.5f,  0.5f, 1.0f, 1.0f,
+            -0.5f,  0.5f, 0.0f, 1.0f
+        };
+
+        unsigned int indices[] = {
+            0, 1, 2,
+            2, 3, 0
+        };
+
+        GLState::SetBlend(true);
+        GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_VAO = std::make_unique<VertexArray>();
+
+        QuadVertex vertices[4];
+        for (int i = 0; i < 4; i++)
+        {
+            vertices[i].Position[0] = Half::Pack(positions[i * 4 + 0]);
+            vertices[i].Position[1] = Half::Pack(positions[i * 4 + 1]);
+            vertices[i].TexCoord[0] = Half::Pack(positions[i * 4 + 2]);
+            vertices[i].TexCoord[1] = Half::Pack(positions[i * 4 + 3]);
+        }
+
+        m_VertexBuffer = std::make_unique<VertexBuffer>(vertices, (unsigned int)sizeof(vertices));
+        m_VAO->AddBuffer<QuadVertex>(*m_VertexBuffer);
+
+        // 有 base instance 时用持久映射的环形缓冲, 否则每帧孤立整块缓冲, 数据总是从0开始
+        StreamBuffer::Mode mode = Renderer::IsBaseInstanceSupported() ? StreamBuffer::Mode::Persistent : StreamBuffer::Mode::Orphan;
+        m_InstanceBuffer = std::make_unique<DynamicVertexBuffer>(MaxInstances * (unsigned int)sizeof(InstanceData), mode);
+        m_VAO->AddBuffer<InstanceData>(*m_InstanceBuffer, 1); // 每画完 1 个实例前进一格
+
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+
+        m_Shader = ResourceManager::Get().LoadShader("res/shaders/Instanced.shader");
+        Shader* shader = ResourceManager::Get().GetShader(m_Shader);
+        shader->Bind();
+        shader->SetUniform1i("u_Texture", 0);
+        shader->BindUniformBlock("Camera", UniformBuffer::CameraBinding);
+
+        m_CameraBuffer = std::make_unique<UniformBuffer>((unsigned int)sizeof(CameraUniforms), UniformBuffer::CameraBinding);
+
+        TextureSpec spec;
+        spec.GenerateMips = true;
+        m_Texture = ResourceManager::Get().LoadTexture("res/logo.png", spec);
+
+        m_Instances.resize(MaxInstances);
+	}
+
+	TestInstancing::~TestInstancing()
+	{
+        ResourceManager::Get().Release(m_Shader);
+        ResourceManager::Get().Release(m_Texture);
+	}
+
+	void TestInstancing::OnUpdate(float deltaTime)
+	{
+        m_PrevTime = m_Time;
+        if (m_Animate)
+            m_Time += deltaTime;
+        m_RenderTime = m_Time;
+	}
+
+	void TestInstancing::OnInterpolate(float alpha)
+	{
+        m_RenderTime = m_PrevTime + (m_Time - m_PrevTime) * alpha;
+	}
+
+	void TestInstancing::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        PROFILE_SCOPE("TestInstancing::BuildInstances");
+        // 按网格排开, 每个实例自己旋转
+        int columns = (int)std::ceil(std::sqrt((float)m_InstanceCount * 960.0f / 540.0f));
+        float cell = 960.0f / (float)columns;
+        for (int i = 0; i < m_InstanceCount; i++)
+        {
+            int x = i % columns, y = i / columns;
+            glm::vec3 center((x + 0.5f) * cell, (y + 0.5f) * cell, 0.0f);
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), center);
+            model = glm::rotate(model, m_RenderTime + i * 0.01f, glm::vec3(0.0f, 0.0f, 1.0f));
+            model = glm::scale(model, glm::vec3(cell * 0.8f, cell * 0.8f, 1.0f));
+
+            m_Instances[i].Model = model;
+            m_Instances[i].Color = Unorm8x4::Pack(glm::vec4((float)x / columns, 0.5f, 1.0f - (float)i / m_InstanceCount, 1.0f));
+        }
+
+        CameraUniforms camera = { m_Proj };
+        m_CameraBuffer->SetData(&camera, sizeof(CameraUniforms));
+        m_CameraBuffer->Bind();
+
+        unsigned int offset = m_InstanceBuffer->SetData(m_Instances.data(), m_InstanceCount * (unsigned int)sizeof(InstanceData));
+        unsigned int baseInstance = offset / (unsigned int)sizeof(InstanceData);
+
+        ResourceManager::Get().GetTexture(m_Texture)->Bind();
+        Renderer renderer;
+        renderer.DrawInstanced(*m_VAO, *m_IndexBuffer, *ResourceManager::Get().GetShader(m_Shader), m_InstanceCount, baseInstance);
+	}
+
+	void TestInstancing::OnImGuiRender()
+	{
+        ImGui::SliderInt("Instances", &m_InstanceCount, 1, MaxInstances);
+        ImGui::Checkbox("Animate", &m_Animate);
+        ImGui::Text("Draw Calls: 1");
+        ImGui::Text("Instance buffer: %s", m_InstanceBuffer->GetMode() == StreamBuffer::Mode::Persistent ? "persistent ring + base instance" : "orphaned");
+        ImGui::Text("State Changes: %u issued, %u skipped", GLState::GetStats().Issued, GLState::GetStats().Skipped);
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Test.h"
+
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "ResourceManager.h"
+#include "UniformBuffer.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	// 同一个带纹理的quad画成千上万份, 每份的模型矩阵和颜色放在逐实例的顶点缓冲里, 整个场景只有一次 draw call
+	class TestInstancing : public Test
+	{
+	private:
+		// 单位quad的坐标都在 [-0.5, 1] 里, 半精度能精确表示
+		struct QuadVertex
+		{
+			Half Position[2];
+			Half TexCoord[2];
+
+			static constexpr auto GetLayout()
+			{
+				return std::array{ VERTEX_ATTRIBUTE(QuadVertex, Position), VERTEX_ATTRIBUTE(QuadVertex, TexCoord) };
+			}
+		};
+
+		// 和 Instanced.shader 里的逐实例属性一一对应
+		struct InstanceData
+		{
+			glm::mat4 Model;
+			Unorm8x4 Color; // 每帧都上传, 颜色用 4 字节就够了
+
+			static constexpr auto GetLayout()
+			{
+				return std::array{ VERTEX_ATTRIBUTE(InstanceData, Model), VERTEX_ATTRIBUTE(InstanceData, Color) };
+			}
+		};
+
+		static const unsigned int MaxInstances = 50000;
+
+		std::unique_ptr<VertexArray> m_VAO;
+		std::unique_ptr<VertexBuffer> m_VertexBuffer;
+		std::unique_ptr<DynamicVertexBuffer> m_InstanceBuffer;
+		std::unique_ptr<IndexBuffer> m_IndexBuffer;
+		ShaderHandle m_Shader;
+		TextureHandle m_Texture;
+		std::unique_ptr<UniformBuffer> m_CameraBuffer;
+
+		std::vector<InstanceData> m_Instances;
+		glm::mat4 m_Proj;
+		int m_InstanceCount;
+		bool m_Animate;
+		float m_Time, m_PrevTime; // 最近两次更新后的动画时间
+		float m_RenderTime;       // 渲染用的时间, 固定步长时在上面两个之间插值
+
+	public:
+		TestInstancing();
+		~TestInstancing();
+
+		void OnUpdate(float deltaTime) override;
+		void OnInterpolate(float alpha) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+	};
+}
@@ -0,0 +1,115 @@
+#include "TestMultiDrawIndirect.h"
+
+#include "Render.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "vendor/imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cmath>
+
+namespace test
+{
+	TestMultiDrawIndirect::TestMultiDrawIndirect()
+        :m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_MeshCount(1024), m_BuiltMeshCount(0), m_SubmitMode(0), m_LastDrawCalls(0)
+	{
+        GLState::SetBlend(false);
+
+        // 最多 12 条边的多边形: 13 个顶点, 36 个索引
+        m_Pool = std::make_unique<GeometryPool>(GetVertexLayout<MeshVertex>(), MaxMeshes * 13, MaxMeshes * 36);
+        m_Commands = std::make_unique<DrawCommandBuffer>(MaxMeshes);
+        m_SubmitMode = (int)m_Commands->GetSubmitMode();
+
+        m_Shader = ResourceManager::Get().LoadShader("res/shaders/Geometry.shader");
+        ResourceManager::Get().GetShader(m_Shader)->BindUniformBlock("Camera", UniformBuffer::CameraBinding);
+        m_CameraBuffer = std::make_unique<UniformBuffer>((unsigned int)sizeof(CameraUniforms), UniformBuffer::CameraBinding);
+
+        BuildMeshes();
+	}
+
+	TestMultiDrawIndirect::~TestMultiDrawIndirect()
+	{
+        ResourceManager::Get().Release(m_Shader);
+	}
+
+	void TestMultiDrawIndirect::BuildMeshes()
+	{
+        PROFILE_SCOPE("TestMultiDrawIndirect::BuildMeshes");
+        for (const MeshAllocation& mesh : m_Meshes)
+            m_Pool->Free(mesh);
+        m_Meshes.clear();
+
+        int columns = (int)std::ceil(std::sqrt((float)m_MeshCount * 960.0f / 540.0f));
+        float cell = 960.0f / (float)columns;
+        std::vector<MeshVertex> vertices;
+        std::vector<unsigned int> indices;
+        for (int i = 0; i < m_MeshCount; i++)
+        {
+            // 每个网格的边数、大小、颜色都不一样, 位置直接烘焙进顶点里
+            int sides = 3 + i % 10;
+            glm::vec2 center(((i % columns) + 0.5f) * cell, ((i / columns) + 0.5f) * cell);
+            float radius = cell * (0.3f + 0.15f * (float)((i * 7) % 5) / 4.0f);
+            glm::vec4 color(0.3f + 0.7f * (float)(i % columns) / columns, (float)sides / 12.0f, 0.8f, 1.0f);
+
+            vertices.clear();
+            indices.clear();
+            vertices.push_back({ center, color });
+            for (int s = 0; s < sides; s++)
+            {
+                float angle = 6.2831853f * (float)s / (float)sides;
+                vertices.push_back({ center + radius * glm::vec2(std::cos(angle), std::sin(angle)), color * 0.7f });
+                indices.push_back(0);
+                indices.push_back(1 + s);
+                indices.push_back(1 + (s + 1) % sides);
+            }
+
+            MeshAllocation mesh = m_Pool->Allocate(vertices.data(), (unsigned int)vertices.size(), indices.data(), (unsigned int)indices.size());
+            if (mesh.IsValid())
+                m_Meshes.push_back(mesh);
+        }
+        m_BuiltMeshCount = m_MeshCount;
+	}
+
+	void TestMultiDrawIndirect::OnUpdate(float deltaTime)
+	{
+	}
+
+	void TestMultiDrawIndirect::OnRender()
+	{
+        // 重建要上传到GPU, 只能在渲染线程里做
+        if (m_MeshCount != m_BuiltMeshCount)
+            BuildMeshes();
+
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        CameraUniforms camera = { m_Proj };
+        m_CameraBuffer->SetData(&camera, sizeof(CameraUniforms));
+        m_CameraBuffer->Bind();
+
+        m_Commands->Clear();
+        for (const MeshAllocation& mesh : m_Meshes)
+            m_Commands->Add(mesh);
+
+        Renderer renderer;
+        m_LastDrawCalls = renderer.DrawIndirect(*m_Pool, *m_Commands, *ResourceManager::Get().GetShader(m_Shader));
+	}
+
+	void TestMultiDrawIndirect::OnImGuiRender()
+	{
+        ImGui::SliderInt("Meshes", &m_MeshCount, 1, MaxMeshes);
+
+        const char* modes[] = { "glMultiDrawElementsIndirect", "glDrawElementsIndirect loop", "glDrawElements* loop" };
+        if (ImGui::Combo("Submit", &m_SubmitMode, modes, 3))
+            m_SubmitMode = (int)m_Commands->SetSubmitMode((DrawCommandBuffer::SubmitMode)m_SubmitMode);
+
+        ImGui::Text("Draw Calls: %u (%u commands)", m_LastDrawCalls, m_Commands->GetCount());
+        ImGui::Text("Pool: %u / %u vertices, %u / %u indices", m_Pool->GetVerticesUsed(), m_Pool->GetVertexCapacity(),
+            m_Pool->GetIndicesUsed(), m_Pool->GetIndexCapacity());
+        ImGui::Text("State Changes: %u issued, %u skipped", GLState::GetStats().Issued, GLState::GetStats().Skipped);
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
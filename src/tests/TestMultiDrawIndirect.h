@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Test.h"
+
+#include "GeometryPool.h"
+#include "DrawCommandBuffer.h"
+#include "UniformBuffer.h"
+#include "ResourceManager.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	// 大量各不相同的多边形网格放在同一个 GeometryPool 里, 用间接绘制命令一次提交
+	class TestMultiDrawIndirect : public Test
+	{
+	private:
+		struct MeshVertex
+		{
+			glm::vec2 Position;
+			glm::vec4 Color;
+
+			static constexpr auto GetLayout()
+			{
+				return std::array{ VERTEX_ATTRIBUTE(MeshVertex, Position), VERTEX_ATTRIBUTE(MeshVertex, Color) };
+			}
+		};
+
+		static const int MaxMeshes = 4096;
+
+		std::unique_ptr<GeometryPool> m_Pool;
+		std::unique_ptr<DrawCommandBuffer> m_Commands;
+		ShaderHandle m_Shader;
+		std::unique_ptr<UniformBuffer> m_CameraBuffer;
+		std::vector<MeshAllocation> m_Meshes;
+
+		glm::mat4 m_Proj;
+		int m_MeshCount;
+		int m_BuiltMeshCount;
+		int m_SubmitMode;
+		unsigned int m_LastDrawCalls;
+
+	public:
+		TestMultiDrawIndirect();
+		~TestMultiDrawIndirect();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		// 释放旧的网格, 重新生成 m_MeshCount 个
+		void BuildMeshes();
+	};
+}
@@ -0,0 +1,122 @@
+#include "TestParallelRecord.h"
+
+#include "Render.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "vendor/imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+#include <cmath>
+
+namespace test
+{
+	TestParallelRecord::TestParallelRecord()
+        :m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_QuadCount(100000), m_Parallel(true), m_SortQuads(false), m_Time(0.0f), m_PrevTime(0.0f), m_RenderTime(0.0f), m_RecordMs(0.0f), m_ReplayMs(0.0f)
+	{
+        GLState::SetBlend(true);
+        GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_Renderer = std::make_unique<BatchRenderer2D>();
+        m_Recorder = std::make_unique<CommandRecorder>();
+
+        m_Texture[0] = ResourceManager::Get().LoadTexture("res/logo.png");
+        m_Texture[1] = ResourceManager::Get().LoadTexture("res/profile.jpg");
+        m_RecordTextures[0] = m_RecordTextures[1] = nullptr;
+	}
+
+	TestParallelRecord::~TestParallelRecord()
+	{
+        ResourceManager::Get().Release(m_Texture[0]);
+        ResourceManager::Get().Release(m_Texture[1]);
+	}
+
+	void TestParallelRecord::OnUpdate(float deltaTime)
+	{
+        m_PrevTime = m_Time;
+        m_Time += deltaTime;
+        m_RenderTime = m_Time;
+	}
+
+	void TestParallelRecord::OnInterpolate(float alpha)
+	{
+        m_RenderTime = m_PrevTime + (m_Time - m_PrevTime) * alpha;
+	}
+
+	void TestParallelRecord::RecordRange(CommandList& list, int begin, int end) const
+	{
+        int columns = (int)std::ceil(std::sqrt((float)m_QuadCount * 960.0f / 540.0f));
+        float cell = 960.0f / (float)columns;
+        for (int i = begin; i < end; i++)
+        {
+            int x = i % columns, y = i / columns;
+            glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3((x + 0.5f) * cell, (y + 0.5f) * cell, 0.0f));
+            transform = glm::rotate(transform, m_RenderTime + i * 0.001f, glm::vec3(0.0f, 0.0f, 1.0f));
+            transform = glm::scale(transform, glm::vec3(cell * 0.8f, cell * 0.8f, 1.0f));
+            transform = glm::translate(transform, glm::vec3(-0.5f, -0.5f, 0.0f));
+
+            glm::vec4 color((float)x / columns, 0.5f, (float)y / columns, 1.0f);
+            const Texture* texture = i % 4 == 0 ? m_RecordTextures[(i / 4) % 2] : nullptr;
+            list.DrawQuad(transform, color, texture);
+        }
+	}
+
+	void TestParallelRecord::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        m_RecordTextures[0] = ResourceManager::Get().GetTexture(m_Texture[0]);
+        m_RecordTextures[1] = ResourceManager::Get().GetTexture(m_Texture[1]);
+
+        auto start = std::chrono::steady_clock::now();
+        if (m_Parallel)
+        {
+            int count = m_QuadCount;
+            m_Recorder->Record([this, count](CommandList& list, unsigned int job, unsigned int jobCount) {
+                RecordRange(list, (int)((long long)count * job / jobCount), (int)((long long)count * (job + 1) / jobCount));
+            }, 0, m_SortQuads);
+        }
+        else
+        {
+            PROFILE_SCOPE("TestParallelRecord::RecordSingleThread");
+            m_SingleThreadList.Reset();
+            RecordRange(m_SingleThreadList, 0, m_QuadCount);
+            if (m_SortQuads)
+                m_SingleThreadList.SortQuads();
+        }
+        auto recorded = std::chrono::steady_clock::now();
+
+        PROFILE_GPU_SCOPE("TestParallelRecord::Submit");
+        m_Renderer->ResetStats();
+        m_Renderer->BeginScene(m_Proj);
+        if (m_Parallel)
+            m_Recorder->Replay(*m_Renderer);
+        else
+        {
+            for (const RecordedQuad& quad : m_SingleThreadList.GetQuads())
+                m_Renderer->SubmitQuad(quad.Vertices, quad.Tex);
+        }
+        m_Renderer->EndScene();
+        m_LastStats = m_Renderer->GetStats();
+        auto replayed = std::chrono::steady_clock::now();
+
+        m_RecordMs = std::chrono::duration<float, std::milli>(recorded - start).count();
+        m_ReplayMs = std::chrono::duration<float, std::milli>(replayed - recorded).count();
+	}
+
+	void TestParallelRecord::OnImGuiRender()
+	{
+        ImGui::SliderInt("Quads", &m_QuadCount, 1, 500000);
+        ImGui::Checkbox("Record on worker threads", &m_Parallel);
+        ImGui::Checkbox("Sort by texture (reorders overlapping quads)", &m_SortQuads);
+        ImGui::Text("Worker threads: %u", m_Recorder->GetThreadCount());
+        ImGui::Text("Record: %.3f ms, replay + submit: %.3f ms", m_RecordMs, m_ReplayMs);
+        ImGui::Text("Draw Calls: %u", m_LastStats.DrawCalls);
+        ImGui::Text("Quads: %u", m_LastStats.QuadCount);
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
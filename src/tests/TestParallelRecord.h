@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Test.h"
+
+#include "BatchRenderer2D.h"
+#include "CommandRecorder.h"
+#include "ResourceManager.h"
+
+#include <memory>
+
+namespace test
+{
+	// 大量旋转的quad, 变换和顶点生成在工作线程里录制, 渲染线程只负责回放和提交, 对比单线程录制的耗时
+	class TestParallelRecord : public Test
+	{
+	private:
+		std::unique_ptr<BatchRenderer2D> m_Renderer;
+		std::unique_ptr<CommandRecorder> m_Recorder;
+		TextureHandle m_Texture[2];
+		const Texture* m_RecordTextures[2]; // ResourceManager 只能在渲染线程用, 录制前在 OnRender 里解析好
+		CommandList m_SingleThreadList;
+
+		glm::mat4 m_Proj;
+		int m_QuadCount;
+		bool m_Parallel;
+		bool m_SortQuads; // 按纹理排序: flush 更少, 但旋转的quad角上有重叠, 半透明时前后顺序会变
+		float m_Time, m_PrevTime;
+		float m_RenderTime; // 固定步长时在最近两步之间插值
+		float m_RecordMs, m_ReplayMs;
+		BatchRenderer2D::Statistics m_LastStats;
+
+	public:
+		TestParallelRecord();
+		~TestParallelRecord();
+
+		void OnUpdate(float deltaTime) override;
+		void OnInterpolate(float alpha) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		// 录制第 [begin, end) 个quad
+		void RecordRange(CommandList& list, int begin, int end) const;
+	};
+}
@@ -0,0 +1,129 @@
+#include "TestRenderQueue.h"
+
+#include "Render.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "vendor/imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <random>
+
+namespace test
+{
+	TestRenderQueue::TestRenderQueue()
+        :m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)),
+        m_ItemCount(2000), m_Sort(true)
+	{
+        // 两种形状: 正方形和细长条
+        const ShapeVertex square[] = {
+            { { 0.0f,  0.0f },  { 0.0f, 0.0f } },
+            { { 40.0f, 0.0f },  { 1.0f, 0.0f } },
+            { { 40.0f, 40.0f }, { 1.0f, 1.0f } },
+            { { 0.0f,  40.0f }, { 0.0f, 1.0f } }
+        };
+        const ShapeVertex bar[] = {
+            { { 0.0f,  0.0f },  { 0.0f, 0.0f } },
+            { { 80.0f, 0.0f },  { 1.0f, 0.0f } },
+            { { 80.0f, 15.0f }, { 1.0f, 1.0f } },
+            { { 0.0f,  15.0f }, { 0.0f, 1.0f } }
+        };
+        unsigned int indices[] = {
+            0, 1, 2,
+            2, 3, 0
+        };
+
+        const ShapeVertex* shapes[2] = { square, bar };
+        for (int i = 0; i < 2; i++)
+        {
+            m_VAO[i] = std::make_unique<VertexArray>();
+            m_VertexBuffer[i] = std::make_unique<VertexBuffer>(shapes[i], 4 * (unsigned int)sizeof(ShapeVertex));
+            m_VAO[i]->AddBuffer<ShapeVertex>(*m_VertexBuffer[i]);
+        }
+        // 索引缓冲是VAO状态: 创建时记录在最后绑定的 m_VAO[1] 里, m_VAO[0] 还要再绑一次
+        m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
+        m_VAO[0]->Bind();
+        m_IndexBuffer->Bind();
+
+        for (int i = 0; i < 2; i++)
+        {
+            m_Shader[i] = std::make_unique<Shader>("res/Basic.shader");
+            m_Shader[i]->Bind();
+            m_Shader[i]->SetUniform1i("u_Texture", 0);
+            m_Shader[i]->BindUniformBlock("Camera", UniformBuffer::CameraBinding);
+        }
+        m_CameraBuffer = std::make_unique<UniformBuffer>((unsigned int)sizeof(CameraUniforms), UniformBuffer::CameraBinding);
+
+        // 纹理和其它 Test 共用; 着色器故意不走 ResourceManager, 否则两个 "材质" 会被合并成一个 program
+        m_Texture[0] = ResourceManager::Get().LoadTexture("res/logo.png");
+        m_Texture[1] = ResourceManager::Get().LoadTexture("res/profile.jpg");
+        const Texture* textures[2] = { ResourceManager::Get().GetTexture(m_Texture[0]), ResourceManager::Get().GetTexture(m_Texture[1]) };
+
+        // 固定种子, 每次打开都是同一个场景
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        m_Items.resize(MaxItems);
+        for (RenderItem& item : m_Items)
+        {
+            int shape = random() % 2;
+            item.VAO = m_VAO[shape].get();
+            item.IB = m_IndexBuffer.get();
+            item.ShaderProgram = m_Shader[random() % 2].get();
+            item.Tex = textures[random() % 2];
+            item.Layer = unit(random) < 0.1f ? 1 : 0;
+            item.Translucent = unit(random) < 0.2f;
+            item.Depth = unit(random);
+            // 正交投影的近/远平面是 z = 1 / -1, 深度 0 对应最近
+            glm::vec3 position(unit(random) * 920.0f, unit(random) * 520.0f, 0.99f - 1.98f * item.Depth);
+            item.Model = glm::translate(glm::mat4(1.0f), position);
+        }
+	}
+
+	TestRenderQueue::~TestRenderQueue()
+	{
+        GLCall(glDisable(GL_DEPTH_TEST));
+        ResourceManager::Get().Release(m_Texture[0]);
+        ResourceManager::Get().Release(m_Texture[1]);
+	}
+
+	void TestRenderQueue::OnUpdate(float deltaTime)
+	{
+	}
+
+	void TestRenderQueue::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        // 从近到远画不透明物体时, 深度测试可以提前剔除被挡住的片段
+        GLCall(glEnable(GL_DEPTH_TEST));
+
+        CameraUniforms camera = { m_Proj };
+        m_CameraBuffer->SetData(&camera, sizeof(CameraUniforms));
+        m_CameraBuffer->Bind();
+
+        m_Queue.SetSortEnabled(m_Sort);
+        {
+            PROFILE_SCOPE("TestRenderQueue::Submit");
+            for (int i = 0; i < m_ItemCount; i++)
+                m_Queue.Submit(m_Items[i]);
+        }
+
+        Renderer renderer;
+        m_Queue.Flush(renderer);
+
+        // ImGui 在后面画, 不能被深度测试挡住
+        GLCall(glDisable(GL_DEPTH_TEST));
+	}
+
+	void TestRenderQueue::OnImGuiRender()
+	{
+        const RenderQueue::Statistics& stats = m_Queue.GetStats();
+        ImGui::SliderInt("Items", &m_ItemCount, 1, MaxItems);
+        ImGui::Checkbox("Sort", &m_Sort);
+        ImGui::Text("Draws: %u", stats.Submitted);
+        ImGui::Text("Shader changes: %u, texture changes: %u, VAO changes: %u", stats.ShaderChanges, stats.TextureChanges, stats.VertexArrayChanges);
+        ImGui::Text("State Changes: %u issued, %u skipped", GLState::GetStats().Issued, GLState::GetStats().Skipped);
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
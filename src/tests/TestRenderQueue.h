@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Test.h"
+
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "ResourceManager.h"
+#include "UniformBuffer.h"
+#include "RenderQueue.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	// 着色器/纹理/VAO 随机混合的一堆quad, 对比按提交顺序画和经过 RenderQueue 排序后画的状态切换次数
+	class TestRenderQueue : public Test
+	{
+	private:
+		struct ShapeVertex
+		{
+			glm::vec2 Position;
+			glm::vec2 TexCoord;
+
+			static constexpr auto GetLayout()
+			{
+				return std::array{ VERTEX_ATTRIBUTE(ShapeVertex, Position), VERTEX_ATTRIBUTE(ShapeVertex, TexCoord) };
+			}
+		};
+
+		static const int MaxItems = 5000;
+
+		std::unique_ptr<VertexArray> m_VAO[2];
+		std::unique_ptr<VertexBuffer> m_VertexBuffer[2];
+		std::unique_ptr<IndexBuffer> m_IndexBuffer;
+		std::unique_ptr<Shader> m_Shader[2]; // 同一个文件的两个 program, 模拟不同的材质
+		TextureHandle m_Texture[2];
+		std::unique_ptr<UniformBuffer> m_CameraBuffer;
+
+		RenderQueue m_Queue;
+		std::vector<RenderItem> m_Items; // 按随机顺序排好的场景, 每帧原样提交
+		glm::mat4 m_Proj;
+		int m_ItemCount;
+		bool m_Sort;
+
+	public:
+		TestRenderQueue();
+		~TestRenderQueue();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+	};
+}
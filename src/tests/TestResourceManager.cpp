@@ -0,0 +1,123 @@
+#include "TestResourceManager.h"
+
+#include "Render.h"
+#include "GLState.h"
+#include "vendor/imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test
+{
+	TestResourceManager::TestResourceManager()
+        :m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)), m_HandleCount(32), m_VariantCount(2),
+        m_BudgetMB((float)ResourceManager::Get().GetBudget() / (1024.0f * 1024.0f))
+	{
+        GLState::SetBlend(true);
+        GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_Renderer = std::make_unique<BatchRenderer2D>();
+        AcquireTextures();
+	}
+
+	TestResourceManager::~TestResourceManager()
+	{
+        ReleaseTextures();
+	}
+
+	void TestResourceManager::AcquireTextures()
+	{
+        // 和 TestAsyncTexture 不同, 这里同一个 (路径, 参数) 只会加载一次, 其余都是缓存命中
+        const char* paths[] = { "res/logo.png", "res/profile.jpg" };
+        for (int i = 0; i < m_HandleCount; i++)
+        {
+            TextureSpec spec;
+            int variant = (i / 2) % m_VariantCount;
+            spec.Filter = variant % 2 == 0 ? TextureFilter::Linear : TextureFilter::Nearest;
+            spec.GenerateMips = variant >= 2;
+            m_Handles.push_back(ResourceManager::Get().LoadTexture(paths[i % 2], spec));
+        }
+	}
+
+	void TestResourceManager::ReleaseTextures()
+	{
+        for (TextureHandle handle : m_Handles)
+            ResourceManager::Get().Release(handle);
+        m_Handles.clear();
+	}
+
+	void TestResourceManager::OnUpdate(float deltaTime)
+	{
+	}
+
+	void TestResourceManager::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        m_Renderer->BeginScene(m_Proj);
+        int columns = 8;
+        float cell = 960.0f / columns;
+        for (size_t i = 0; i < m_Handles.size(); i++)
+        {
+            glm::vec2 position((i % columns) * cell, 540.0f - (i / columns + 1) * cell);
+            if (const Texture* texture = ResourceManager::Get().GetTexture(m_Handles[i]))
+                m_Renderer->DrawQuad(position, glm::vec2(cell * 0.9f), *texture);
+            else
+                m_Renderer->DrawQuad(position, glm::vec2(cell * 0.9f), glm::vec4(1.0f, 0.0f, 1.0f, 1.0f));
+        }
+        m_Renderer->EndScene();
+	}
+
+	void TestResourceManager::OnImGuiRender()
+	{
+        ResourceManager& resources = ResourceManager::Get();
+
+        ImGui::SliderInt("Handle Count", &m_HandleCount, 1, 64);
+        ImGui::SliderInt("Spec Variants", &m_VariantCount, 1, 4);
+        if (ImGui::Button("Reacquire"))
+        {
+            ReleaseTextures();
+            AcquireTextures();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Release All"))
+            ReleaseTextures();
+        ImGui::SameLine();
+        if (ImGui::Button("Evict Unused"))
+            resources.EvictUnused();
+
+        // 预算调到比正在用的还小时, 没人用的纹理会在下一次 Update 被淘汰, 正在用的不受影响
+        if (ImGui::SliderFloat("Budget (MB)", &m_BudgetMB, 0.0f, 256.0f, "%.1f"))
+            resources.SetBudget((size_t)(m_BudgetMB * 1024.0f * 1024.0f));
+
+        const ResourceManager::Statistics& stats = resources.GetStats();
+        ImGui::Text("Texture memory: %.2f / %.2f MB", resources.GetTextureMemory() / (1024.0 * 1024.0), resources.GetBudget() / (1024.0 * 1024.0));
+        ImGui::Text("Loads: %u  Cache hits: %u  Evictions: %u", stats.Loads, stats.CacheHits, stats.Evictions);
+        if (ImGui::Button("Reset Stats"))
+            resources.ResetStats();
+
+        resources.GetEntries(m_Entries);
+        if (ImGui::BeginTable("Resources", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+        {
+            ImGui::TableSetupColumn("Key");
+            ImGui::TableSetupColumn("Refs");
+            ImGui::TableSetupColumn("KB");
+            ImGui::TableSetupColumn("Last Used");
+            ImGui::TableHeadersRow();
+            for (const ResourceManager::EntryInfo& entry : m_Entries)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%s %s", entry.IsTexture ? "[T]" : "[S]", entry.Key.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", entry.RefCount);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", entry.MemorySize / 1024.0);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", (unsigned long long)entry.LastUsedFrame);
+            }
+            ImGui::EndTable();
+        }
+	}
+}
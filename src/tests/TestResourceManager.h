@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Test.h"
+
+#include "BatchRenderer2D.h"
+#include "ResourceManager.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	// 通过 ResourceManager 反复申请同一批纹理, 看去重、引用计数和显存预算下的 LRU 淘汰
+	class TestResourceManager : public Test
+	{
+	private:
+		std::unique_ptr<BatchRenderer2D> m_Renderer;
+		std::vector<TextureHandle> m_Handles;
+		std::vector<ResourceManager::EntryInfo> m_Entries;
+
+		glm::mat4 m_Proj;
+		int m_HandleCount;
+		int m_VariantCount; // 每张图用几种不同的 TextureSpec, 每种都是单独的GPU对象
+		float m_BudgetMB;
+
+	public:
+		TestResourceManager();
+		~TestResourceManager();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void AcquireTextures();
+		void ReleaseTextures();
+	};
+}
@@ -0,0 +1,130 @@
+#include "TestSpriteKernels.h"
+
+#include "Render.h"
+#include "GLState.h"
+#include "Profiler.h"
+#include "vendor/imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+#include <random>
+
+namespace test
+{
+	TestSpriteKernels::TestSpriteKernels()
+        :m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)), m_SpriteCount(100000),
+        m_Kernel((int)SpriteKernels::GetKernel()), m_UseKernels(true), m_Animate(true), m_SubmitTime(0.0f)
+	{
+        GLState::SetBlend(true);
+        GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_Renderer = std::make_unique<BatchRenderer2D>();
+        m_Texture[0] = ResourceManager::Get().LoadTexture("res/logo.png");
+        m_Texture[1] = ResourceManager::Get().LoadTexture("res/profile.jpg");
+        GenerateSprites();
+	}
+
+	TestSpriteKernels::~TestSpriteKernels()
+	{
+        // 内核是全局设置, 离开时恢复成最快的
+        SpriteKernels::SetKernel(SpriteKernels::GetBestKernel());
+        ResourceManager::Get().Release(m_Texture[0]);
+        ResourceManager::Get().Release(m_Texture[1]);
+	}
+
+	void TestSpriteKernels::GenerateSprites()
+	{
+        // SpriteBatch 存的是指针; 句柄一直持有, 资源不会被删, 指针在 Test 的生命周期里都有效
+        const Texture* textures[2] = { ResourceManager::Get().GetTexture(m_Texture[0]), ResourceManager::Get().GetTexture(m_Texture[1]) };
+
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        m_Sprites.Clear();
+        m_Sprites.Reserve(m_SpriteCount);
+        m_Spin.resize(m_SpriteCount);
+        for (int i = 0; i < m_SpriteCount; i++)
+        {
+            SpriteDesc sprite;
+            sprite.Position = glm::vec3(unit(random) * 960.0f, unit(random) * 540.0f, 0.0f);
+            sprite.Size = glm::vec2(4.0f + unit(random) * 12.0f);
+            sprite.Rotation = unit(random) * 6.2831853f;
+            sprite.Color = glm::vec4(0.5f + 0.5f * unit(random), 0.5f + 0.5f * unit(random), 0.5f + 0.5f * unit(random), 1.0f);
+            // 三分之一纯色, 其余两张纹理各一半; 按纹理分段排好, 插槽不会来回切
+            int kind = i * 3 / m_SpriteCount;
+            sprite.Tex = kind == 0 ? nullptr : textures[kind - 1];
+            m_Sprites.Add(sprite);
+            m_Spin[i] = (unit(random) - 0.5f) * 4.0f;
+        }
+	}
+
+	void TestSpriteKernels::OnUpdate(float deltaTime)
+	{
+        if (!m_Animate)
+            return;
+        // SoA 的好处之一: 只改旋转这一个数组, 编译器能自动向量化
+        float* rotation = m_Sprites.Rotation.data();
+        const float* spin = m_Spin.data();
+        for (size_t i = 0; i < m_Sprites.Size(); i++)
+            rotation[i] += spin[i] * deltaTime;
+	}
+
+	void TestSpriteKernels::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        SpriteKernels::SetKernel((SpriteKernels::Kernel)m_Kernel);
+
+        auto start = std::chrono::steady_clock::now();
+        m_Renderer->ResetStats();
+        m_Renderer->BeginScene(m_Proj);
+        if (m_UseKernels)
+        {
+            m_Renderer->DrawSprites(m_Sprites);
+        }
+        else
+        {
+            PROFILE_SCOPE("TestSpriteKernels::DrawQuads");
+            for (size_t i = 0; i < m_Sprites.Size(); i++)
+            {
+                // 和内核一样绕中心旋转: 平移到中心, 旋转, 再把单位quad的中心移到原点
+                glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(m_Sprites.X[i], m_Sprites.Y[i], m_Sprites.Z[i]));
+                transform = glm::rotate(transform, m_Sprites.Rotation[i], glm::vec3(0.0f, 0.0f, 1.0f));
+                transform = glm::scale(transform, glm::vec3(m_Sprites.Width[i], m_Sprites.Height[i], 1.0f));
+                transform = glm::translate(transform, glm::vec3(-0.5f, -0.5f, 0.0f));
+                glm::vec4 color(m_Sprites.R[i], m_Sprites.G[i], m_Sprites.B[i], m_Sprites.A[i]);
+                m_Renderer->DrawQuad(transform, color, m_Sprites.Textures[i]);
+            }
+        }
+        m_Renderer->EndScene();
+        float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        m_SubmitTime = m_SubmitTime * 0.9f + ms * 0.1f;
+	}
+
+	void TestSpriteKernels::OnImGuiRender()
+	{
+        ImGui::SliderInt("Sprites", &m_SpriteCount, 1000, 500000, "%d", ImGuiSliderFlags_Logarithmic);
+        if (ImGui::IsItemDeactivatedAfterEdit())
+            GenerateSprites();
+        ImGui::Checkbox("Animate", &m_Animate);
+        ImGui::Checkbox("SoA + SIMD kernels (DrawSprites)", &m_UseKernels);
+
+        // 只列出这台机器支持的内核
+        ImGui::Text("Kernel:");
+        for (int i = 0; i <= (int)SpriteKernels::Kernel::AVX2; i++)
+        {
+            SpriteKernels::Kernel kernel = (SpriteKernels::Kernel)i;
+            if (!SpriteKernels::IsSupported(kernel))
+                continue;
+            ImGui::SameLine();
+            ImGui::RadioButton(SpriteKernels::GetName(kernel), &m_Kernel, i);
+        }
+
+        const BatchRenderer2D::Statistics& stats = m_Renderer->GetStats();
+        ImGui::Text("CPU submit: %.3f ms for %u quads, %u draw calls", m_SubmitTime, stats.QuadCount, stats.DrawCalls);
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
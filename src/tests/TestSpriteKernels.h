@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Test.h"
+
+#include "BatchRenderer2D.h"
+#include "SpriteBatch.h"
+#include "ResourceManager.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	// 大量旋转的 sprite, 对比逐个 DrawQuad(矩阵) 和 SoA + SIMD 内核 (DrawSprites) 生成顶点的CPU时间
+	class TestSpriteKernels : public Test
+	{
+	private:
+		std::unique_ptr<BatchRenderer2D> m_Renderer;
+		TextureHandle m_Texture[2];
+		SpriteBatch m_Sprites;
+		std::vector<float> m_Spin; // 每个 sprite 的角速度
+
+		glm::mat4 m_Proj;
+		int m_SpriteCount;
+		int m_Kernel;     // SpriteKernels::Kernel
+		bool m_UseKernels; // false 时走 DrawQuad(const glm::mat4&, ...)
+		bool m_Animate;
+		float m_SubmitTime; // ms, 平滑过的
+
+	public:
+		TestSpriteKernels();
+		~TestSpriteKernels();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void GenerateSprites();
+	};
+}
@@ -1,6 +1,7 @@
 #include "TestTexture2D.h"
 
 #include "Render.h"
+#include "GLState.h"
 #include "vendor/imgui/imgui.h"
 
 #include "glm/glm.hpp"
@@ -25,8 +26,8 @@ namespace test
             2, 3, 0
         };
 
-        GLCall(glEnable(GL_BLEND));
-        GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+        GLState::SetBlend(true);
+        GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         m_VAO = std::make_unique<VertexArray>();
 
@@ -38,16 +39,27 @@ namespace test
 
         m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 6);
 
-        m_Shader = std::make_unique<Shader>("res/Basic.shader");
-        m_Shader->Bind();
-        m_Shader->SetUniform4f("u_Color", 0.2f, 0.3f, 0.8f, 1.0f);
-        m_Shader->SetUniform1i("u_Texture", 0);
-
-        m_Texture = std::make_unique<Texture>("res/logo.png");
+        // 着色器可能是别的 Test 留在缓存里的, uniform 每次都要重新设置
+        m_Shader = ResourceManager::Get().LoadShader("res/Basic.shader");
+        Shader* shader = ResourceManager::Get().GetShader(m_Shader);
+        shader->Bind();
+        shader->SetUniform4f("u_Color", 0.2f, 0.3f, 0.8f, 1.0f);
+        shader->SetUniform1i("u_Texture", 0);
+        shader->BindUniformBlock("Camera", UniformBuffer::CameraBinding);
+        m_ModelUniform = shader->GetUniformHandle("u_Model");
+
+        m_CameraBuffer = std::make_unique<UniformBuffer>((unsigned int)sizeof(CameraUniforms), UniformBuffer::CameraBinding);
+
+        TextureSpec spec;
+        spec.GenerateMips = true;
+        spec.Anisotropy = 8.0f;
+        m_Texture = ResourceManager::Get().LoadTexture("res/logo.png", spec);
 	}
 
 	TestTexture2D::~TestTexture2D()
 	{
+        ResourceManager::Get().Release(m_Shader);
+        ResourceManager::Get().Release(m_Texture);
 	}
 
 	void TestTexture2D::OnUpdate(float deltaTime)
@@ -60,27 +72,31 @@ namespace test
 		GLCall(glClear(GL_COLOR_BUFFER_BIT));
 
         Renderer renderer;
-        
-        m_Texture->Bind();
+        Shader& shader = *ResourceManager::Get().GetShader(m_Shader);
+
+        ResourceManager::Get().GetTexture(m_Texture)->Bind();
+
+        // view-projection 每帧只上传一次, 每个物体只设置自己的 model 矩阵
+        CameraUniforms camera = { m_Proj * m_View };
+        m_CameraBuffer->SetData(&camera, sizeof(CameraUniforms));
+        m_CameraBuffer->Bind();
 
         {
             glm::mat4 model = glm::translate(glm::mat4(1.0f), m_TranslationA);
-            glm::mat4 mvp = m_Proj * m_View * model;
 
-            m_Shader->Bind();
-            m_Shader->SetUniformMat4f("u_MVP", mvp);
+            shader.Bind();
+            shader.SetUniformMat4f(m_ModelUniform, model);
 
-            renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader);
+            renderer.Draw(*m_VAO, *m_IndexBuffer, shader);
         }
 
         {
             glm::mat4 model = glm::translate(glm::mat4(1.0f), m_TranslationB);
-            glm::mat4 mvp = m_Proj * m_View * model;
 
-            m_Shader->Bind();
-            m_Shader->SetUniformMat4f("u_MVP", mvp);
+            shader.Bind();
+            shader.SetUniformMat4f(m_ModelUniform, model);
 
-            renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader);
+            renderer.Draw(*m_VAO, *m_IndexBuffer, shader);
         }
 	}
 
@@ -88,6 +104,7 @@ namespace test
 	{
         ImGui::SliderFloat3("m_TranslationA", &m_TranslationA.x, 0.0f, 960.0f);
         ImGui::SliderFloat3("m_TranslationB", &m_TranslationB.x, 0.0f, 960.0f);
+        ImGui::Text("State Changes: %u issued, %u skipped", GLState::GetStats().Issued, GLState::GetStats().Skipped);
         ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
 	}
 }
\ No newline at end of file
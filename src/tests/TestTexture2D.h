@@ -4,7 +4,8 @@
 
 #include "VertexBuffer.h"
 #include "VertexBufferLayout.h"
-#include "Texture.h"
+#include "ResourceManager.h"
+#include "UniformBuffer.h"
 
 #include <memory>
 
@@ -18,8 +19,10 @@ namespace test
 		std::unique_ptr<VertexArray> m_VAO;
 		std::unique_ptr<IndexBuffer> m_IndexBuffer;
 		std::unique_ptr<VertexBuffer> m_VertexBuffer;
-		std::unique_ptr<Shader> m_Shader;
-		std::unique_ptr<Texture> m_Texture;
+		ShaderHandle m_Shader;
+		TextureHandle m_Texture;
+		std::unique_ptr<UniformBuffer> m_CameraBuffer;
+		UniformHandle m_ModelUniform;
 
 		glm::mat4 m_Proj, m_View;
 		glm::vec3 m_TranslationA, m_TranslationB;
@@ -0,0 +1,99 @@
+#include "TestTextureAtlas.h"
+
+#include "Render.h"
+#include "GLState.h"
+#include "vendor/imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <string>
+
+namespace test
+{
+	TestTextureAtlas::TestTextureAtlas()
+        :m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f)), m_SpriteCount(2000), m_ShowPage(false)
+	{
+        GLState::SetBlend(true);
+        GLState::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        m_Renderer = std::make_unique<BatchRenderer2D>();
+        m_Atlas = std::make_unique<TextureAtlas>(1024);
+
+        m_Regions.push_back(m_Atlas->Add("res/logo.png"));
+        m_Regions.push_back(m_Atlas->Add("res/profile.jpg"));
+        for (int i = 0; i < 32; i++)
+            AddGeneratedImage();
+	}
+
+	TestTextureAtlas::~TestTextureAtlas()
+	{
+	}
+
+	// 生成一张随机大小的棋盘格图片, 演示增量插入
+	void TestTextureAtlas::AddGeneratedImage()
+	{
+        int index = (int)m_Atlas->GetRegionCount();
+        int width = 16 + (index * 37) % 112;
+        int height = 16 + (index * 53) % 112;
+        std::vector<unsigned char> pixels((size_t)width * height * 4);
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                unsigned char* p = &pixels[((size_t)y * width + x) * 4];
+                bool odd = ((x / 8) + (y / 8)) % 2 == 1;
+                p[0] = (unsigned char)(odd ? 255 : (index * 40) % 256);
+                p[1] = (unsigned char)(odd ? 255 : (index * 90) % 256);
+                p[2] = (unsigned char)(odd ? 255 : (index * 150) % 256);
+                p[3] = 255;
+            }
+        }
+
+        AtlasRegion region = m_Atlas->Add("generated_" + std::to_string(index), width, height, pixels.data());
+        if (region.IsValid())
+            m_Regions.push_back(region);
+	}
+
+	void TestTextureAtlas::OnUpdate(float deltaTime)
+	{
+	}
+
+	void TestTextureAtlas::OnRender()
+	{
+		GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+		GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+        m_Renderer->ResetStats();
+        m_Renderer->BeginScene(m_Proj);
+        if (m_ShowPage)
+        {
+            for (unsigned int i = 0; i < m_Atlas->GetPageCount(); i++)
+                m_Renderer->DrawQuad(glm::vec2(i * 540.0f, 0.0f), glm::vec2(540.0f), m_Atlas->GetPage(i));
+        }
+        else
+        {
+            int columns = 80;
+            float cell = 960.0f / columns;
+            for (int i = 0; i < m_SpriteCount; i++)
+            {
+                const AtlasRegion& region = m_Regions[i % m_Regions.size()];
+                glm::vec2 position((i % columns) * cell, (i / columns) * cell);
+                m_Renderer->DrawQuad(position, glm::vec2(cell * 0.9f), region);
+            }
+        }
+        m_Renderer->EndScene();
+        m_LastStats = m_Renderer->GetStats();
+	}
+
+	void TestTextureAtlas::OnImGuiRender()
+	{
+        ImGui::SliderInt("Sprites", &m_SpriteCount, 1, 3600);
+        ImGui::Checkbox("Show Atlas Pages", &m_ShowPage);
+        if (ImGui::Button("Add Image"))
+            AddGeneratedImage();
+        ImGui::Text("Images: %u  Pages: %u", m_Atlas->GetRegionCount(), m_Atlas->GetPageCount());
+        ImGui::Text("Draw Calls: %u  Quads: %u", m_LastStats.DrawCalls, m_LastStats.QuadCount);
+        ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+	}
+}
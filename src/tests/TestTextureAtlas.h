@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Test.h"
+
+#include "BatchRenderer2D.h"
+#include "TextureAtlas.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+	// 把很多张图打包进图集, 画来自不同图片的 sprite 也只需要一个纹理插槽
+	class TestTextureAtlas : public Test
+	{
+	private:
+		std::unique_ptr<BatchRenderer2D> m_Renderer;
+		std::unique_ptr<TextureAtlas> m_Atlas;
+		std::vector<AtlasRegion> m_Regions;
+
+		glm::mat4 m_Proj;
+		int m_SpriteCount;
+		bool m_ShowPage;
+		BatchRenderer2D::Statistics m_LastStats;
+
+	public:
+		TestTextureAtlas();
+		~TestTextureAtlas();
+
+		void OnUpdate(float deltaTime) override;
+		void OnRender() override;
+		void OnImGuiRender() override;
+
+	private:
+		void AddGeneratedImage();
+	};
+}
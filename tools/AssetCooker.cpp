@@ -0,0 +1,421 @@
+/**
+ * AssetCooker: 离线把 res 目录打包成一个 .pack 资源包 (格式见 src/AssetPackFormat.h)。
+ *      图片:   预先解码 (并上下翻转, 和运行时 stb_image 的设置一致), 按原通道数存储;
+ *              --compress 时压缩成 BC1 (不透明) / BC3 (带透明) 并生成完整的 mipmap 链。
+ *      DDS/KTX: 已经是GPU压缩格式, 原样存入。
+ *      .shader: 预先拆分成顶点/片段两段源码。
+ * 用法: AssetCooker <输入目录> <输出文件> [--compress]
+ *      条目名 = 输入目录 + 相对路径, 比如 "res/logo.png", 和代码里加载时写的路径一致。
+ */
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "AssetPackFormat.h"
+#include "CompressedImage.h"
+#include "vendor/stb_image/stb_image.h"
+
+namespace fs = std::filesystem;
+
+struct CookedAsset
+{
+    AssetPackEntry Entry;
+    std::vector<unsigned char> Data;
+};
+
+static std::string ToLower(std::string s)
+{
+    for (auto& c : s)
+        c = (char)tolower(c);
+    return s;
+}
+
+// ---------------- BC1 / BC3 编码 ----------------
+// 简单的包围盒端点 + 最近调色板索引, 质量不如专业压缩器, 但足够快, 也没有额外依赖
+
+static unsigned short PackRGB565(const unsigned char* c)
+{
+    return (unsigned short)(((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+}
+
+static void UnpackRGB565(unsigned short v, int* c)
+{
+    c[0] = ((v >> 11) & 31) * 255 / 31;
+    c[1] = ((v >> 5) & 63) * 255 / 63;
+    c[2] = (v & 31) * 255 / 31;
+}
+
+// block: 16 个 RGBA 像素, 输出 8 字节
+static void EncodeBC1Color(const unsigned char block[16][4], unsigned char* out)
+{
+    unsigned char minColor[3] = { 255, 255, 255 }, maxColor[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            minColor[c] = std::min(minColor[c], block[i][c]);
+            maxColor[c] = std::max(maxColor[c], block[i][c]);
+        }
+    }
+
+    unsigned short c0 = PackRGB565(maxColor);
+    unsigned short c1 = PackRGB565(minColor);
+    if (c0 < c1)
+        std::swap(c0, c1);
+
+    int palette[4][3];
+    UnpackRGB565(c0, palette[0]);
+    UnpackRGB565(c1, palette[1]);
+    for (int c = 0; c < 3; c++)
+    {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    unsigned int indices = 0;
+    if (c0 != c1) // 相等时全用索引0
+    {
+        for (int i = 0; i < 16; i++)
+        {
+            int best = 0, bestDistance = 1 << 30;
+            for (int p = 0; p < 4; p++)
+            {
+                int dr = block[i][0] - palette[p][0], dg = block[i][1] - palette[p][1], db = block[i][2] - palette[p][2];
+                int distance = dr * dr + dg * dg + db * db;
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+            indices |= (unsigned int)best << (i * 2);
+        }
+    }
+
+    out[0] = (unsigned char)(c0 & 0xff); out[1] = (unsigned char)(c0 >> 8);
+    out[2] = (unsigned char)(c1 & 0xff); out[3] = (unsigned char)(c1 >> 8);
+    memcpy(out + 4, &indices, 4);
+}
+
+// BC3 的 alpha 块, 输出 8 字节
+static void EncodeBC3Alpha(const unsigned char block[16][4], unsigned char* out)
+{
+    unsigned char a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; i++)
+    {
+        a0 = std::max(a0, block[i][3]);
+        a1 = std::min(a1, block[i][3]);
+    }
+
+    // a0 > a1 时是8级插值模式
+    int palette[8] = { a0, a1 };
+    for (int i = 1; i <= 6; i++)
+        palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+
+    unsigned long long indices = 0;
+    if (a0 != a1)
+    {
+        for (int i = 0; i < 16; i++)
+        {
+            int best = 0, bestDistance = 256;
+            for (int p = 0; p < 8; p++)
+            {
+                int distance = std::abs(block[i][3] - palette[p]);
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+            indices |= (unsigned long long)best << (i * 3);
+        }
+    }
+
+    out[0] = a0;
+    out[1] = a1;
+    for (int i = 0; i < 6; i++)
+        out[2 + i] = (unsigned char)((indices >> (i * 8)) & 0xff);
+}
+
+static std::vector<unsigned char> EncodeBC(const unsigned char* rgba, int width, int height, bool withAlpha)
+{
+    int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    std::vector<unsigned char> out((size_t)blocksX * blocksY * (withAlpha ? 16 : 8));
+    unsigned char* dst = out.data();
+
+    for (int by = 0; by < blocksY; by++)
+    {
+        for (int bx = 0; bx < blocksX; bx++)
+        {
+            // 取出 4x4 块, 超出边界的像素重复边缘
+            unsigned char block[16][4];
+            for (int y = 0; y < 4; y++)
+            {
+                for (int x = 0; x < 4; x++)
+                {
+                    int sx = std::min(bx * 4 + x, width - 1), sy = std::min(by * 4 + y, height - 1);
+                    memcpy(block[y * 4 + x], rgba + ((size_t)sy * width + sx) * 4, 4);
+                }
+            }
+
+            if (withAlpha)
+            {
+                EncodeBC3Alpha(block, dst);
+                dst += 8;
+            }
+            EncodeBC1Color(block, dst);
+            dst += 8;
+        }
+    }
+    return out;
+}
+
+// 2x2 盒式滤波缩小一半
+static std::vector<unsigned char> Downsample(const std::vector<unsigned char>& rgba, int width, int height, int& outWidth, int& outHeight)
+{
+    outWidth = std::max(1, width / 2);
+    outHeight = std::max(1, height / 2);
+    std::vector<unsigned char> out((size_t)outWidth * outHeight * 4);
+    for (int y = 0; y < outHeight; y++)
+    {
+        for (int x = 0; x < outWidth; x++)
+        {
+            for (int c = 0; c < 4; c++)
+            {
+                int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+                int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+                int sum = rgba[((size_t)y0 * width + x0) * 4 + c] + rgba[((size_t)y0 * width + x1) * 4 + c]
+                    + rgba[((size_t)y1 * width + x0) * 4 + c] + rgba[((size_t)y1 * width + x1) * 4 + c];
+                out[((size_t)y * outWidth + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+    return out;
+}
+
+// ---------------- 各类资源 ----------------
+
+static bool CookImage(const fs::path& file, bool compress, CookedAsset& asset)
+{
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load(1); // 和 Texture 运行时加载保持一致
+    unsigned char* pixels = stbi_load(file.string().c_str(), &width, &height, &channels, compress ? 4 : 0);
+    if (!pixels)
+    {
+        std::cerr << "  failed to decode: " << stbi_failure_reason() << std::endl;
+        return false;
+    }
+
+    AssetPackEntry& entry = asset.Entry;
+    entry.Type = (uint32_t)AssetType::Texture;
+    entry.Width = (uint32_t)width;
+    entry.Height = (uint32_t)height;
+
+    if (!compress)
+    {
+        entry.Format = 0;
+        entry.Channels = (uint32_t)channels;
+        entry.LevelCount = 1;
+        asset.Data.assign(pixels, pixels + (size_t)width * height * channels);
+        entry.LevelSizes[0] = (uint32_t)asset.Data.size();
+        stbi_image_free(pixels);
+        return true;
+    }
+
+    std::vector<unsigned char> level(pixels, pixels + (size_t)width * height * 4);
+    stbi_image_free(pixels);
+
+    bool withAlpha = false;
+    for (size_t i = 3; i < level.size(); i += 4)
+        withAlpha |= level[i] != 255;
+
+    entry.Format = withAlpha ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    entry.Channels = 4;
+    entry.LevelCount = 0;
+
+    // 压缩纹理运行时没法生成 mipmap, 这里直接生成整条链
+    int w = width, h = height;
+    while (entry.LevelCount < AssetPackMaxLevels)
+    {
+        std::vector<unsigned char> encoded = EncodeBC(level.data(), w, h, withAlpha);
+        entry.LevelSizes[entry.LevelCount++] = (uint32_t)encoded.size();
+        asset.Data.insert(asset.Data.end(), encoded.begin(), encoded.end());
+        if (w == 1 && h == 1)
+            break;
+        int nextW, nextH;
+        level = Downsample(level, w, h, nextW, nextH);
+        w = nextW;
+        h = nextH;
+    }
+    return true;
+}
+
+static bool CookCompressed(const fs::path& file, CookedAsset& asset)
+{
+    CompressedImage image;
+    if (!LoadCompressedImage(file.string(), image))
+        return false;
+    if (image.Levels.size() > AssetPackMaxLevels)
+        image.Levels.resize(AssetPackMaxLevels);
+
+    std::cout << "  note: pre-compressed files are stored as-is, make sure they are already flipped vertically" << std::endl;
+
+    AssetPackEntry& entry = asset.Entry;
+    entry.Type = (uint32_t)AssetType::Texture;
+    entry.Format = image.InternalFormat;
+    entry.Width = (uint32_t)image.Width;
+    entry.Height = (uint32_t)image.Height;
+    entry.LevelCount = (uint32_t)image.Levels.size();
+    for (size_t i = 0; i < image.Levels.size(); i++)
+    {
+        entry.LevelSizes[i] = image.Levels[i].Size;
+        asset.Data.insert(asset.Data.end(), image.Levels[i].Data, image.Levels[i].Data + image.Levels[i].Size);
+    }
+    return true;
+}
+
+// 和 Shader::ParseShader 一样的 "#shader vertex / #shader fragment" 格式
+static bool CookShader(const fs::path& file, CookedAsset& asset)
+{
+    std::ifstream stream(file);
+    if (!stream.is_open())
+        return false;
+
+    std::string line;
+    std::stringstream ss[2];
+    int type = -1;
+    while (getline(stream, line))
+    {
+        if (line.find("#shader") != std::string::npos)
+        {
+            if (line.find("vertex") != std::string::npos)
+                type = 0;
+            else if (line.find("fragment") != std::string::npos)
+                type = 1;
+        }
+        else if (type >= 0)
+        {
+            ss[type] << line << '\n';
+        }
+    }
+
+    std::string vertex = ss[0].str(), fragment = ss[1].str();
+    asset.Entry.Type = (uint32_t)AssetType::Shader;
+    asset.Data.assign(vertex.begin(), vertex.end());
+    asset.Data.push_back('\0');
+    asset.Data.insert(asset.Data.end(), fragment.begin(), fragment.end());
+    asset.Data.push_back('\0');
+    return true;
+}
+
+static void WritePadding(std::ofstream& out, uint64_t& offset)
+{
+    static const char zeros[AssetPackAlignment] = {};
+    uint64_t padding = (AssetPackAlignment - offset % AssetPackAlignment) % AssetPackAlignment;
+    out.write(zeros, (std::streamsize)padding);
+    offset += padding;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "usage: AssetCooker <input dir> <output pack> [--compress]" << std::endl;
+        return 1;
+    }
+
+    fs::path input = fs::path(argv[1]).lexically_normal();
+    fs::path output = argv[2];
+    bool compress = false;
+    for (int i = 3; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--compress") == 0)
+            compress = true;
+    }
+
+    // 按路径排序, 同样的输入总是得到同样的输出
+    std::vector<fs::path> files;
+    for (const auto& item : fs::recursive_directory_iterator(input))
+    {
+        if (item.is_regular_file())
+            files.push_back(item.path());
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<CookedAsset> assets;
+    for (const auto& file : files)
+    {
+        std::string ext = ToLower(file.extension().string());
+        std::string name = (input / fs::relative(file, input)).generic_string();
+        if (name.size() >= AssetPackMaxNameLength)
+        {
+            std::cerr << "skip (name too long): " << name << std::endl;
+            continue;
+        }
+
+        CookedAsset asset;
+        memset(&asset.Entry, 0, sizeof(asset.Entry));
+        strncpy(asset.Entry.Name, name.c_str(), AssetPackMaxNameLength - 1);
+
+        bool ok = false;
+        if (ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".bmp")
+            ok = CookImage(file, compress, asset);
+        else if (ext == ".dds" || ext == ".ktx")
+            ok = CookCompressed(file, asset);
+        else if (ext == ".shader")
+            ok = CookShader(file, asset);
+        else
+            continue; // 不认识的文件不打包
+
+        if (!ok)
+        {
+            std::cerr << "failed: " << name << std::endl;
+            continue;
+        }
+        std::cout << "cooked: " << name << " (" << asset.Data.size() << " bytes)" << std::endl;
+        assets.push_back(std::move(asset));
+    }
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        std::cerr << "cannot write " << output << std::endl;
+        return 1;
+    }
+
+    AssetPackHeader header = {};
+    header.Magic = AssetPackMagic;
+    header.Version = AssetPackVersion;
+    header.EntryCount = (uint32_t)assets.size();
+    out.write((const char*)&header, sizeof(header));
+    uint64_t offset = sizeof(header);
+
+    for (auto& asset : assets)
+    {
+        WritePadding(out, offset);
+        asset.Entry.Offset = offset;
+        asset.Entry.Size = asset.Data.size();
+        out.write((const char*)asset.Data.data(), (std::streamsize)asset.Data.size());
+        offset += asset.Data.size();
+    }
+
+    WritePadding(out, offset);
+    header.EntryTableOffset = offset;
+    for (const auto& asset : assets)
+        out.write((const char*)&asset.Entry, sizeof(AssetPackEntry));
+
+    // 回头补上条目表的位置
+    out.seekp(0);
+    out.write((const char*)&header, sizeof(header));
+
+    std::cout << "wrote " << assets.size() << " assets to " << output.string() << std::endl;
+    return out.good() ? 0 : 1;
+}